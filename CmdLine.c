@@ -13,13 +13,15 @@
 // ###
 
 #include <Uefi.h>
+#include <Library/BaseLib.h>
 #include <Library/UefiLib.h>
 #include <Library/ShellLib.h>
 #include <Library/PrintLib.h>
 #include <Library/DebugLib.h>
 #include <Library/MemoryAllocationLib.h>
-#include <Library/BaseLib/BaseLibInternals.h>
+#include <Library/BaseMemoryLib.h>
 #include <Library/UefiBootServicesTableLib.h>
+#include <Library/TimerLib.h>
 #include "Protocol/EfiShellInterface.h"
 #include "CmdLine.h"
 #include "CmdLineInternal.h"
@@ -28,6 +30,22 @@ extern EFI_SHELL_INTERFACE *mEfiShellInterface;
 
 #define INPUT_BUFF_LEN  32
 
+// packed bitsets, e.g. switch present flags
+#define BITS_PER_WORD           (sizeof(UINTN) * 8)
+#define BITSET_WORDS(Bits)      (((Bits) + BITS_PER_WORD - 1) / BITS_PER_WORD)
+#define BITSET_TEST(Set, Bit)   ((((Set)[(Bit) / BITS_PER_WORD]) >> ((Bit) % BITS_PER_WORD)) & 1)
+#define BITSET_SET(Set, Bit)    ((Set)[(Bit) / BITS_PER_WORD] |= ((UINTN)1 << ((Bit) % BITS_PER_WORD)))
+
+// switch present flags are kept on the stack for tables up to this many words of switches
+#define PRESENT_STACK_WORDS 4
+
+// arena chunk size and allocation alignment
+#define ARENA_CHUNK_SIZE    0x1000
+#define ARENA_ALIGN(Size)   (((Size) + 7) & ~(UINTN)7)
+
+// initial number of items in a value list, doubled each time it fills
+#define LIST_MIN_CAPACITY   4
+
 #define DEBUG_MODE 0
 #if DEBUG_MODE
 #define TRACE(x) Print x
@@ -39,34 +57,298 @@ extern EFI_SHELL_INTERFACE *mEfiShellInterface;
 typedef enum {
     VAL_OK,
     VAL_STR_TRUNCATED,
+    VAL_STR_NOT_ASCII,
+    VAL_NO_MEMORY,
     VAL_DEC_INVALID,
     VAL_HEX_INVALID,
     VAL_INT_INVALID,
     VAL_UINT8_TOO_BIG,
     VAL_UINT16_TOO_BIG,
     VAL_UINT32_TOO_BIG,
+    VAL_UINT64_TOO_BIG,
+    VAL_SINT_INVALID,
+    VAL_INT8_OUT_OF_RANGE,
+    VAL_INT16_OUT_OF_RANGE,
+    VAL_INT32_OUT_OF_RANGE,
+    VAL_INT64_OUT_OF_RANGE,
+    VAL_SIZE_INVALID,
+    VAL_TIME_INVALID,
+    VAL_FREQ_INVALID,
+    VAL_UNIT_INEXACT,
+    VAL_RANGE_INVALID,
+    VAL_RANGE_OUT_OF_BOUNDS,
     VAL_OPT_INVALID,
     VAL_UNSUPPORTED_TYPE,
     VAL_UNSUPPORTED_SIZE,
     VAL_ERROR
 } VALUE_STATUS;
 
+// unit suffix of a size, time or frequency value
+typedef struct {
+    CONST CHAR16    *Suffix;        // suffix, matched ignoring case; NULL ends the table
+    UINTN           Len;            // length of suffix
+    UINT64          Multiplier;     // stored units (bytes, ns or Hz) per suffix unit
+} UNIT_SUFFIX;
+
+#define UNIT(Suffix, Multiplier)    { Suffix, sizeof(Suffix) / sizeof(CHAR16) - 1, Multiplier }
+
+// fraction digits kept by a unit value, further digits must be zero
+#define UNIT_FRAC_MAX_SCALE 1000000000000000000ULL
+
+// slot of a case-folded string hash index, packed so a probe only touches 8 bytes a slot
+typedef struct {
+    UINT32          Hash;       // case-folded hash of string
+    UINT16          Len;        // length of string
+    UINT16          Key;        // key number (index + 1) of string; 0 if slot empty
+} STR_INDEX_SLOT;
+
+// indexed string, only read once a slot has matched on hash and length
+typedef struct {
+    CONST CHAR16    *Str;       // indexed string
+    UINTN           Id;         // table index associated with string
+} STR_INDEX_KEY;
+
+// most strings a string index can hold
+#define STR_INDEX_MAX_KEYS  0xFFFF
+
+// case-folded string hash index (open addressing, linear probing)
+typedef struct {
+    UINTN           Mask;       // number of slots - 1
+    STR_INDEX_SLOT  *Slots;     // slot array
+    STR_INDEX_KEY   *Keys;      // strings in the order added
+    UINTN           KeyCount;   // number of strings added
+} STR_INDEX;
+
+// enum index; strings are found through a hash index and values through a dense table,
+// or if the values are spread out, a table sorted by value
+struct _CMDLINE_ENUM_INDEX {
+    ENUM_STR_ARRAY  *EnumStrArray;  // indexed enum to string array
+    UINTN           Count;          // number of entries in array
+    STR_INDEX       StrIndex;       // hash index of strings, id is array index
+    UINTN           MinValue;       // lowest enum value
+    UINTN           DenseSize;      // number of entries in dense table; 0 if sorted table used
+    UINTN           *ByValue;       // dense: array index + 1 (0 if none) at [Value - MinValue]
+                                    // sorted: array indices in value order
+};
+
+// bitmap words ReturnBitmapValue() builds on the stack, larger bitmaps are allocated
+#define BITMAP_LOCAL_WORDS  8
+
+// smallest enum array given an index by CmdLineCompile(), smaller arrays are scanned
+#define ENUM_INDEX_MIN_ENTRIES  8
+
+// enum value and its array index, sorted by CmdLineEnumIndexCreate() for the sorted value table
+typedef struct {
+    UINTN   Value;  // enum value
+    UINTN   Index;  // index of entry in enum array
+} ENUM_VALUE_PAIR;
+
+// CHAR16 lanes of a UINT64, used to case fold four chars at a time
+#define LANES_LOW   0x0001000100010001ULL   // 1 in each lane
+#define LANES_HIGH  0x8000800080008000ULL   // top bit of each lane
+#define LANES_NOT_ASCII 0xFF80FF80FF80FF80ULL   // bits set in any lane above 0x7F
+
+// char i of a CHAR16 or, if narrow, UTF-8 argument; bytes are not decoded, which is enough where only
+// ASCII chars are valid as every byte of a multi-byte UTF-8 char is above 0x7F
+#define ARG_CHAR(Arg, Narrow, i)    ((Narrow) ? (CHAR16)((CONST UINT8 *)(Arg))[i] : ((CONST CHAR16 *)(Arg))[i])
+#define ARG_PTR(Arg, Narrow, i)     ((CONST VOID *)((CONST UINT8 *)(Arg) + (i) * ((Narrow) ? sizeof(CHAR8) : sizeof(CHAR16))))
+
+// most entries an enum array is checked for, so a missing end entry is found
+#define ENUM_MAX_ENTRIES    0x10000
+
+// marks left in the unused data of a table's end entry once CmdLineValidateTables() has passed it,
+// so tables given to ParseCmdLine() on every call are only checked the first time
+#define TABLE_VALIDATED         ((UINTN)0x7AB1E0C4)
+#define TABLE_VALIDATED_NO_HELP ((UINTN)0x7AB1E0C5)   // switch table, checked with NO_HELP
+
+// switch ids of the built-in switches and lookup results
+#define SWID_BREAK      ((UINTN)-1)
+#define SWID_HELP       ((UINTN)-2)
+#define SWID_NONE       ((UINTN)-3)
+#define SWID_AMBIGUOUS  ((UINTN)-4)
+
+// switch table entry is a switch, rather than a constraint or the end of the table
+#define IS_SWITCH(Entry)    (((Entry).SwitchNecessity != NO_SW) && ((Entry).SwitchNecessity < REQUIRES_SW))
+
+// node of the switch name trie used for prefix matching, children are held as a sibling list
+typedef struct {
+    CHAR16          Char;       // case-folded char leading to this node
+    UINT32          Child;      // index of first child; 0 if none
+    UINT32          Sibling;    // index of next sibling; 0 if none
+    UINTN           Id;         // id of the switch below this node; SWID_AMBIGUOUS if more than one
+    CONST CHAR16    *Str;       // first switch name added below this node
+    CONST CHAR16    *Term;      // switch name ending at this node; NULL if none
+    UINTN           TermId;     // id of the switch name ending at this node
+} TRIE_NODE;
+
+// arena chunk, allocations follow the header
+typedef struct _ARENA_CHUNK {
+    struct _ARENA_CHUNK *Next;  // previous chunk
+    UINTN           Size;       // bytes available for allocations
+    UINTN           Used;       // bytes allocated
+} ARENA_CHUNK;
+
+#define CHUNK_DATA(Chunk)   ((UINT8 *)(Chunk) + ARENA_ALIGN(sizeof(ARENA_CHUNK)))
+
+// bump allocator for list values, released in one go by CmdLineFree()
+typedef struct {
+    ARENA_CHUNK     *Chunk;     // current chunk; NULL if none
+    VOID            *Last;      // most recent allocation, which may grow in place
+} ARENA;
+
+// argument error found during the cmd line scan
+typedef enum {
+    ARGERR_NONE,
+    ARGERR_UNRECOGNISED,
+    ARGERR_AMBIGUOUS,
+    ARGERR_DUPLICATE,
+    ARGERR_NO_VALUE,
+    ARGERR_VALUE,
+    ARGERR_TOO_MANY
+} ARG_ERROR_TYPE;
+
+// details of the first argument error; reported once the scan has checked for help and break
+typedef struct {
+    ARG_ERROR_TYPE  Error;      // type of error
+    VALUE_STATUS    ValStatus;  // value status if ARGERR_VALUE
+    CONST CHAR16    *Str;       // switch string in error; NULL if unrecognised or ambiguous
+    UINTN           Num;        // parameter position, or parameter count if ARGERR_TOO_MANY
+    CONST VOID      *Arg;       // unrecognised or ambiguous switch, or value if ARGERR_VALUE
+    BOOLEAN         Narrow;     // TRUE if Arg is a UTF-8 argument
+} ARG_ERROR;
+
+// arguments after '--', borrowed from the argument vector parsed or, if UTF-8, converted copies
+typedef struct {
+    BOOLEAN         Found;      // '--' entered
+    UINTN           Argc;       // number of arguments after '--'
+    CHAR16          **Argv;     // ptr to first argument after '--'
+} PASS_ARGS;
+
+// switch fields read by the parse once a name has matched, packed apart from the switch table;
+// names are matched through the index slots (hashes and lengths) and keys, and the table
+// itself (names, necessity, presence ptr and help) is only read by help and error reports
+typedef struct {
+    VALUE_TYPE          ValueType;  // type of value
+    DATA                Data;       // value data
+    VALUE_RET_PTR       ValueRetPtr; // ptr (or config field offset) to store value
+    CMDLINE_ENUM_INDEX  *EnumIndex; // enum index; NULL if none
+} SWITCH_HOT;
+
+// compiled parser; tables are walked once by CmdLineCompile() and then parsed many times
+struct _CMDLINE_PARSER {
+    PARAMETER_TABLE *ParamTable;    // ptr to parameter table; may be NULL
+    UINTN           ParamCount;     // number of entries in parameter table
+    BOOLEAN         ParamRest;      // last parameter is a list taking all remaining parameters
+    BOOLEAN         HasLists;       // tables have list parameters or switches
+    ARENA           Arena;          // list values
+    UINTN           ManParamCount;  // number of mandatory parameters
+    SWITCH_TABLE    *SwTable;       // ptr to switch table; may be NULL
+    UINTN           SwCount;        // number of entries in switch table
+    STR_INDEX       SwIndex;        // hash index of switch names
+    TRIE_NODE       *SwTrie;        // trie of switch names if SW_PREFIX; replaces the hash index
+    CMDLINE_ENUM_INDEX **ParamEnumIndex; // enum index of each parameter; NULL if none
+    SWITCH_HOT      *SwHot;         // value fields of each switch
+    UINTN           *SwPresentIds;  // switches with a presence flag, then list switches
+    UINTN           SwPresentCount; // number of switches with a presence flag
+    UINTN           SwListCount;    // number of list switches
+    UINTN           SwWords;        // number of words in a switch bitset
+    UINTN           *ManSwMask;     // bitset of mandatory switches
+    UINTN           ConstraintCount; // number of constraint entries following the switches
+    UINTN           *ConstraintMask; // trigger and listed switch bitsets of each constraint
+    CHAR16          *ProgHelpStr;   // ptr to help string for program
+    UINT16          FuncOpt;        // functional options
+    CONST CHAR16    **SwValStr;     // LAZY_VALUES: value string of each switch; NULL if not entered
+    UINTN           *SwConverted;   // LAZY_VALUES: bitset of switch values converted by an accessor
+    VALUE_STATUS    *SwValStatus;   // LAZY_VALUES: status of each converted switch value
+    VOID            *Config;        // config struct of last parse; NULL if return ptrs are absolute
+    CONST CHAR16    *ProgName;      // program name of last parse, for accessor errors; NULL until needed if UTF-8
+    CONST CHAR8     *ProgPath;      // UTF-8 program path of last parse, widened into ProgName when needed
+    CONST CHAR16    *CmdName;       // name used in place of the program name (e.g. 'prog subcmd'); NULL if none
+    PASS_ARGS       PassArgs;       // PASS_THROUGH: arguments after '--' of last parse
+};
+
+// compiled subcommand table
+struct _CMDLINE_SUBCMDS {
+    SUBCMD_TABLE    *SubCmdTable;   // ptr to subcommand table
+    UINTN           SubCmdCount;    // number of entries in subcommand table
+    STR_INDEX       NameIndex;      // hash index of subcommand names
+    CHAR16          *ProgHelpStr;   // ptr to help string for program
+    UINT16          FuncOpt;        // functional options
+};
+
 
 // locals functions
-STATIC VOID ValueError(IN VALUE_STATUS ValStatus, IN CONST CHAR16* SwStr, IN UINTN ParamNum, IN CONST CHAR16* ValString);
-STATIC VALUE_STATUS ReturnValue(IN CONST CHAR16 *String, IN VALUE_TYPE ValueType, IN DATA *Data, OUT VALUE_RET_PTR ValueRetPtr);
-STATIC VALUE_STATUS ProcessIntVal(IN UINTN Value, IN VALUE_SIZE ValSize, OUT VALUE_RET_PTR ValueRetPtr);
-STATIC BOOLEAN GetEnumVal(IN ENUM_STR_ARRAY *EnumStrArray, IN CONST CHAR16 *Str, OUT UINTN *Value);
+STATIC SHELL_STATUS ParseArgs(IN CMDLINE_PARSER *Parser, IN UINTN Argc, IN VOID **Argv, IN BOOLEAN Narrow, OUT VOID *Config, OUT UINTN *NumParams);
+STATIC CONST CHAR16* GetProgName(IN CMDLINE_PARSER *Parser);
+STATIC VOID* BindPtr(IN VOID *Ptr, IN VOID *Config);
+STATIC VALUE_STATUS StoreArgValue(IN CMDLINE_PARSER *Parser, IN CONST VOID *String, IN BOOLEAN Narrow, IN VALUE_TYPE ValueType, IN DATA *Data, IN CONST CMDLINE_ENUM_INDEX *EnumIndex, IN VALUE_RET_PTR ValueRetPtr, IN VOID *Config);
+STATIC VOID ValueError(IN CONST CHAR16 *ProgName, IN VALUE_STATUS ValStatus, IN CONST CHAR16* SwStr, IN UINTN ParamNum, IN CONST CHAR16* ValString);
+STATIC VOID SetArgError(OUT ARG_ERROR *ArgError, IN ARG_ERROR_TYPE Error, IN VALUE_STATUS ValStatus, IN CONST CHAR16 *Str, IN UINTN Num, IN CONST VOID *Arg);
+STATIC VOID ReportArgError(IN CONST CHAR16 *ProgName, IN CMDLINE_PARSER *Parser, IN CONST ARG_ERROR *ArgError);
+STATIC BOOLEAN CheckConstraint(IN CONST CHAR16 *ProgName, IN CONST CMDLINE_PARSER *Parser, IN UINTN Constraint, IN CONST UINTN *SwPresent);
+STATIC VALUE_STATUS ReturnValue(IN CONST VOID *String, IN BOOLEAN Narrow, IN VALUE_TYPE ValueType, IN DATA *Data, IN CONST CMDLINE_ENUM_INDEX *EnumIndex OPTIONAL, OUT VALUE_RET_PTR ValueRetPtr);
+STATIC VALUE_STATUS ReturnListValue(IN ARENA *Arena, IN CONST VOID *String, IN BOOLEAN Narrow, IN VALUE_TYPE ValueType, OUT VALUE_RET_PTR ValueRetPtr);
+STATIC BOOLEAN IsListType(IN VALUE_TYPE ValueType);
+STATIC VALUE_STATUS ReturnBitmapValue(IN CONST VOID *String, IN BOOLEAN Narrow, IN UINTN BitCount, OUT UINTN *Bitmap);
+STATIC VALUE_STATUS ReturnEnumSetValue(IN CONST VOID *String, IN BOOLEAN Narrow, IN ENUM_STR_ARRAY *EnumStrArray, IN CONST CMDLINE_ENUM_INDEX *EnumIndex OPTIONAL, OUT UINT64 *Set);
+STATIC VALUE_STATUS ReturnRangeValue(IN ARENA *Arena, IN CONST VOID *String, IN BOOLEAN Narrow, OUT CMDLINE_RANGE_LIST *RangeList);
+STATIC VALUE_STATUS ParseRangeItem(IN CONST VOID *String, IN BOOLEAN Narrow, IN OUT UINTN *Pos, OUT CMDLINE_RANGE *Range);
+STATIC VALUE_STATUS ParseRangeNumber(IN CONST VOID *String, IN BOOLEAN Narrow, IN OUT UINTN *Pos, OUT UINT64 *Value);
+STATIC INTN EFIAPI CompareRange(IN CONST VOID *Buffer1, IN CONST VOID *Buffer2);
+STATIC SHELL_STATUS LookupLazySwitch(IN CMDLINE_PARSER *Parser, IN CONST CHAR16 *Name, OUT UINTN *Id);
+STATIC SHELL_STATUS ConvertLazyValue(IN CMDLINE_PARSER *Parser, IN UINTN Id);
+STATIC VOID TokenizeError(IN SHELL_STATUS ShellStatus, IN CONST CHAR16 *CmdName, IN UINTN Argc, IN CHAR16 **Argv, IN UINTN MaxArgs);
+STATIC CHAR16** WidenArgv(IN ARENA *Arena, IN UINTN Argc, IN CHAR8 **Argv);
+STATIC CHAR16 DecodeUtf8Char(IN OUT CONST CHAR8 **String);
+STATIC CHAR16* WidenArg(IN ARENA *Arena, IN CONST CHAR8 *Arg);
+STATIC CHAR16 ReadArgChar(IN OUT CONST VOID **Arg, IN BOOLEAN Narrow);
+STATIC UINTN ArgStrLen(IN CONST VOID *Arg, IN BOOLEAN Narrow, IN CHAR16 Stop, OUT CONST VOID **End OPTIONAL);
+STATIC EFI_STATUS DecodeUtf8Str(IN CONST CHAR8 *Source, OUT CHAR16 *Dest, IN UINTN DestSize);
+STATIC EFI_STATUS CopyAsciiStr(IN CONST CHAR8 *Source, OUT CHAR8 *Dest, IN UINTN DestSize);
+STATIC VOID* ArenaAlloc(IN OUT ARENA *Arena, IN UINTN Size);
+STATIC VOID* ArenaGrow(IN OUT ARENA *Arena, IN VOID *Ptr, IN UINTN OldSize, IN UINTN NewSize);
+STATIC VOID ArenaMove(IN OUT ARENA *Dest, IN OUT ARENA *Src);
+STATIC VOID ArenaFree(IN OUT ARENA *Arena);
+STATIC VALUE_STATUS ParseInteger(IN CONST VOID *String, IN BOOLEAN Narrow, IN VALUE_TYPE ValueType, IN VALUE_SIZE ValSize, OUT UINT64 *Value);
+STATIC VALUE_STATUS ProcessIntVal(IN UINT64 Value, IN VALUE_SIZE ValSize, OUT VALUE_RET_PTR ValueRetPtr);
+STATIC VALUE_STATUS ParseUnitValue(IN CONST VOID *String, IN BOOLEAN Narrow, IN VALUE_TYPE ValueType, IN VALUE_SIZE ValSize, OUT UINT64 *Value);
+STATIC BOOLEAN IsNegativeNumber(IN CONST VOID *String, IN BOOLEAN Narrow);
+STATIC EFI_STATUS IntegerTypeInput(OUT UINTN *Value, IN CONST CHAR16 *PromptStr, IN VALUE_TYPE ValueType, IN CONST CHAR16 *TypeStr);
+STATIC BOOLEAN GetEnumVal(IN ENUM_STR_ARRAY *EnumStrArray, IN CONST VOID *Str, IN BOOLEAN Narrow, OUT UINTN *Value);
+STATIC SHELL_STATUS CompileEnumIndex(IN VALUE_TYPE ValueType, IN DATA *Data, OUT CMDLINE_ENUM_INDEX **EnumIndex);
+STATIC BOOLEAN FindEnumIndex(IN CONST CMDLINE_ENUM_INDEX *EnumIndex, IN CONST VOID *Str, IN BOOLEAN Narrow, OUT UINTN *Value OPTIONAL);
+STATIC INTN EFIAPI CompareEnumValue(IN CONST VOID *Buffer1, IN CONST VOID *Buffer2);
 STATIC INTN EFIAPI StriCmp(IN CONST CHAR16 *FirstString, IN CONST CHAR16 *SecondString);
-STATIC BOOLEAN HasHexPrefix(IN CONST CHAR16 *String);
-STATIC BOOLEAN IsHexString(IN CONST CHAR16 *String);
-STATIC BOOLEAN IsDecimalString(IN CONST CHAR16 *String);
+STATIC UINT64 FoldChar16x4(IN UINT64 Chars);
+STATIC BOOLEAN StrniEqual(IN CONST CHAR16 *FirstString, IN CONST CHAR16 *SecondString, IN UINTN Len);
+STATIC BOOLEAN ArgStrniEqual(IN CONST CHAR16 *String, IN CONST VOID *Arg, IN BOOLEAN Narrow, IN UINTN Len);
+STATIC UINT32 HashFoldStr(IN CONST VOID *String, IN BOOLEAN Narrow, IN CHAR16 Stop, OUT UINTN *Len);
+STATIC EFI_STATUS StrIndexInit(OUT STR_INDEX *Index, IN UINTN Count);
+STATIC VOID StrIndexFree(IN STR_INDEX *Index);
+STATIC BOOLEAN StrIndexAdd(IN STR_INDEX *Index, IN CONST CHAR16 *Str, IN UINTN Id);
+STATIC CONST STR_INDEX_KEY* StrIndexFind(IN CONST STR_INDEX *Index, IN CONST VOID *Str, IN BOOLEAN Narrow, IN CHAR16 Stop);
+STATIC EFI_STATUS BuildSwitchIndex(IN SWITCH_TABLE *SwTable, IN UINTN SwCount, IN UINT16 FuncOpt, OUT STR_INDEX *Index);
+STATIC BOOLEAN ResolveSwitchList(IN SWITCH_TABLE *SwTable, IN UINTN SwCount, IN CONST CHAR16 *List, OUT UINTN *Mask OPTIONAL);
+STATIC EFI_STATUS BuildSwitchTrie(IN SWITCH_TABLE *SwTable, IN UINTN SwCount, IN UINT16 FuncOpt, OUT TRIE_NODE **Trie);
+STATIC VOID TrieAdd(IN OUT TRIE_NODE *Trie, IN OUT UINTN *NodeCount, IN CONST CHAR16 *Str, IN UINTN Id);
+STATIC UINTN TrieWalk(IN CONST TRIE_NODE *Trie, IN CONST VOID *Str, IN BOOLEAN Narrow);
+STATIC VOID PrintTrieNames(IN CONST TRIE_NODE *Trie, IN UINTN Node);
+STATIC UINTN LookupSwitch(IN CONST CMDLINE_PARSER *Parser, IN CONST VOID *Arg, IN BOOLEAN Narrow, OUT CONST CHAR16 **SwStr);
+STATIC EFI_STATUS GetShellArgs(OUT UINTN *Argc, OUT CHAR16 ***Argv);
 STATIC CONST CHAR16* GetFileName(CONST CHAR16* PathName);
-STATIC VOID TableError(IN UINTN i, IN CHAR16 *errStr);
+STATIC UINTN BuildCommandLine(IN UINTN Argc, IN CHAR16 **Argv, OUT CHAR16 *CmdLine OPTIONAL);
+STATIC UINT64 CounterTicks(IN UINT64 Start, IN UINT64 End);
+STATIC VOID TableError(IN CONST CHAR16 *Table, IN UINTN i, IN CONST CHAR16 *errStr);
+STATIC SHELL_STATUS ValidateSwitchTable(IN SWITCH_TABLE *SwTable, IN UINTN SwCount, IN UINT16 FuncOpt);
+STATIC CONST CHAR16* CheckTableData(IN VALUE_TYPE ValueType, IN DATA *Data);
+STATIC CONST CHAR16* CheckEnumArray(IN ENUM_STR_ARRAY *EnumStrArray, IN BOOLEAN IsSet);
 STATIC BOOLEAN ArgNameDefined(IN CHAR16 *HelpStr);
 STATIC UINTN GetArgName(IN CHAR16 *HelpStr, OUT CHAR16* ArgName, IN UINTN ArgNameSize, IN BOOLEAN Mandatory, IN CONST CHAR16 *DefaultArgName);
-STATIC VOID ShowHelp(IN UINTN ManParamCount, IN PARAMETER_TABLE *ParamTable, IN SWITCH_TABLE *SwTable, IN CONST CHAR16 *ProgHelpStr, IN UINTN FuncOpt);
+STATIC VOID ShowHelp(IN CONST CHAR16 *ProgName, IN UINTN ManParamCount, IN PARAMETER_TABLE *ParamTable, IN SWITCH_TABLE *SwTable, IN CONST CHAR16 *ProgHelpStr, IN UINTN FuncOpt);
 STATIC VOID PrintSwitchHelp(IN SWITCH_TABLE *SwTableEntry);
+STATIC VOID PrintConstraintHelp(IN SWITCH_TABLE *SwTableEntry);
+STATIC VOID ShowSubCmdHelp(IN CONST CHAR16 *ProgName, IN CONST CMDLINE_SUBCMDS *SubCmds);
+STATIC BOOLEAN IsBuiltInSwitch(IN CONST CHAR16 *Arg, IN CONST CHAR16 *SwStr1, IN CONST CHAR16 *SwStr2);
 
 
 // globals
@@ -81,6 +363,33 @@ STATIC CONST CHAR16* CONST g_DefaultArgName = L"arg";
 
 STATIC CONST CHAR16 *g_ProgName = NULL;
 
+// unit suffixes, sizes are binary multiples
+STATIC CONST UNIT_SUFFIX g_SizeUnits[] = {
+    UNIT(L"",    1),           UNIT(L"B",   1),
+    UNIT(L"K",   1ULL << 10),  UNIT(L"KB",  1ULL << 10),  UNIT(L"KiB", 1ULL << 10),
+    UNIT(L"M",   1ULL << 20),  UNIT(L"MB",  1ULL << 20),  UNIT(L"MiB", 1ULL << 20),
+    UNIT(L"G",   1ULL << 30),  UNIT(L"GB",  1ULL << 30),  UNIT(L"GiB", 1ULL << 30),
+    UNIT(L"T",   1ULL << 40),  UNIT(L"TB",  1ULL << 40),  UNIT(L"TiB", 1ULL << 40),
+    UNIT(L"P",   1ULL << 50),  UNIT(L"PB",  1ULL << 50),  UNIT(L"PiB", 1ULL << 50),
+    UNIT(L"E",   1ULL << 60),  UNIT(L"EB",  1ULL << 60),  UNIT(L"EiB", 1ULL << 60),
+    { NULL, 0, 0 }
+};
+STATIC CONST UNIT_SUFFIX g_TimeUnits[] = {
+    UNIT(L"",    1),           UNIT(L"ns",  1),           UNIT(L"us",  1000),
+    UNIT(L"ms",  1000000),     UNIT(L"s",   1000000000),
+    { NULL, 0, 0 }
+};
+STATIC CONST UNIT_SUFFIX g_FreqUnits[] = {
+    UNIT(L"",    1),           UNIT(L"Hz",  1),
+    UNIT(L"K",   1000),        UNIT(L"kHz", 1000),
+    UNIT(L"M",   1000000),     UNIT(L"MHz", 1000000),
+    UNIT(L"G",   1000000000),  UNIT(L"GHz", 1000000000),
+    { NULL, 0, 0 }
+};
+
+// list values from ParseCmdLine() and ParseArgv()
+STATIC ARENA g_Arena = { NULL, NULL };
+
 
 /**
  * SetProgName()
@@ -106,37 +415,204 @@ SHELL_STATUS ParseCmdLine(
   OUT UINTN          *NumParams OPTIONAL
   )
 {
-    SHELL_STATUS ShellStatus = SHELL_INVALID_PARAMETER;
+    UINTN Argc;
+    CHAR16 **Argv;
 
     // reset number of actual parameters 
     if (NumParams) {
         *NumParams = 0;
     }
 
-    // initialise switch present flags
-    BOOLEAN SwPresent[MAX_SWITCH_ENTRIES] = { 0 };
+    if (EFI_ERROR(GetShellArgs(&Argc, &Argv))) {
+        return SHELL_UNSUPPORTED;
+    }
+    return ParseArgv(Argc, Argv, ParamTable, ManParamCount, SwTable, ProgHelpStr, FuncOpt, NumParams);
+}
 
-    // get cmd line arguments
-    UINTN Argc;
-    CHAR16** Argv;
-    if (gEfiShellParametersProtocol != NULL) {  // Check for UEFI Shell 2.0 protocols
-        Argc = gEfiShellParametersProtocol->Argc;
-        Argv = gEfiShellParametersProtocol->Argv;
-    } else if  (mEfiShellInterface != NULL) {
-        Argc = mEfiShellInterface->Argc;
-        Argv = mEfiShellInterface->Argv;
-    } else {
-        ShellStatus = SHELL_UNSUPPORTED;
-        goto Error_exit;
+/**
+ * ParseArgv()
+ * 
+ **/
+SHELL_STATUS ParseArgv(
+  IN UINTN           Argc,
+  IN CHAR16          **Argv,
+  IN PARAMETER_TABLE *ParamTable OPTIONAL,
+  IN UINTN           ManParamCount,
+  IN SWITCH_TABLE    *SwTable OPTIONAL,
+  IN CHAR16          *ProgHelpStr OPTIONAL,
+  IN UINT16          FuncOpt,
+  OUT UINTN          *NumParams OPTIONAL
+  )
+{
+    CMDLINE_PARSER *Parser;
+
+    // reset number of actual parameters 
+    if (NumParams) {
+        *NumParams = 0;
     }
-    #if DEBUG_MODE
-    {
-        Print(L"Argc = %u\n", Argc);
-        for (UINTN i = 0; i < Argc; i++) {
-            Print(L"Argv[%u] = '%s'\n", i, Argv[i]);
+
+    // the arguments after '--' are held by the parser, which is freed here
+    if (FuncOpt & PASS_THROUGH) {
+        TableError(L"FuncOpt", 0, L"PASS_THROUGH needs a parser from CmdLineCompile()");
+        return SHELL_INVALID_PARAMETER;
+    }
+
+    // values must be converted before the parser is freed
+    SHELL_STATUS ShellStatus = CmdLineCompile(ParamTable, ManParamCount, SwTable, ProgHelpStr, FuncOpt & ~LAZY_VALUES, &Parser);
+    if (ShellStatus != SHELL_SUCCESS) {
+        return ShellStatus;
+    }
+    ShellStatus = CmdLineParseArgv(Parser, Argc, Argv, NumParams);
+    ArenaMove(&g_Arena, &Parser->Arena);
+    CmdLineFreeParser(Parser);
+
+    return ShellStatus;
+}
+
+/**
+ * CmdLineValidateTables()
+ * 
+ **/
+SHELL_STATUS CmdLineValidateTables(
+  IN PARAMETER_TABLE *ParamTable OPTIONAL,
+  IN UINTN           ManParamCount,
+  IN SWITCH_TABLE    *SwTable OPTIONAL,
+  IN UINT16          FuncOpt
+  )
+{
+    SHELL_STATUS ShellStatus = SHELL_SUCCESS;
+    CONST CHAR16 *ErrStr;
+
+    // parameters, every entry is checked so all errors are reported
+    UINTN ParamCount = 0;
+    if (ParamTable) {
+        while (ParamTable[ParamCount].ValueType != VALTYPE_NONE) {
+            ParamCount++;
         }
     }
-    #endif
+    if (ManParamCount > ParamCount) {
+        TableError(L"Parameter", ParamCount, L"'ManParamCount' too large, all parameters required");
+    }
+    if (ParamTable && (ParamTable[ParamCount].Data.FlagValue != TABLE_VALIDATED)) {
+        for (UINTN i = 0; i < ParamCount; i++) {
+            if (i && IsListType(ParamTable[i - 1].ValueType)) {
+                TableError(L"Parameter", i - 1, L"List not last");
+                ShellStatus = SHELL_INVALID_PARAMETER;
+            }
+            if (ParamTable[i].ValueRetPtr.pVoid == NULL) {
+                TableError(L"Parameter", i, L"Null 'RetValPtr'");
+                ShellStatus = SHELL_INVALID_PARAMETER;
+            }
+            ErrStr = CheckTableData(ParamTable[i].ValueType, &ParamTable[i].Data);
+            if (ErrStr) {
+                TableError(L"Parameter", i, ErrStr);
+                ShellStatus = SHELL_INVALID_PARAMETER;
+            }
+        }
+        if (ShellStatus == SHELL_SUCCESS) {
+            ParamTable[ParamCount].Data.FlagValue = TABLE_VALIDATED;
+        }
+    }
+
+    // switches, then the constraints that follow them
+    if (!SwTable) {
+        return ShellStatus;
+    }
+    UINTN SwCount = 0;
+    while (IS_SWITCH(SwTable[SwCount])) {
+        SwCount++;
+    }
+    UINTN EndEntry = SwCount;
+    while (SwTable[EndEntry].SwitchNecessity != NO_SW) {
+        EndEntry++;
+    }
+    // a table checked with NO_HELP is checked again for a clash with the help switches
+    UINTN Mark = SwTable[EndEntry].Data.FlagValue;
+    if ((Mark == TABLE_VALIDATED) || ((FuncOpt & NO_HELP) && (Mark == TABLE_VALIDATED_NO_HELP))) {
+        return ShellStatus;
+    }
+    SHELL_STATUS SwStatus = ValidateSwitchTable(SwTable, SwCount, FuncOpt);
+    if (SwStatus == SHELL_SUCCESS) {
+        SwTable[EndEntry].Data.FlagValue = (FuncOpt & NO_HELP) ? TABLE_VALIDATED_NO_HELP : TABLE_VALIDATED;
+    }
+
+    return (ShellStatus != SHELL_SUCCESS) ? ShellStatus : SwStatus;
+}
+
+/**
+ * ParseArgvAscii()
+ * 
+ **/
+SHELL_STATUS ParseArgvAscii(
+  IN UINTN           Argc,
+  IN CHAR8           **Argv,
+  IN PARAMETER_TABLE *ParamTable OPTIONAL,
+  IN UINTN           ManParamCount,
+  IN SWITCH_TABLE    *SwTable OPTIONAL,
+  IN CHAR16          *ProgHelpStr OPTIONAL,
+  IN UINT16          FuncOpt,
+  OUT UINTN          *NumParams OPTIONAL
+  )
+{
+    CMDLINE_PARSER *Parser;
+
+    // reset number of actual parameters 
+    if (NumParams) {
+        *NumParams = 0;
+    }
+
+    // the arguments after '--' are held by the parser, which is freed here
+    if (FuncOpt & PASS_THROUGH) {
+        TableError(L"FuncOpt", 0, L"PASS_THROUGH needs a parser from CmdLineCompile()");
+        return SHELL_INVALID_PARAMETER;
+    }
+
+    SHELL_STATUS ShellStatus = CmdLineCompile(ParamTable, ManParamCount, SwTable, ProgHelpStr, FuncOpt & ~LAZY_VALUES, &Parser);
+    if (ShellStatus != SHELL_SUCCESS) {
+        return ShellStatus;
+    }
+    ShellStatus = CmdLineParseArgvAscii(Parser, Argc, Argv, NumParams);
+    ArenaMove(&g_Arena, &Parser->Arena);
+    CmdLineFreeParser(Parser);
+
+    return ShellStatus;
+}
+
+/**
+ * CmdLineCompile()
+ * 
+ **/
+SHELL_STATUS CmdLineCompile(
+  IN PARAMETER_TABLE *ParamTable OPTIONAL,
+  IN UINTN           ManParamCount,
+  IN SWITCH_TABLE    *SwTable OPTIONAL,
+  IN CHAR16          *ProgHelpStr OPTIONAL,
+  IN UINT16          FuncOpt,
+  OUT CMDLINE_PARSER **Parser
+  )
+{
+    SHELL_STATUS ShellStatus = SHELL_OUT_OF_RESOURCES;
+
+    if (!Parser) {
+        return SHELL_INVALID_PARAMETER;
+    }
+    *Parser = NULL;
+
+    // tables are checked here once per parser, so parsing does not check entries again
+    ShellStatus = CmdLineValidateTables(ParamTable, ManParamCount, SwTable, FuncOpt);
+    if (ShellStatus != SHELL_SUCCESS) {
+        return ShellStatus;
+    }
+    ShellStatus = SHELL_OUT_OF_RESOURCES;
+
+    CMDLINE_PARSER *NewParser = AllocateZeroPool(sizeof(CMDLINE_PARSER));
+    if (!NewParser) {
+        goto Error_exit;
+    }
+    NewParser->ParamTable = ParamTable;
+    NewParser->SwTable = SwTable;
+    NewParser->ProgHelpStr = ProgHelpStr;
+    NewParser->FuncOpt = FuncOpt;
 
     // determine number of required parameters if any
     UINTN TableParamCount = 0;
@@ -144,454 +620,3449 @@ SHELL_STATUS ParseCmdLine(
         while (ParamTable[TableParamCount].ValueType != VALTYPE_NONE) {
             TableParamCount++;
         }
+        NewParser->ParamRest = TableParamCount && IsListType(ParamTable[TableParamCount - 1].ValueType);
     }
-    // check manatory parameter count
-    if (ManParamCount > TableParamCount) {
-        ManParamCount = TableParamCount;
-    }
-
-    // use cmd line parameter for program name if non specified
-    if (!g_ProgName) {
-        g_ProgName = GetFileName(Argv[0]);
-    }
+    NewParser->ParamCount = TableParamCount;
+    NewParser->HasLists = NewParser->ParamRest;
+    NewParser->ManParamCount = MIN(ManParamCount, TableParamCount);
 
-    // check if break requested, ignoring all other options
-    if (!(FuncOpt & NO_BREAK)) {
-        ShellSetPageBreakMode(FALSE);
-        for (UINTN i = 0; i < Argc; i++) {
-            if (((StriCmp(Argv[i], g_BreakSwStr1) == 0) || (StriCmp(Argv[i], g_BreakSwStr2) == 0))) {
-                ShellSetPageBreakMode(TRUE);
-                break;
-            }
+    // build switch lookup, a trie if abbreviated switches are allowed
+    if (SwTable) {
+        while (IS_SWITCH(SwTable[NewParser->SwCount])) {
+            NewParser->SwCount++;
         }
     }
+    EFI_STATUS Status;
+    if (FuncOpt & SW_PREFIX) {
+        Status = BuildSwitchTrie(SwTable, NewParser->SwCount, FuncOpt, &NewParser->SwTrie);
+    } else {
+        Status = BuildSwitchIndex(SwTable, NewParser->SwCount, FuncOpt, &NewParser->SwIndex);
+    }
+    if (EFI_ERROR(Status)) {
+        goto Error_exit;
+    }
+    NewParser->SwWords = BITSET_WORDS(NewParser->SwCount);
 
-    // check if help requested, ignoring all other options
-    if (!(FuncOpt & NO_HELP)) {
-        for (UINTN i = 0; i < Argc; i++) {
-            if (((StriCmp(Argv[i], g_HelpSwStr1) == 0) || (StriCmp(Argv[i], g_HelpSwStr2) == 0))) {
-                ShowHelp(ManParamCount, ParamTable, SwTable, ProgHelpStr, FuncOpt);
-                ShellStatus = SHELL_ABORTED;
+    // index large enum arrays
+    if (NewParser->ParamCount) {
+        NewParser->ParamEnumIndex = AllocateZeroPool(NewParser->ParamCount * sizeof(CMDLINE_ENUM_INDEX *));
+        if (!NewParser->ParamEnumIndex) {
+            goto Error_exit;
+        }
+        for (UINTN i = 0; i < NewParser->ParamCount; i++) {
+            ShellStatus = CompileEnumIndex(ParamTable[i].ValueType, &ParamTable[i].Data, &NewParser->ParamEnumIndex[i]);
+            if (ShellStatus != SHELL_SUCCESS) {
                 goto Error_exit;
             }
         }
     }
-
-    // parse cmd line arguments
-    UINTN ParamCount = 0;
-    UINTN ArgNum = 1;
-    while (ArgNum < Argc) {
-        // SWITCHES
-        if ((Argv[ArgNum][0] == L'/') || (Argv[ArgNum][0] == L'-')) {
-            if ((StriCmp(Argv[ArgNum], g_BreakSwStr1) == 0) || (StriCmp(Argv[ArgNum], g_BreakSwStr2) == 0)) {
-                // ignore break switch as handled previously
-                ArgNum++;
-                continue;
-            }
-            UINTN i = 0;
-            BOOLEAN found = FALSE;
-            CHAR16* SwStr = NULL; // used to record switch name incase of no value
-            while ((SwTable[i].SwitchNecessity != NO_SW)) {
-                if ( (SwTable[i].SwStr1) && (StriCmp(Argv[ArgNum], SwTable[i].SwStr1) == 0) ) {
-                    found = TRUE;
-                    SwStr = SwTable[i].SwStr1;
-                    break;
-                }
-                if ( (SwTable[i].SwStr2) && (StriCmp(Argv[ArgNum], SwTable[i].SwStr2) == 0) ) {
-                    found = TRUE;
-                    SwStr = SwTable[i].SwStr2;
-                    break;
-                }
-                i++;
-                if (i >= MAX_SWITCH_ENTRIES) {
-                    TableError(i, L"Exceeded maximum switch count");
-                    return SHELL_OUT_OF_RESOURCES;
-                }
-            }
-            if (!found) {
-                ShellPrintEx(-1, -1, L"%H%s%N: Unrecognised switch - '%H%s%N'\r\n", g_ProgName, Argv[ArgNum]);
-                goto Error_exit;
-            }
-            if (SwPresent[i]) {
-                ShellPrintEx(-1, -1, L"%H%s%N: Duplicate switch - '%H%s%N'\r\n", g_ProgName, SwStr);
-                goto Error_exit;
-            }
-            SwPresent[i] = TRUE;
-            if (SwTable[i].ValueType == VALTYPE_NONE) {
-                if (SwTable[i].Data.FlagValue) {
-                    // flag with predefined value
-                    *(SwTable[i].ValueRetPtr.pUintn) = SwTable[i].Data.FlagValue;
-                } else {
-                    // true/false flag 
-                    *(SwTable[i].ValueRetPtr.pBoolean) = TRUE;
-                }
-            } else {
-                // read switch value
-                if (ArgNum + 1 == Argc) {
-                    ShellPrintEx(-1, -1, L"%H%s%N: Switch '%H%s%N' requires a value\r\n", g_ProgName, SwStr);
-                    goto Error_exit;
-                }
-                ArgNum++;
-                if ((Argv[ArgNum][0] == L'/') || (Argv[ArgNum][0] == L'-')) {
-                    ShellPrintEx(-1, -1, L"%H%s%N: Switch '%H%s%N' requires a value\r\n", g_ProgName, SwStr);
-                    goto Error_exit;
-                }
-                if (SwTable[i].ValueRetPtr.pVoid == NULL) {
-                    TableError(i, L"Switch: Null 'RetValPtr'");
-                    goto Error_exit;
-                }
-                VALUE_STATUS ValStatus = ReturnValue(Argv[ArgNum], SwTable[i].ValueType, &SwTable[i].Data, SwTable[i].ValueRetPtr);
-                if (ValStatus != VAL_OK) {
-                    ValueError(ValStatus, SwStr, 0, Argv[ArgNum]);
-                    goto Error_exit;
-                }
-            }
-        } else { // PARAMETERS
-            if (ParamCount >= TableParamCount) {
-                ShellPrintEx(-1, -1, L"%H%s%N: Too many parameters, only %u required\r\n", g_ProgName, TableParamCount);
-                goto Error_exit;
-            }
-            if (ParamTable[ParamCount].ValueRetPtr.pVoid == (VOID *)NULL) {
-                TableError(ParamCount, L"Parameter: Null 'RetValPtr'");
-                goto Error_exit;
-            }
-            VALUE_STATUS ValStatus = ReturnValue(Argv[ArgNum], ParamTable[ParamCount].ValueType, &ParamTable[ParamCount].Data, ParamTable[ParamCount].ValueRetPtr);
-            if (ValStatus != VAL_OK) {
-                ValueError(ValStatus, NULL, ParamCount + 1, Argv[ArgNum]);
+    if (NewParser->SwCount) {
+        NewParser->SwHot = AllocateZeroPool(NewParser->SwCount * sizeof(SWITCH_HOT));
+        if (!NewParser->SwHot) {
+            goto Error_exit;
+        }
+        for (UINTN i = 0; i < NewParser->SwCount; i++) {
+            ShellStatus = CompileEnumIndex(SwTable[i].ValueType, &SwTable[i].Data, &NewParser->SwHot[i].EnumIndex);
+            if (ShellStatus != SHELL_SUCCESS) {
                 goto Error_exit;
             }
-            ParamCount++;
-            if (NumParams) {
-                *NumParams = ParamCount; // update number of actual parameters 
-            }
         }
-        // next cmd line argument
-        ArgNum++;
     }
+    ShellStatus = SHELL_OUT_OF_RESOURCES;
 
-    // initialise switch present flags
-    UINTN i = 0;
-    while (SwTable[i].SwitchNecessity != NO_SW) {
+    // copy value fields of switches to the hot array, and record mandatory switches and the
+    // switches a parse has to reset
+    if (NewParser->SwWords) {
+        NewParser->ManSwMask = AllocateZeroPool(NewParser->SwWords * sizeof(UINTN));
+        NewParser->SwPresentIds = AllocatePool(NewParser->SwCount * 2 * sizeof(UINTN));
+        if (!NewParser->ManSwMask || !NewParser->SwPresentIds) {
+            goto Error_exit;
+        }
+    }
+    for (UINTN i = 0; i < NewParser->SwCount; i++) {
+        SWITCH_HOT *Hot = &NewParser->SwHot[i];
+        Hot->ValueType = SwTable[i].ValueType;
+        Hot->Data = SwTable[i].Data;
+        Hot->ValueRetPtr = SwTable[i].ValueRetPtr;
+        if (SwTable[i].SwitchNecessity == MAN_SW) {
+            BITSET_SET(NewParser->ManSwMask, i);
+        }
         if (SwTable[i].PresentPtr) {
-            *SwTable[i].PresentPtr = SwPresent[i];
+            NewParser->SwPresentIds[NewParser->SwPresentCount++] = i;
+        }
+    }
+    for (UINTN i = 0; i < NewParser->SwCount; i++) {
+        if (IsListType(SwTable[i].ValueType)) {
+            NewParser->SwPresentIds[NewParser->SwPresentCount + NewParser->SwListCount++] = i;
+            NewParser->HasLists = TRUE;
         }
-        i++;
     }
 
-    // check parameter count
-    if (ParamCount < ManParamCount) {
-        ShellPrintEx(-1, -1, L"%H%s%N: Too few parameters, at least %u required\r\n", g_ProgName, ManParamCount);
-        goto Error_exit;
+    // resolve constraint switch names into bitsets, trigger switches then listed switches
+    while (SwTable && (SwTable[NewParser->SwCount + NewParser->ConstraintCount].SwitchNecessity != NO_SW)) {
+        NewParser->ConstraintCount++;
+    }
+    if (NewParser->ConstraintCount) {
+        NewParser->ConstraintMask = AllocateZeroPool(NewParser->ConstraintCount * 2 * NewParser->SwWords * sizeof(UINTN));
+        if (!NewParser->ConstraintMask) {
+            goto Error_exit;
+        }
+        for (UINTN c = 0; c < NewParser->ConstraintCount; c++) {
+            SWITCH_TABLE *Entry = &SwTable[NewParser->SwCount + c];
+            UINTN *IfMask = &NewParser->ConstraintMask[c * 2 * NewParser->SwWords];
+            if (Entry->SwitchNecessity != ONE_OF_SW) {
+                ResolveSwitchList(SwTable, NewParser->SwCount, Entry->SwStr1, IfMask);
+            }
+            ResolveSwitchList(SwTable, NewParser->SwCount, Entry->SwStr2, IfMask + NewParser->SwWords);
+        }
     }
 
-    // check mandatory switches
-    i = 0;
-    while (SwTable[i].SwitchNecessity != NO_SW) {
-        if (SwTable[i].SwitchNecessity == MAN_SW && !SwPresent[i]) {
-            ShellPrintEx(-1, -1, L"%H%s%N: Missing switch - '%H%s%N'\r\n", g_ProgName, SwTable[i].SwStr1);
+    // switch values are recorded by the parse and converted by the accessors
+    if ((FuncOpt & LAZY_VALUES) && NewParser->SwCount) {
+        NewParser->SwValStr = AllocateZeroPool(NewParser->SwCount * sizeof(CONST CHAR16 *));
+        NewParser->SwValStatus = AllocateZeroPool(NewParser->SwCount * sizeof(VALUE_STATUS));
+        NewParser->SwConverted = AllocateZeroPool(NewParser->SwWords * sizeof(UINTN));
+        if (!NewParser->SwValStr || !NewParser->SwValStatus || !NewParser->SwConverted) {
             goto Error_exit;
         }
-        i++;
     }
 
-    ShellStatus = SHELL_SUCCESS;
+    *Parser = NewParser;
+    return SHELL_SUCCESS;
 
 Error_exit:
+    CmdLineFreeParser(NewParser);
 
     return ShellStatus;
 }
 
 /**
- * Function: ValueError
+ * CmdLineFreeParser()
  * 
- * Print a error associated with a parameter or switch value entered
  **/
-STATIC VOID ValueError(
-  IN VALUE_STATUS ValStatus,    // whats wrong with the value
-  IN CONST CHAR16 *SwStr,       // ptr to switch text (e,g "-file"), or...
-  IN UINTN        ParamNum,     // ...parameter position
-  IN CONST CHAR16 *ValString    // ptr to the value string
+VOID CmdLineFreeParser(
+  IN CMDLINE_PARSER *Parser OPTIONAL
   )
 {
-    if (ValStatus == VAL_OK || !ValString) {
+    if (!Parser) {
         return;
     }
-    if (!SwStr && !ParamNum) {
-        return;
+    ArenaFree(&Parser->Arena);
+    StrIndexFree(&Parser->SwIndex);
+    if (Parser->SwTrie) {
+        FreePool(Parser->SwTrie);
     }
-    CHAR16* ErrorStr;
-    switch (ValStatus) {
-        case VAL_STR_TRUNCATED:  ErrorStr = L"has its string truncated"; break;
-        case VAL_DEC_INVALID:    ErrorStr = L"has invalid decimal value"; break;
-        case VAL_HEX_INVALID:    ErrorStr = L"has invalid hex value"; break;
-        case VAL_INT_INVALID:    ErrorStr = L"has invalid integer value"; break;
-        case VAL_UINT8_TOO_BIG:  ErrorStr = L"has too large a number (8-bit)"; break;
-        case VAL_UINT16_TOO_BIG: ErrorStr = L"has too large a number (16-bit)"; break;
-        case VAL_UINT32_TOO_BIG: ErrorStr = L"has too large a number (32-bit)"; break;
-        case VAL_OPT_INVALID:    ErrorStr = L"has invalid option"; break;
-        default:                 ErrorStr = L"UNDEFINED ERROR"; break;
+    if (Parser->ManSwMask) {
+        FreePool(Parser->ManSwMask);
     }
-    if (SwStr) {
-        ShellPrintEx(-1, -1, L"%H%s%N: Switch '%H%s%N' %s - '%H%s%N'\r\n", g_ProgName, SwStr, ErrorStr, ValString);
-    } else {
-        ShellPrintEx(-1, -1, L"%H%s%N: Parameter '%H%u%N' %s - '%H%s%N'\r\n", g_ProgName, ParamNum, ErrorStr, ValString);
+    if (Parser->ConstraintMask) {
+        FreePool(Parser->ConstraintMask);
+    }
+    if (Parser->SwValStr) {
+        FreePool((VOID *)Parser->SwValStr);
+    }
+    if (Parser->SwValStatus) {
+        FreePool(Parser->SwValStatus);
+    }
+    if (Parser->SwConverted) {
+        FreePool(Parser->SwConverted);
+    }
+    if (Parser->ParamEnumIndex) {
+        for (UINTN i = 0; i < Parser->ParamCount; i++) {
+            CmdLineEnumIndexFree(Parser->ParamEnumIndex[i]);
+        }
+        FreePool(Parser->ParamEnumIndex);
     }
+    if (Parser->SwHot) {
+        for (UINTN i = 0; i < Parser->SwCount; i++) {
+            CmdLineEnumIndexFree(Parser->SwHot[i].EnumIndex);
+        }
+        FreePool(Parser->SwHot);
+    }
+    if (Parser->SwPresentIds) {
+        FreePool(Parser->SwPresentIds);
+    }
+    FreePool(Parser);
 }
 
 /**
- * Function: ReturnValue
+ * CmdLineFree()
  * 
- * Convert value string into an actual value
- * Returns status of value
  **/
-STATIC VALUE_STATUS ReturnValue(
-  IN CONST CHAR16   *String,        // ptr to value string
-  IN VALUE_TYPE     ValueType,      // type of value
+VOID CmdLineFree(
+  IN CMDLINE_PARSER *Parser OPTIONAL
+  )
+{
+    ArenaFree(Parser ? &Parser->Arena : &g_Arena);
+}
+
+/**
+ * CmdLineGetPassThrough()
+ * 
+ **/
+BOOLEAN CmdLineGetPassThrough(
+  IN CMDLINE_PARSER *Parser,
+  OUT UINTN         *Argc OPTIONAL,
+  OUT CHAR16        ***Argv OPTIONAL
+  )
+{
+    if (Argc) {
+        *Argc = Parser ? Parser->PassArgs.Argc : 0;
+    }
+    if (Argv) {
+        *Argv = Parser ? Parser->PassArgs.Argv : NULL;
+    }
+    return Parser ? Parser->PassArgs.Found : FALSE;
+}
+
+/**
+ * CmdLineExecute()
+ * 
+ **/
+EFI_STATUS CmdLineExecute(
+  IN EFI_HANDLE     ParentImageHandle,
+  IN UINTN          Argc,
+  IN CHAR16         **Argv,
+  OUT EFI_STATUS    *ExitStatus OPTIONAL,
+  OUT UINT64        *ElapsedNs OPTIONAL
+  )
+{
+    if (ExitStatus) {
+        *ExitStatus = EFI_SUCCESS;
+    }
+    if (ElapsedNs) {
+        *ElapsedNs = 0;
+    }
+    if (!Argc || !Argv) {
+        return EFI_INVALID_PARAMETER;
+    }
+
+    // the shell splits the command line again, so it is quoted and escaped to give back the same arguments
+    UINTN Len = BuildCommandLine(Argc, Argv, NULL);
+    CHAR16 *CmdLine = AllocatePool((Len + 1) * sizeof(CHAR16));
+    if (!CmdLine) {
+        return EFI_OUT_OF_RESOURCES;
+    }
+    BuildCommandLine(Argc, Argv, CmdLine);
+
+    UINT64 Start = GetPerformanceCounter();
+    EFI_STATUS Status = ShellExecute(&ParentImageHandle, CmdLine, TRUE, NULL, ExitStatus);
+    UINT64 End = GetPerformanceCounter();
+    if (ElapsedNs) {
+        *ElapsedNs = GetTimeInNanoSecond(CounterTicks(Start, End));
+    }
+    FreePool(CmdLine);
+
+    return Status;
+}
+
+/**
+ * CmdLineParse()
+ * 
+ **/
+SHELL_STATUS CmdLineParse(
+  IN CMDLINE_PARSER *Parser,
+  OUT UINTN         *NumParams OPTIONAL
+  )
+{
+    UINTN Argc;
+    CHAR16 **Argv;
+
+    // reset number of actual parameters 
+    if (NumParams) {
+        *NumParams = 0;
+    }
+
+    if (EFI_ERROR(GetShellArgs(&Argc, &Argv))) {
+        return SHELL_UNSUPPORTED;
+    }
+    return CmdLineParseArgv(Parser, Argc, Argv, NumParams);
+}
+
+/**
+ * CmdLineParseArgv()
+ * 
+ **/
+SHELL_STATUS CmdLineParseArgv(
+  IN CMDLINE_PARSER *Parser,
+  IN UINTN          Argc,
+  IN CHAR16         **Argv,
+  OUT UINTN         *NumParams OPTIONAL
+  )
+{
+    return ParseArgs(Parser, Argc, (VOID **)Argv, FALSE, NULL, NumParams);
+}
+
+/**
+ * CmdLineParseConfig()
+ * 
+ **/
+SHELL_STATUS CmdLineParseConfig(
+  IN CMDLINE_PARSER *Parser,
+  OUT VOID          *Config,
+  OUT UINTN         *NumParams OPTIONAL
+  )
+{
+    UINTN Argc;
+    CHAR16 **Argv;
+
+    // reset number of actual parameters 
+    if (NumParams) {
+        *NumParams = 0;
+    }
+
+    if (EFI_ERROR(GetShellArgs(&Argc, &Argv))) {
+        return SHELL_UNSUPPORTED;
+    }
+    return CmdLineParseArgvConfig(Parser, Argc, Argv, Config, NumParams);
+}
+
+/**
+ * CmdLineParseArgvConfig()
+ * 
+ **/
+SHELL_STATUS CmdLineParseArgvConfig(
+  IN CMDLINE_PARSER *Parser,
+  IN UINTN          Argc,
+  IN CHAR16         **Argv,
+  OUT VOID          *Config,
+  OUT UINTN         *NumParams OPTIONAL
+  )
+{
+    if (!Config) {
+        if (NumParams) {
+            *NumParams = 0;
+        }
+        return SHELL_INVALID_PARAMETER;
+    }
+    return ParseArgs(Parser, Argc, (VOID **)Argv, FALSE, Config, NumParams);
+}
+
+/**
+ * CmdLineParseArgvAscii()
+ * 
+ **/
+SHELL_STATUS CmdLineParseArgvAscii(
+  IN CMDLINE_PARSER *Parser,
+  IN UINTN          Argc,
+  IN CHAR8          **Argv,
+  OUT UINTN         *NumParams OPTIONAL
+  )
+{
+    return ParseArgs(Parser, Argc, (VOID **)Argv, TRUE, NULL, NumParams);
+}
+
+/**
+ * CmdLineTokenize()
+ * 
+ **/
+SHELL_STATUS CmdLineTokenize(
+  IN OUT CHAR16 *Line,
+  OUT CHAR16    **Argv,
+  IN UINTN      MaxArgs,
+  OUT UINTN     *Argc
+  )
+{
+    if (!Argc) {
+        return SHELL_INVALID_PARAMETER;
+    }
+    *Argc = 0;
+    if (!Line || (MaxArgs && !Argv)) {
+        return SHELL_INVALID_PARAMETER;
+    }
+
+    // chars are read at Src and written back at Dest, which never passes Src
+    CHAR16 *Src = Line;
+    CHAR16 *Dest = Line;
+    BOOLEAN Quoted = FALSE;
+    BOOLEAN InToken = FALSE;
+    for (;;) {
+        CHAR16 Char = *Src++;
+        if ((Char == L'\0') || (!Quoted && ((Char == L' ') || (Char == L'\t')))) {
+            if (InToken) {
+                *Dest++ = L'\0';
+                InToken = FALSE;
+            }
+            if (Char == L'\0') {
+                break;
+            }
+            continue;
+        }
+        if (!InToken) {
+            if (*Argc == MaxArgs) {
+                return SHELL_BUFFER_TOO_SMALL;
+            }
+            Argv[(*Argc)++] = Dest;
+            InToken = TRUE;
+        }
+        if (Char == L'"') {
+            Quoted = !Quoted;   // quotes are removed, "" gives an empty argument
+        } else if ((Char == L'^') && (*Src != L'\0')) {
+            *Dest++ = *Src++;   // escaped char is taken as is, e.g. ^" or ^^
+        } else {
+            *Dest++ = Char;
+        }
+    }
+    return Quoted ? SHELL_INVALID_PARAMETER : SHELL_SUCCESS;
+}
+
+/**
+ * ParseCmdLineString()
+ * 
+ **/
+SHELL_STATUS ParseCmdLineString(
+  IN OUT CHAR16      *Line,
+  OUT CHAR16         **Argv,
+  IN UINTN           MaxArgs,
+  IN PARAMETER_TABLE *ParamTable OPTIONAL,
+  IN UINTN           ManParamCount,
+  IN SWITCH_TABLE    *SwTable OPTIONAL,
+  IN CHAR16          *ProgHelpStr OPTIONAL,
+  IN UINT16          FuncOpt,
+  OUT UINTN          *NumParams OPTIONAL
+  )
+{
+    UINTN Argc;
+
+    // reset number of actual parameters 
+    if (NumParams) {
+        *NumParams = 0;
+    }
+
+    SHELL_STATUS ShellStatus = CmdLineTokenize(Line, Argv, MaxArgs, &Argc);
+    if (ShellStatus != SHELL_SUCCESS) {
+        TokenizeError(ShellStatus, NULL, Argc, Argv, MaxArgs);
+        return ShellStatus;
+    }
+    return ParseArgv(Argc, Argv, ParamTable, ManParamCount, SwTable, ProgHelpStr, FuncOpt, NumParams);
+}
+
+/**
+ * CmdLineParseString()
+ * 
+ **/
+SHELL_STATUS CmdLineParseString(
+  IN CMDLINE_PARSER *Parser,
+  IN OUT CHAR16     *Line,
+  OUT CHAR16        **Argv,
+  IN UINTN          MaxArgs,
+  OUT UINTN         *NumParams OPTIONAL
+  )
+{
+    UINTN Argc;
+
+    // reset number of actual parameters 
+    if (NumParams) {
+        *NumParams = 0;
+    }
+    if (!Parser) {
+        return SHELL_INVALID_PARAMETER;
+    }
+
+    SHELL_STATUS ShellStatus = CmdLineTokenize(Line, Argv, MaxArgs, &Argc);
+    if (ShellStatus != SHELL_SUCCESS) {
+        TokenizeError(ShellStatus, Parser->CmdName, Argc, Argv, MaxArgs);
+        return ShellStatus;
+    }
+    return CmdLineParseArgv(Parser, Argc, Argv, NumParams);
+}
+
+/**
+ * CmdLineGetUintn()
+ * 
+ **/
+SHELL_STATUS CmdLineGetUintn(
+  IN CMDLINE_PARSER *Parser,
+  IN CONST CHAR16   *Name,
+  OUT UINTN         *Value
+  )
+{
+    UINTN Id;
+
+    if (!Value) {
+        return SHELL_INVALID_PARAMETER;
+    }
+    SHELL_STATUS ShellStatus = LookupLazySwitch(Parser, Name, &Id);
+    if (ShellStatus != SHELL_SUCCESS) {
+        return ShellStatus;
+    }
+    SWITCH_TABLE *SwEntry = &Parser->SwTable[Id];
+    VALUE_TYPE ValueType = SwEntry->ValueType;
+    if ((ValueType != VALTYPE_DECIMAL) && (ValueType != VALTYPE_HEXIDECIMAL) && (ValueType != VALTYPE_INTEGER) && (ValueType != VALTYPE_SIGNED) &&
+        (ValueType != VALTYPE_SIZE) && (ValueType != VALTYPE_TIME) && (ValueType != VALTYPE_FREQ)) {
+        return SHELL_INVALID_PARAMETER;
+    }
+    ShellStatus = ConvertLazyValue(Parser, Id);
+    if (ShellStatus != SHELL_SUCCESS) {
+        return ShellStatus;
+    }
+
+    // read back the stored value, signed values are sign extended
+    VALUE_RET_PTR RetPtr = { .pVoid = BindPtr(SwEntry->ValueRetPtr.pVoid, Parser->Config) };
+    BOOLEAN Signed = (ValueType == VALTYPE_SIGNED);
+    switch (SwEntry->Data.ValSize) {
+    case SIZEN:
+        *Value = *RetPtr.pUintn;
+        break;
+    case SIZE8:
+        *Value = Signed ? (UINTN)(INTN)*RetPtr.pInt8 : *RetPtr.pUint8;
+        break;
+    case SIZE16:
+        *Value = Signed ? (UINTN)(INTN)*RetPtr.pInt16 : *RetPtr.pUint16;
+        break;
+    case SIZE32:
+        *Value = Signed ? (UINTN)(INTN)*RetPtr.pInt32 : *RetPtr.pUint32;
+        break;
+    case SIZE64:
+        // 64-bit value must fit a UINTN
+        if (Signed ? ((*RetPtr.pInt64 < MIN_INTN) || (*RetPtr.pInt64 > MAX_INTN)) : (*RetPtr.pUint64 > MAX_UINTN)) {
+            return SHELL_INVALID_PARAMETER;
+        }
+        *Value = (UINTN)*RetPtr.pUint64;
+        break;
+    default:
+        return SHELL_INVALID_PARAMETER;
+    }
+
+    return SHELL_SUCCESS;
+}
+
+/**
+ * CmdLineGetEnum()
+ * 
+ **/
+SHELL_STATUS CmdLineGetEnum(
+  IN CMDLINE_PARSER *Parser,
+  IN CONST CHAR16   *Name,
+  OUT UINTN         *Value
+  )
+{
+    UINTN Id;
+
+    if (!Value) {
+        return SHELL_INVALID_PARAMETER;
+    }
+    SHELL_STATUS ShellStatus = LookupLazySwitch(Parser, Name, &Id);
+    if (ShellStatus != SHELL_SUCCESS) {
+        return ShellStatus;
+    }
+    SWITCH_TABLE *SwEntry = &Parser->SwTable[Id];
+    if (SwEntry->ValueType != VALTYPE_ENUM) {
+        return SHELL_INVALID_PARAMETER;
+    }
+    ShellStatus = ConvertLazyValue(Parser, Id);
+    if (ShellStatus != SHELL_SUCCESS) {
+        return ShellStatus;
+    }
+    *Value = *(unsigned int *)BindPtr(SwEntry->ValueRetPtr.pVoid, Parser->Config);
+
+    return SHELL_SUCCESS;
+}
+
+/**
+ * CmdLineGetStr()
+ * 
+ **/
+SHELL_STATUS CmdLineGetStr(
+  IN CMDLINE_PARSER *Parser,
+  IN CONST CHAR16   *Name,
+  OUT CONST CHAR16  **Str
+  )
+{
+    UINTN Id;
+
+    if (!Str) {
+        return SHELL_INVALID_PARAMETER;
+    }
+    SHELL_STATUS ShellStatus = LookupLazySwitch(Parser, Name, &Id);
+    if (ShellStatus != SHELL_SUCCESS) {
+        return ShellStatus;
+    }
+    VALUE_TYPE ValueType = Parser->SwTable[Id].ValueType;
+    if ((ValueType != VALTYPE_STRING) && (ValueType != VALTYPE_ASCII_STRING) && (ValueType != VALTYPE_STRREF)) {
+        return SHELL_INVALID_PARAMETER;
+    }
+    ShellStatus = ConvertLazyValue(Parser, Id);
+    if (ShellStatus != SHELL_SUCCESS) {
+        return ShellStatus;
+    }
+    *Str = Parser->SwValStr[Id];
+
+    return SHELL_SUCCESS;
+}
+
+/**
+ * DispatchCmdLine()
+ * 
+ **/
+SHELL_STATUS DispatchCmdLine(
+  IN SUBCMD_TABLE   *SubCmdTable,
+  IN CHAR16         *ProgHelpStr OPTIONAL,
+  IN UINT16         FuncOpt
+  )
+{
+    CMDLINE_SUBCMDS *SubCmds;
+
+    SHELL_STATUS ShellStatus = CmdLineSubCmdCompile(SubCmdTable, ProgHelpStr, FuncOpt, &SubCmds);
+    if (ShellStatus != SHELL_SUCCESS) {
+        return ShellStatus;
+    }
+    ShellStatus = CmdLineSubCmdDispatch(SubCmds);
+    CmdLineSubCmdFree(SubCmds);
+
+    return ShellStatus;
+}
+
+/**
+ * CmdLineSubCmdCompile()
+ * 
+ **/
+SHELL_STATUS CmdLineSubCmdCompile(
+  IN SUBCMD_TABLE       *SubCmdTable,
+  IN CHAR16             *ProgHelpStr OPTIONAL,
+  IN UINT16             FuncOpt,
+  OUT CMDLINE_SUBCMDS   **SubCmds
+  )
+{
+    SHELL_STATUS ShellStatus = SHELL_OUT_OF_RESOURCES;
+
+    if (!SubCmds) {
+        return SHELL_INVALID_PARAMETER;
+    }
+    *SubCmds = NULL;
+    if (!SubCmdTable) {
+        return SHELL_INVALID_PARAMETER;
+    }
+
+    CMDLINE_SUBCMDS *NewSubCmds = AllocateZeroPool(sizeof(CMDLINE_SUBCMDS));
+    if (!NewSubCmds) {
+        goto Error_exit;
+    }
+    NewSubCmds->SubCmdTable = SubCmdTable;
+    NewSubCmds->ProgHelpStr = ProgHelpStr;
+    NewSubCmds->FuncOpt = FuncOpt;
+    while (SubCmdTable[NewSubCmds->SubCmdCount].Name) {
+        NewSubCmds->SubCmdCount++;
+    }
+
+    // index subcommand names
+    if (EFI_ERROR(StrIndexInit(&NewSubCmds->NameIndex, NewSubCmds->SubCmdCount))) {
+        goto Error_exit;
+    }
+    for (UINTN i = 0; i < NewSubCmds->SubCmdCount; i++) {
+        CHAR16 *Name = SubCmdTable[i].Name;
+        if ((Name[0] == L'\0') || (Name[0] == L'-') || (Name[0] == L'/')) {
+            TableError(L"SubCmd", i, L"Invalid 'Name'");
+            ShellStatus = SHELL_INVALID_PARAMETER;
+            goto Error_exit;
+        }
+        if (SubCmdTable[i].Handler == NULL) {
+            TableError(L"SubCmd", i, L"Null 'Handler'");
+            ShellStatus = SHELL_INVALID_PARAMETER;
+            goto Error_exit;
+        }
+        if (!StrIndexAdd(&NewSubCmds->NameIndex, Name, i)) {
+            TableError(L"SubCmd", i, L"Duplicate 'Name'");
+            ShellStatus = SHELL_INVALID_PARAMETER;
+            goto Error_exit;
+        }
+    }
+
+    *SubCmds = NewSubCmds;
+    return SHELL_SUCCESS;
+
+Error_exit:
+    CmdLineSubCmdFree(NewSubCmds);
+
+    return ShellStatus;
+}
+
+/**
+ * CmdLineSubCmdDispatch()
+ * 
+ **/
+SHELL_STATUS CmdLineSubCmdDispatch(
+  IN CMDLINE_SUBCMDS    *SubCmds
+  )
+{
+    UINTN Argc;
+    CHAR16 **Argv;
+
+    if (EFI_ERROR(GetShellArgs(&Argc, &Argv))) {
+        return SHELL_UNSUPPORTED;
+    }
+    return CmdLineSubCmdDispatchArgv(SubCmds, Argc, Argv);
+}
+
+/**
+ * CmdLineSubCmdDispatchArgv()
+ * 
+ **/
+SHELL_STATUS CmdLineSubCmdDispatchArgv(
+  IN CMDLINE_SUBCMDS    *SubCmds,
+  IN UINTN              Argc,
+  IN CHAR16             **Argv
+  )
+{
+    if (!SubCmds || (Argc && !Argv)) {
+        return SHELL_INVALID_PARAMETER;
+    }
+
+    // use cmd line parameter for program name if non specified
+    CONST CHAR16 *ProgName = g_ProgName;
+    if (!ProgName) {
+        ProgName = Argc ? GetFileName(Argv[0]) : L"";
+    }
+
+    // global switches come before the subcommand; help lists the subcommands and break is
+    // passed on to the subcommand, as if entered after it
+    BOOLEAN BreakReq = FALSE;
+    UINTN First = 1;
+    for (; First < Argc; First++) {
+        if (!(SubCmds->FuncOpt & NO_HELP) && IsBuiltInSwitch(Argv[First], g_HelpSwStr1, g_HelpSwStr2)) {
+            ShowSubCmdHelp(ProgName, SubCmds);
+            return SHELL_ABORTED;
+        }
+        if (!IsBuiltInSwitch(Argv[First], g_BreakSwStr1, g_BreakSwStr2)) {
+            break;
+        }
+        BreakReq = TRUE;
+    }
+    if (First == Argc) {
+        ShellPrintEx(-1, -1, L"%H%s%N: Missing command\r\n", ProgName);
+        return SHELL_INVALID_PARAMETER;
+    }
+    CONST STR_INDEX_KEY *Key = StrIndexFind(&SubCmds->NameIndex, Argv[First], FALSE, L'\0');
+    if (!Key) {
+        ShellPrintEx(-1, -1, L"%H%s%N: Unrecognised command - '%H%s%N'\r\n", ProgName, Argv[First]);
+        return SHELL_INVALID_PARAMETER;
+    }
+    SUBCMD_TABLE *SubCmd = &SubCmds->SubCmdTable[Key->Id];
+
+    // argument vector of the subcommand starts with its name
+    UINTN SubArgc = Argc - First;
+    CHAR16 **SubArgv = Argv + First;
+    if (BreakReq) {
+        SubArgv = AllocatePool((SubArgc + 1) * sizeof(CHAR16 *));
+        if (!SubArgv) {
+            return SHELL_OUT_OF_RESOURCES;
+        }
+        SubArgv[0] = Argv[First];
+        SubArgv[1] = (CHAR16 *)g_BreakSwStr1;
+        CopyMem(&SubArgv[2], &Argv[First + 1], (SubArgc - 1) * sizeof(CHAR16 *));
+        SubArgc++;
+    }
+
+    // messages and help of the subcommand are given as 'prog subcmd'
+    UINTN CmdNameLen = StrLen(ProgName) + StrLen(SubCmd->Name) + 2;
+    SHELL_STATUS ShellStatus = SHELL_OUT_OF_RESOURCES;
+    CHAR16 *CmdName = AllocatePool(CmdNameLen * sizeof(CHAR16));
+    if (!CmdName) {
+        goto Error_exit;
+    }
+    StrCpyS(CmdName, CmdNameLen, ProgName);
+    StrCatS(CmdName, CmdNameLen, L" ");
+    StrCatS(CmdName, CmdNameLen, SubCmd->Name);
+
+    // parse the rest of the cmd line, with the subcommand in place of the program name
+    CMDLINE_PARSER *Parser;
+    UINTN NumParams;
+    ShellStatus = CmdLineCompile(SubCmd->ParamTable, SubCmd->ManParamCount, SubCmd->SwTable, SubCmd->HelpStr, SubCmds->FuncOpt, &Parser);
+    if (ShellStatus == SHELL_SUCCESS) {
+        Parser->CmdName = CmdName;
+        ShellStatus = CmdLineParseArgv(Parser, SubArgc, SubArgv, &NumParams);
+        if (ShellStatus == SHELL_SUCCESS) {
+            ShellStatus = SubCmd->Handler(Parser, SubArgc, SubArgv, NumParams);
+        }
+        CmdLineFreeParser(Parser);
+    }
+    FreePool(CmdName);
+
+Error_exit:
+    if (SubArgv != Argv + First) {
+        FreePool(SubArgv);
+    }
+
+    return ShellStatus;
+}
+
+/**
+ * CmdLineSubCmdFree()
+ * 
+ **/
+VOID CmdLineSubCmdFree(
+  IN CMDLINE_SUBCMDS    *SubCmds OPTIONAL
+  )
+{
+    if (!SubCmds) {
+        return;
+    }
+    StrIndexFree(&SubCmds->NameIndex);
+    FreePool(SubCmds);
+}
+
+/**
+ * CmdLineBitmapNext()
+ * 
+ **/
+BOOLEAN CmdLineBitmapNext(
+  IN CONST UINTN    *Bitmap,
+  IN UINTN          BitCount,
+  IN OUT UINTN      *Value
+  )
+{
+    if (!Bitmap || !Value) {
+        return FALSE;
+    }
+    // skip clear words
+    UINTN Bit = *Value;
+    while (Bit < BitCount) {
+        UINTN Word = Bitmap[Bit / BITS_PER_WORD] >> (Bit % BITS_PER_WORD);
+        if (Word) {
+            Bit += (UINTN)LowBitSet64(Word);
+            if (Bit >= BitCount) {
+                break;
+            }
+            *Value = Bit;
+            return TRUE;
+        }
+        Bit = (Bit / BITS_PER_WORD + 1) * BITS_PER_WORD;
+    }
+    return FALSE;
+}
+
+/**
+ * CmdLineRangeNext()
+ * 
+ **/
+BOOLEAN CmdLineRangeNext(
+  IN CONST CMDLINE_RANGE_LIST   *RangeList,
+  IN OUT UINT64                 *Value
+  )
+{
+    if (!RangeList || !Value) {
+        return FALSE;
+    }
+    // binary search for first range ending at or after value
+    UINTN Low = 0;
+    UINTN High = RangeList->Count;
+    while (Low < High) {
+        UINTN Mid = Low + (High - Low) / 2;
+        if (RangeList->Ranges[Mid].Last < *Value) {
+            Low = Mid + 1;
+        } else {
+            High = Mid;
+        }
+    }
+    if (Low == RangeList->Count) {
+        return FALSE;
+    }
+    *Value = MAX(*Value, RangeList->Ranges[Low].First);
+    return TRUE;
+}
+
+/**
+ * Function: ParseArgs
+ *
+ * Parses argument vector using a compiled parser, the table return ptrs are either absolute
+ * or, with a config struct, field offsets given by CMDLINE_FIELD(); a UTF-8 vector is read
+ * directly, only the values that must outlive the parse are widened
+ * Returns as ParseCmdLine()
+ **/
+STATIC SHELL_STATUS ParseArgs(
+  IN CMDLINE_PARSER *Parser,        // ptr to parser
+  IN UINTN          Argc,           // number of arguments
+  IN VOID           **Argv,         // argument vector of CHAR16 or UTF-8 strings
+  IN BOOLEAN        Narrow,         // TRUE if argument vector is UTF-8
+  OUT VOID          *Config,        // ptr to config struct; NULL if return ptrs are absolute
+  OUT UINTN         *NumParams      // ptr to return number of parameters; may be NULL
+  )
+{
+    SHELL_STATUS ShellStatus = SHELL_INVALID_PARAMETER;
+
+    // reset number of actual parameters 
+    if (NumParams) {
+        *NumParams = 0;
+    }
+    if (!Parser || (Argc && !Argv)) {
+        return SHELL_INVALID_PARAMETER;
+    }
+
+    PARAMETER_TABLE *ParamTable = Parser->ParamTable;
+    SWITCH_TABLE *SwTable = Parser->SwTable;
+    UINT16 FuncOpt = Parser->FuncOpt;
+
+    // initialise switch present flags; only large tables need to allocate them
+    UINTN PresentStack[PRESENT_STACK_WORDS] = { 0 };
+    UINTN *SwPresent = PresentStack;
+    if (Parser->SwWords > PRESENT_STACK_WORDS) {
+        SwPresent = AllocateZeroPool(Parser->SwWords * sizeof(UINTN));
+        if (!SwPresent) {
+            return SHELL_OUT_OF_RESOURCES;
+        }
+    }
+
+    #if DEBUG_MODE
+    {
+        Print(L"Argc = %u\n", Argc);
+        for (UINTN i = 0; i < Argc; i++) {
+            Print(Narrow ? L"Argv[%u] = '%a'\n" : L"Argv[%u] = '%s'\n", i, Argv[i]);
+        }
+    }
+    #endif
+
+    // lists start empty, values from earlier parses remain until CmdLineFree()
+    if (Parser->HasLists) {
+        for (UINTN i = 0; i < Parser->ParamCount; i++) {
+            if (IsListType(ParamTable[i].ValueType)) {
+                ZeroMem(BindPtr(ParamTable[i].ValueRetPtr.pVoid, Config), sizeof(CMDLINE_LIST));
+            }
+        }
+        for (UINTN n = 0; n < Parser->SwListCount; n++) {
+            UINTN i = Parser->SwPresentIds[Parser->SwPresentCount + n];
+            ZeroMem(BindPtr(Parser->SwHot[i].ValueRetPtr.pVoid, Config), sizeof(CMDLINE_LIST));
+        }
+    }
+
+    // use cmd line parameter for program name if non specified, a UTF-8 one is widened by
+    // GetProgName() when first needed
+    Parser->ProgName = Parser->CmdName ? Parser->CmdName : g_ProgName;
+    Parser->ProgPath = NULL;
+    if (!Parser->ProgName) {
+        if (!Argc) {
+            Parser->ProgName = L"";
+        } else if (Narrow) {
+            Parser->ProgPath = Argv[0];
+        } else {
+            Parser->ProgName = GetFileName(Argv[0]);
+        }
+    }
+
+    // lazy switch values and pass through arguments from an earlier parse are forgotten
+    ZeroMem(&Parser->PassArgs, sizeof(PASS_ARGS));
+    Parser->Config = Config;
+    if (Parser->SwValStr) {
+        ZeroMem((VOID *)Parser->SwValStr, Parser->SwCount * sizeof(CONST CHAR16 *));
+        ZeroMem(Parser->SwConverted, Parser->SwWords * sizeof(UINTN));
+    }
+
+    // parse cmd line arguments in a single pass; help and break override everything else,
+    // so after an error (or help) the remaining switches are only checked for help and break
+    ARG_ERROR ArgError = { ARGERR_NONE, VAL_OK, NULL, 0, NULL, Narrow };
+    BOOLEAN HelpReq = FALSE;
+    BOOLEAN BreakReq = FALSE;
+    UINTN ParamCount = 0;
+    UINTN ArgNum = 1;
+    while (ArgNum < Argc) {
+        CONST VOID *Arg = Argv[ArgNum++];
+        BOOLEAN Stopped = HelpReq || (ArgError.Error != ARGERR_NONE);
+        // end of options, the remaining arguments are left unparsed for the caller
+        if ((FuncOpt & PASS_THROUGH) && (ARG_CHAR(Arg, Narrow, 0) == L'-') && (ARG_CHAR(Arg, Narrow, 1) == L'-') && !ARG_CHAR(Arg, Narrow, 2)) {
+            Parser->PassArgs.Found = TRUE;
+            Parser->PassArgs.Argc = Argc - ArgNum;
+            Parser->PassArgs.Argv = Narrow ? WidenArgv(&Parser->Arena, Argc - ArgNum, (CHAR8 **)&Argv[ArgNum]) : (CHAR16 **)&Argv[ArgNum];
+            if (!Parser->PassArgs.Argv) {
+                ZeroMem(&Parser->PassArgs, sizeof(PASS_ARGS));
+                ShellStatus = SHELL_OUT_OF_RESOURCES;
+                goto Error_exit;
+            }
+            break;
+        }
+        // table entry for next parameter, a list takes all remaining parameters
+        UINTN ParamIdx = ParamCount;
+        if (Parser->ParamRest && (ParamIdx >= Parser->ParamCount)) {
+            ParamIdx = Parser->ParamCount - 1;
+        }
+        // a negative number is the value of a signed parameter rather than a switch
+        BOOLEAN SignedParam = (ParamIdx < Parser->ParamCount) && (ParamTable[ParamIdx].ValueType == VALTYPE_SIGNED);
+        // SWITCHES
+        CHAR16 First = ARG_CHAR(Arg, Narrow, 0);
+        if (((First == L'/') || (First == L'-')) && !(SignedParam && IsNegativeNumber(Arg, Narrow))) {
+            CONST CHAR16* SwStr; // used to record switch name incase of no value
+            UINTN i = LookupSwitch(Parser, Arg, Narrow, &SwStr);
+            if (i == SWID_BREAK) {
+                BreakReq = TRUE;
+                continue;
+            }
+            if (i == SWID_HELP) {
+                HelpReq = TRUE;
+                continue;
+            }
+            if (Stopped) {
+                continue;
+            }
+            if (i == SWID_NONE) {
+                SetArgError(&ArgError, ARGERR_UNRECOGNISED, VAL_OK, NULL, 0, Arg);
+                continue;
+            }
+            if (i == SWID_AMBIGUOUS) {
+                SetArgError(&ArgError, ARGERR_AMBIGUOUS, VAL_OK, NULL, 0, Arg);
+                continue;
+            }
+            SWITCH_HOT *Hot = &Parser->SwHot[i];
+            if (BITSET_TEST(SwPresent, i) && !IsListType(Hot->ValueType)) {
+                SetArgError(&ArgError, ARGERR_DUPLICATE, VAL_OK, SwStr, 0, NULL);
+                continue;
+            }
+            BITSET_SET(SwPresent, i);
+            if (Hot->ValueType == VALTYPE_NONE) {
+                if (Hot->Data.FlagValue) {
+                    // flag with predefined value
+                    *(UINTN *)BindPtr(Hot->ValueRetPtr.pVoid, Config) = Hot->Data.FlagValue;
+                } else {
+                    // true/false flag 
+                    *(BOOLEAN *)BindPtr(Hot->ValueRetPtr.pVoid, Config) = TRUE;
+                }
+            } else {
+                // read switch value, a missing value is left to be checked for help/break
+                if (ArgNum == Argc) {
+                    SetArgError(&ArgError, ARGERR_NO_VALUE, VAL_OK, SwStr, 0, NULL);
+                    continue;
+                }
+                CONST VOID *ValStr = Argv[ArgNum];
+                BOOLEAN SignedVal = (Hot->ValueType == VALTYPE_SIGNED) && IsNegativeNumber(ValStr, Narrow);
+                First = ARG_CHAR(ValStr, Narrow, 0);
+                if (((First == L'/') || (First == L'-')) && !SignedVal) {
+                    SetArgError(&ArgError, ARGERR_NO_VALUE, VAL_OK, SwStr, 0, NULL);
+                    continue;
+                }
+                ArgNum++;
+                if (Parser->SwValStr && !IsListType(Hot->ValueType)) {
+                    // converted by an accessor when first read, so a UTF-8 value is widened to outlive the parse
+                    Parser->SwValStr[i] = Narrow ? WidenArg(&Parser->Arena, ValStr) : ValStr;
+                    if (!Parser->SwValStr[i]) {
+                        SetArgError(&ArgError, ARGERR_VALUE, VAL_NO_MEMORY, SwStr, 0, ValStr);
+                    }
+                    continue;
+                }
+                VALUE_STATUS ValStatus = StoreArgValue(Parser, ValStr, Narrow, Hot->ValueType, &Hot->Data, Hot->EnumIndex, Hot->ValueRetPtr, Config);
+                if (ValStatus != VAL_OK) {
+                    SetArgError(&ArgError, ARGERR_VALUE, ValStatus, SwStr, 0, ValStr);
+                }
+            }
+        } else { // PARAMETERS
+            if (Stopped) {
+                continue;
+            }
+            if (ParamIdx >= Parser->ParamCount) {
+                SetArgError(&ArgError, ARGERR_TOO_MANY, VAL_OK, NULL, Parser->ParamCount, NULL);
+                continue;
+            }
+            VALUE_STATUS ValStatus = StoreArgValue(Parser, Arg, Narrow, ParamTable[ParamIdx].ValueType, &ParamTable[ParamIdx].Data, Parser->ParamEnumIndex[ParamIdx], ParamTable[ParamIdx].ValueRetPtr, Config);
+            if (ValStatus != VAL_OK) {
+                SetArgError(&ArgError, ARGERR_VALUE, ValStatus, NULL, ParamCount + 1, Arg);
+                continue;
+            }
+            ParamCount++;
+            if (NumParams) {
+                *NumParams = ParamCount; // update number of actual parameters 
+            }
+        }
+    }
+
+    // break and help take priority over any error found
+    if (!(FuncOpt & NO_BREAK)) {
+        ShellSetPageBreakMode(BreakReq);
+    }
+    if (HelpReq) {
+        if (NumParams) {
+            *NumParams = 0;
+        }
+        ShowHelp(GetProgName(Parser), Parser->ManParamCount, ParamTable, SwTable, Parser->ProgHelpStr, FuncOpt);
+        ShellStatus = SHELL_ABORTED;
+        goto Error_exit;
+    }
+    if (ArgError.Error != ARGERR_NONE) {
+        ReportArgError(GetProgName(Parser), Parser, &ArgError);
+        goto Error_exit;
+    }
+
+    // initialise switch present flags
+    for (UINTN n = 0; n < Parser->SwPresentCount; n++) {
+        UINTN i = Parser->SwPresentIds[n];
+        *(BOOLEAN *)BindPtr(SwTable[i].PresentPtr, Config) = (BOOLEAN)BITSET_TEST(SwPresent, i);
+    }
+
+    // check parameter count
+    if (ParamCount < Parser->ManParamCount) {
+        ShellPrintEx(-1, -1, L"%H%s%N: Too few parameters, at least %u required\r\n", GetProgName(Parser), Parser->ManParamCount);
+        goto Error_exit;
+    }
+
+    // check mandatory switches, a word at a time
+    for (UINTN w = 0; w < Parser->SwWords; w++) {
+        UINTN Missing = Parser->ManSwMask[w] & ~SwPresent[w];
+        if (Missing) {
+            UINTN i = w * BITS_PER_WORD + (UINTN)LowBitSet64(Missing);
+            ShellPrintEx(-1, -1, L"%H%s%N: Missing switch - '%H%s%N'\r\n", GetProgName(Parser), SwTable[i].SwStr1 ? SwTable[i].SwStr1 : SwTable[i].SwStr2);
+            goto Error_exit;
+        }
+    }
+
+    // check switch constraints
+    for (UINTN c = 0; c < Parser->ConstraintCount; c++) {
+        if (!CheckConstraint(GetProgName(Parser), Parser, c, SwPresent)) {
+            goto Error_exit;
+        }
+    }
+
+    // accessors report value errors after the parse, when a UTF-8 vector may have gone
+    if (Parser->SwValStr) {
+        GetProgName(Parser);
+    }
+
+    ShellStatus = SHELL_SUCCESS;
+
+Error_exit:
+    if (SwPresent != PresentStack) {
+        FreePool(SwPresent);
+    }
+
+    return ShellStatus;
+}
+
+/**
+ * Function: GetProgName
+ *
+ * Gets program name of last parse, widening the file name of a UTF-8 program path the
+ * first time it is needed
+ * Returns ptr to program name
+ **/
+STATIC CONST CHAR16* GetProgName(
+  IN CMDLINE_PARSER *Parser         // ptr to parser
+  )
+{
+    if (!Parser->ProgName) {
+        CONST CHAR8 *Name = Parser->ProgPath ? Parser->ProgPath : "";
+        for (CONST CHAR8 *Ptr = Name; *Ptr; Ptr++) {
+            if (*Ptr == '\\') {
+                Name = Ptr + 1;
+            }
+        }
+        Parser->ProgName = WidenArg(&Parser->Arena, Name);
+        if (!Parser->ProgName) {
+            return L"";
+        }
+    }
+    return Parser->ProgName;
+}
+
+/**
+ * Function: BindPtr
+ *
+ * Resolves a table return ptr, which is a field offset from CMDLINE_FIELD() if parsing into a
+ * config struct
+ * Returns ptr to store value
+ **/
+STATIC VOID* BindPtr(
+  IN VOID   *Ptr,           // return ptr from table
+  IN VOID   *Config         // ptr to config struct; NULL if return ptrs are absolute
+  )
+{
+    if (!Config || !Ptr) {
+        return Ptr;
+    }
+    return (UINT8 *)Config + ((UINTN)Ptr - CMDLINE_FIELD_BIAS);
+}
+
+/**
+ * Function: StoreArgValue
+ *
+ * Converts value string and stores it, or adds it to a list, through a table return ptr; a
+ * UTF-8 value is only widened if the value is handed out as a CHAR16 string
+ * Returns status of value
+ **/
+STATIC VALUE_STATUS StoreArgValue(
+  IN CMDLINE_PARSER             *Parser,        // ptr to parser
+  IN CONST VOID                 *String,        // ptr to value string
+  IN BOOLEAN                    Narrow,         // TRUE if string is UTF-8 rather than CHAR16
+  IN VALUE_TYPE                 ValueType,      // type of value
+  IN DATA                       *Data,          // ptr to misc data for value
+  IN CONST CMDLINE_ENUM_INDEX   *EnumIndex,     // enum index; NULL to scan enum array
+  IN VALUE_RET_PTR              ValueRetPtr,    // return ptr from table
+  IN VOID                       *Config         // ptr to config struct; NULL if return ptrs are absolute
+  )
+{
+    VALUE_RET_PTR RetPtr = { .pVoid = BindPtr(ValueRetPtr.pVoid, Config) };
+
+    if (Narrow && ((ValueType == VALTYPE_STRREF) || (ValueType == VALTYPE_STR_LIST))) {
+        String = WidenArg(&Parser->Arena, String);
+        if (!String) {
+            return VAL_NO_MEMORY;
+        }
+        Narrow = FALSE;
+    }
+    if (IsListType(ValueType)) {
+        return ReturnListValue(&Parser->Arena, String, Narrow, ValueType, RetPtr);
+    }
+    if (ValueType == VALTYPE_RANGES) {
+        return ReturnRangeValue(&Parser->Arena, String, Narrow, RetPtr.pRangeList);
+    }
+    return ReturnValue(String, Narrow, ValueType, Data, EnumIndex, RetPtr);
+}
+
+/**
+ * Function: LookupLazySwitch
+ *
+ * Finds a switch of a parser compiled with LAZY_VALUES by name, which may be abbreviated if SW_PREFIX
+ * Returns SHELL_SUCCESS if found, SHELL_NOT_FOUND if not a switch in the table or
+ * SHELL_INVALID_PARAMETER if the parser does not have lazy values
+ **/
+STATIC SHELL_STATUS LookupLazySwitch(
+  IN CMDLINE_PARSER *Parser,        // ptr to parser
+  IN CONST CHAR16   *Name,          // switch name (e.g. "-file")
+  OUT UINTN         *Id             // ptr to return switch table index
+  )
+{
+    CONST CHAR16 *SwStr;
+
+    if (!Parser || !Name || !Parser->SwValStr) {
+        return SHELL_INVALID_PARAMETER;
+    }
+    UINTN i = LookupSwitch(Parser, Name, FALSE, &SwStr);
+    if (i >= Parser->SwCount) {
+        return SHELL_NOT_FOUND;
+    }
+    *Id = i;
+
+    return SHELL_SUCCESS;
+}
+
+/**
+ * Function: ConvertLazyValue
+ *
+ * Converts and stores the value of a switch the first time it is read, later reads return the
+ * cached status; an invalid value is reported when converted
+ * Returns SHELL_SUCCESS if value valid, SHELL_NOT_FOUND if switch not entered or
+ * SHELL_INVALID_PARAMETER if value invalid
+ **/
+STATIC SHELL_STATUS ConvertLazyValue(
+  IN CMDLINE_PARSER *Parser,        // ptr to parser
+  IN UINTN          Id              // switch table index
+  )
+{
+    CONST CHAR16 *ValStr = Parser->SwValStr[Id];
+    if (!ValStr) {
+        return SHELL_NOT_FOUND;
+    }
+    if (!BITSET_TEST(Parser->SwConverted, Id)) {
+        SWITCH_HOT *Hot = &Parser->SwHot[Id];
+        SWITCH_TABLE *SwEntry = &Parser->SwTable[Id];
+        VALUE_STATUS ValStatus = StoreArgValue(Parser, ValStr, FALSE, Hot->ValueType, &Hot->Data, Hot->EnumIndex, Hot->ValueRetPtr, Parser->Config);
+        if (ValStatus != VAL_OK) {
+            ValueError(GetProgName(Parser), ValStatus, SwEntry->SwStr1 ? SwEntry->SwStr1 : SwEntry->SwStr2, 0, ValStr);
+        }
+        Parser->SwValStatus[Id] = ValStatus;
+        BITSET_SET(Parser->SwConverted, Id);
+    }
+
+    return (Parser->SwValStatus[Id] == VAL_OK) ? SHELL_SUCCESS : SHELL_INVALID_PARAMETER;
+}
+
+/**
+ * Function: SetArgError
+ * 
+ * Records an argument error, only the first error found is kept
+ **/
+STATIC VOID SetArgError(
+  OUT ARG_ERROR         *ArgError,  // ptr to error record
+  IN ARG_ERROR_TYPE     Error,      // type of error
+  IN VALUE_STATUS       ValStatus,  // value status if ARGERR_VALUE
+  IN CONST CHAR16       *Str,       // switch string in error; NULL if unrecognised or ambiguous
+  IN UINTN              Num,        // parameter position, or parameter count if ARGERR_TOO_MANY
+  IN CONST VOID         *Arg        // unrecognised or ambiguous switch, or value if ARGERR_VALUE
+  )
+{
+    if (ArgError->Error != ARGERR_NONE) {
+        return;
+    }
+    ArgError->Error = Error;
+    ArgError->ValStatus = ValStatus;
+    ArgError->Str = Str;
+    ArgError->Num = Num;
+    ArgError->Arg = Arg;
+}
+
+/**
+ * Function: ReportArgError
+ * 
+ * Print an argument error recorded during the cmd line scan, a UTF-8 argument is widened
+ * for printing
+ **/
+STATIC VOID ReportArgError(
+  IN CONST CHAR16           *ProgName,  // program name
+  IN CMDLINE_PARSER         *Parser,    // ptr to parser
+  IN CONST ARG_ERROR        *ArgError   // ptr to error record
+  )
+{
+    CONST CHAR16 *ArgStr = ArgError->Arg;
+    if (ArgStr && ArgError->Narrow) {
+        ArgStr = WidenArg(&Parser->Arena, ArgError->Arg);
+        if (!ArgStr) {
+            ArgStr = L"";
+        }
+    }
+
+    switch (ArgError->Error) {
+    case ARGERR_UNRECOGNISED:
+        ShellPrintEx(-1, -1, L"%H%s%N: Unrecognised switch - '%H%s%N'\r\n", ProgName, ArgStr);
+        break;
+    case ARGERR_AMBIGUOUS:
+        ShellPrintEx(-1, -1, L"%H%s%N: Ambiguous switch - '%H%s%N' could be", ProgName, ArgStr);
+        PrintTrieNames(Parser->SwTrie, TrieWalk(Parser->SwTrie, ArgError->Arg, ArgError->Narrow));
+        ShellPrintEx(-1, -1, L"\r\n");
+        break;
+    case ARGERR_DUPLICATE:
+        ShellPrintEx(-1, -1, L"%H%s%N: Duplicate switch - '%H%s%N'\r\n", ProgName, ArgError->Str);
+        break;
+    case ARGERR_NO_VALUE:
+        ShellPrintEx(-1, -1, L"%H%s%N: Switch '%H%s%N' requires a value\r\n", ProgName, ArgError->Str);
+        break;
+    case ARGERR_VALUE:
+        ValueError(ProgName, ArgError->ValStatus, ArgError->Str, ArgError->Num, ArgStr);
+        break;
+    case ARGERR_TOO_MANY:
+        ShellPrintEx(-1, -1, L"%H%s%N: Too many parameters, only %u required\r\n", ProgName, ArgError->Num);
+        break;
+    default:
+        break;
+    }
+}
+
+/**
+ * Function: CheckConstraint
+ * 
+ * Check a switch constraint against the switches entered, a word at a time, printing any error
+ * Returns FALSE if the constraint is broken
+ **/
+STATIC BOOLEAN CheckConstraint(
+  IN CONST CHAR16           *ProgName,  // program name
+  IN CONST CMDLINE_PARSER   *Parser,    // ptr to parser
+  IN UINTN                  Constraint, // constraint number
+  IN CONST UINTN            *SwPresent  // bitset of switches entered
+  )
+{
+    CONST SWITCH_TABLE *SwTable = Parser->SwTable;
+    CONST SWITCH_TABLE *Entry = &SwTable[Parser->SwCount + Constraint];
+    CONST UINTN *IfMask = &Parser->ConstraintMask[Constraint * 2 * Parser->SwWords];
+    CONST UINTN *ListMask = IfMask + Parser->SwWords;
+    UINTN Trigger = SWID_NONE;  // first trigger switch entered
+    UINTN Missing = SWID_NONE;  // first listed switch not entered
+    UINTN Entered = SWID_NONE;  // first listed switch entered
+    UINTN Count = 0;            // number of listed switches entered, counted up to two per word
+
+    for (UINTN w = 0; w < Parser->SwWords; w++) {
+        UINTN Bits = SwPresent[w] & IfMask[w];
+        if (Bits && (Trigger == SWID_NONE)) {
+            Trigger = w * BITS_PER_WORD + (UINTN)LowBitSet64(Bits);
+        }
+        Bits = ListMask[w] & ~SwPresent[w];
+        if (Bits && (Missing == SWID_NONE)) {
+            Missing = w * BITS_PER_WORD + (UINTN)LowBitSet64(Bits);
+        }
+        Bits = ListMask[w] & SwPresent[w];
+        if (Bits) {
+            if (Entered == SWID_NONE) {
+                Entered = w * BITS_PER_WORD + (UINTN)LowBitSet64(Bits);
+            }
+            Count += (Bits & (Bits - 1)) ? 2 : 1;
+        }
+    }
+
+    switch (Entry->SwitchNecessity) {
+    case REQUIRES_SW:
+        if ((Trigger != SWID_NONE) && (Missing != SWID_NONE)) {
+            ShellPrintEx(-1, -1, L"%H%s%N: Switch '%H%s%N' requires '%H%s%N'\r\n", ProgName,
+                SwTable[Trigger].SwStr1 ? SwTable[Trigger].SwStr1 : SwTable[Trigger].SwStr2,
+                SwTable[Missing].SwStr1 ? SwTable[Missing].SwStr1 : SwTable[Missing].SwStr2);
+            return FALSE;
+        }
+        break;
+    case CONFLICTS_SW:
+        if ((Trigger != SWID_NONE) && (Entered != SWID_NONE)) {
+            ShellPrintEx(-1, -1, L"%H%s%N: Switch '%H%s%N' cannot be used with '%H%s%N'\r\n", ProgName,
+                SwTable[Trigger].SwStr1 ? SwTable[Trigger].SwStr1 : SwTable[Trigger].SwStr2,
+                SwTable[Entered].SwStr1 ? SwTable[Entered].SwStr1 : SwTable[Entered].SwStr2);
+            return FALSE;
+        }
+        break;
+    case ONE_OF_SW:
+        if (Count == 0) {
+            ShellPrintEx(-1, -1, L"%H%s%N: One of '%H%s%N' required\r\n", ProgName, Entry->SwStr2);
+            return FALSE;
+        }
+        if (Count > 1) {
+            ShellPrintEx(-1, -1, L"%H%s%N: Only one of '%H%s%N' allowed\r\n", ProgName, Entry->SwStr2);
+            return FALSE;
+        }
+        break;
+    default:
+        break;
+    }
+    return TRUE;
+}
+
+/**
+ * Function: ValueError
+ * 
+ * Print a error associated with a parameter or switch value entered
+ **/
+STATIC VOID ValueError(
+  IN CONST CHAR16 *ProgName,    // program name
+  IN VALUE_STATUS ValStatus,    // whats wrong with the value
+  IN CONST CHAR16 *SwStr,       // ptr to switch text (e,g "-file"), or...
+  IN UINTN        ParamNum,     // ...parameter position
+  IN CONST CHAR16 *ValString    // ptr to the value string
+  )
+{
+    if (ValStatus == VAL_OK || !ValString) {
+        return;
+    }
+    if (!SwStr && !ParamNum) {
+        return;
+    }
+    CHAR16* ErrorStr;
+    switch (ValStatus) {
+        case VAL_STR_TRUNCATED:  ErrorStr = L"has its string truncated"; break;
+        case VAL_STR_NOT_ASCII:  ErrorStr = L"has non-ASCII character"; break;
+        case VAL_NO_MEMORY:      ErrorStr = L"could not be stored, out of memory"; break;
+        case VAL_DEC_INVALID:    ErrorStr = L"has invalid decimal value"; break;
+        case VAL_HEX_INVALID:    ErrorStr = L"has invalid hex value"; break;
+        case VAL_INT_INVALID:    ErrorStr = L"has invalid integer value"; break;
+        case VAL_UINT8_TOO_BIG:  ErrorStr = L"has too large a number (8-bit)"; break;
+        case VAL_UINT16_TOO_BIG: ErrorStr = L"has too large a number (16-bit)"; break;
+        case VAL_UINT32_TOO_BIG: ErrorStr = L"has too large a number (32-bit)"; break;
+        case VAL_UINT64_TOO_BIG: ErrorStr = L"has too large a number (64-bit)"; break;
+        case VAL_SINT_INVALID:   ErrorStr = L"has invalid signed integer value"; break;
+        case VAL_INT8_OUT_OF_RANGE:  ErrorStr = L"has out of range number (8-bit signed)"; break;
+        case VAL_INT16_OUT_OF_RANGE: ErrorStr = L"has out of range number (16-bit signed)"; break;
+        case VAL_INT32_OUT_OF_RANGE: ErrorStr = L"has out of range number (32-bit signed)"; break;
+        case VAL_INT64_OUT_OF_RANGE: ErrorStr = L"has out of range number (64-bit signed)"; break;
+        case VAL_SIZE_INVALID:   ErrorStr = L"has invalid size value"; break;
+        case VAL_TIME_INVALID:   ErrorStr = L"has invalid time value"; break;
+        case VAL_FREQ_INVALID:   ErrorStr = L"has invalid frequency value"; break;
+        case VAL_UNIT_INEXACT:   ErrorStr = L"has fraction too fine for its units"; break;
+        case VAL_RANGE_INVALID:  ErrorStr = L"has invalid range"; break;
+        case VAL_RANGE_OUT_OF_BOUNDS: ErrorStr = L"has range out of bounds"; break;
+        case VAL_OPT_INVALID:    ErrorStr = L"has invalid option"; break;
+        default:                 ErrorStr = L"UNDEFINED ERROR"; break;
+    }
+    if (SwStr) {
+        ShellPrintEx(-1, -1, L"%H%s%N: Switch '%H%s%N' %s - '%H%s%N'\r\n", ProgName, SwStr, ErrorStr, ValString);
+    } else {
+        ShellPrintEx(-1, -1, L"%H%s%N: Parameter '%H%u%N' %s - '%H%s%N'\r\n", ProgName, ParamNum, ErrorStr, ValString);
+    }
+}
+
+/**
+ * Function: ReturnValue
+ * 
+ * Convert value string into an actual value
+ * Returns status of value
+ **/
+STATIC VALUE_STATUS ReturnValue(
+  IN CONST VOID     *String,        // ptr to value string
+  IN BOOLEAN        Narrow,         // TRUE if string is UTF-8 rather than CHAR16
+  IN VALUE_TYPE     ValueType,      // type of value
   IN DATA           *Data,          // ptr to misc data for value
+  IN CONST CMDLINE_ENUM_INDEX *EnumIndex OPTIONAL, // enum index; NULL to scan enum array
+  OUT VALUE_RET_PTR ValueRetPtr     // ptr to store converted value
+  )
+{
+    UINTN Value;
+    UINT64 IntValue;
+    EFI_STATUS Status;
+    VALUE_STATUS ValStatus;
+    
+    if ( !String || (!ValueRetPtr.pVoid) ) {
+        return VAL_ERROR;
+    }
+
+    switch (ValueType) {
+    case VALTYPE_STRING:
+        if (Narrow) {
+            if (DecodeUtf8Str(String, ValueRetPtr.pChar16, Data->MaxStrSize) == EFI_BUFFER_TOO_SMALL) {
+                return VAL_STR_TRUNCATED;
+            }
+            break;
+        }
+        StrnCpyS(ValueRetPtr.pChar16, Data->MaxStrSize, String, Data->MaxStrSize-1);
+        if (StrLen(String) > Data->MaxStrSize-1) {
+            return VAL_STR_TRUNCATED;
+        }
+        break;
+    case VALTYPE_ASCII_STRING:
+        if (Narrow) {
+            Status = CopyAsciiStr(String, ValueRetPtr.pChar8, Data->MaxStrSize);
+        } else {
+            Status = CmdLineNarrowStr(String, ValueRetPtr.pChar8, Data->MaxStrSize, NULL);
+        }
+        if (Status == EFI_INVALID_PARAMETER) {
+            return VAL_STR_NOT_ASCII;
+        }
+        if (Status == EFI_BUFFER_TOO_SMALL) {
+            return VAL_STR_TRUNCATED;
+        }
+        break;
+    case VALTYPE_STRREF:
+        // a UTF-8 value is widened by StoreArgValue() first
+        if (Narrow) {
+            return VAL_ERROR;
+        }
+        ValueRetPtr.pStrRef->Str = String;
+        ValueRetPtr.pStrRef->Len = StrLen(String);
+        break;
+    case VALTYPE_DECIMAL:
+    case VALTYPE_HEXIDECIMAL:
+    case VALTYPE_INTEGER:
+    case VALTYPE_SIGNED:
+        ValStatus = ParseInteger(String, Narrow, ValueType, Data->ValSize, &IntValue);
+        if (ValStatus == VAL_OK) {
+            ValStatus = ProcessIntVal(IntValue, Data->ValSize, ValueRetPtr);
+        }
+        if (ValStatus != VAL_OK) {
+            return ValStatus;
+        }
+        break;
+    case VALTYPE_SIZE:
+    case VALTYPE_TIME:
+    case VALTYPE_FREQ:
+        ValStatus = ParseUnitValue(String, Narrow, ValueType, Data->ValSize, &IntValue);
+        if (ValStatus == VAL_OK) {
+            ValStatus = ProcessIntVal(IntValue, Data->ValSize, ValueRetPtr);
+        }
+        if (ValStatus != VAL_OK) {
+            return ValStatus;
+        }
+        break;
+    case VALTYPE_BITMAP:
+        return ReturnBitmapValue(String, Narrow, Data->BitCount, ValueRetPtr.pBitmap);
+    case VALTYPE_ENUM_SET:
+        return ReturnEnumSetValue(String, Narrow, Data->EnumStrArray, EnumIndex, ValueRetPtr.pUint64);
+    case VALTYPE_ENUM:
+        if (EnumIndex ? FindEnumIndex(EnumIndex, String, Narrow, &Value) : GetEnumVal(Data->EnumStrArray, String, Narrow, &Value)) {
+            *ValueRetPtr.pEnum = (unsigned int)Value;
+        } else {
+            return VAL_OPT_INVALID;
+        }
+        break;
+    default:
+        return VAL_UNSUPPORTED_TYPE;
+    }
+    
+    return VAL_OK;
+}
+
+/**
+ * Function: ReturnListValue
+ *
+ * Convert value string and add it to a list
+ * Returns status of value
+ **/
+STATIC VALUE_STATUS ReturnListValue(
+  IN ARENA          *Arena,         // arena holding list items
+  IN CONST VOID     *String,        // ptr to value string
+  IN BOOLEAN        Narrow,         // TRUE if string is UTF-8 rather than CHAR16
+  IN VALUE_TYPE     ValueType,      // type of list
+  OUT VALUE_RET_PTR ValueRetPtr     // ptr to list
+  )
+{
+    UINTN Value;
+    VOID *Item = &Value;
+    UINTN ItemSize = sizeof(UINTN);
+    VALUE_TYPE ItemType;
+
+    switch (ValueType) {
+    case VALTYPE_DEC_LIST: ItemType = VALTYPE_DECIMAL; break;
+    case VALTYPE_HEX_LIST: ItemType = VALTYPE_HEXIDECIMAL; break;
+    case VALTYPE_INT_LIST: ItemType = VALTYPE_INTEGER; break;
+    case VALTYPE_STR_LIST:
+        // a UTF-8 value is widened by StoreArgValue() first
+        if (Narrow) {
+            return VAL_ERROR;
+        }
+        Item = &String;
+        ItemSize = sizeof(CONST CHAR16 *);
+        ItemType = VALTYPE_NONE;
+        break;
+    default:
+        return VAL_UNSUPPORTED_TYPE;
+    }
+    if (ItemType != VALTYPE_NONE) {
+        DATA ItemData = { .ValSize = SIZEN };
+        VALUE_RET_PTR ItemRetPtr = { .pUintn = &Value };
+        VALUE_STATUS ValStatus = ReturnValue(String, Narrow, ItemType, &ItemData, NULL, ItemRetPtr);
+        if (ValStatus != VAL_OK) {
+            return ValStatus;
+        }
+    }
+
+    CMDLINE_LIST *List = ValueRetPtr.pList;
+    if (List->Count == List->Capacity) {
+        UINTN Capacity = List->Capacity ? List->Capacity * 2 : LIST_MIN_CAPACITY;
+        VOID *Items = ArenaGrow(Arena, List->Items.Ptr, List->Capacity * ItemSize, Capacity * ItemSize);
+        if (!Items) {
+            return VAL_NO_MEMORY;
+        }
+        List->Items.Ptr = Items;
+        List->Capacity = Capacity;
+    }
+    CopyMem((UINT8 *)List->Items.Ptr + List->Count * ItemSize, Item, ItemSize);
+    List->Count++;
+    return VAL_OK;
+}
+
+/**
+ * Function: IsListType
+ *
+ * Returns TRUE if value type is a list
+ **/
+STATIC BOOLEAN IsListType(
+  IN VALUE_TYPE ValueType   // type of value
+  )
+{
+    switch (ValueType) {
+    case VALTYPE_DEC_LIST:
+    case VALTYPE_HEX_LIST:
+    case VALTYPE_INT_LIST:
+    case VALTYPE_STR_LIST:
+        return TRUE;
+    default:
+        return FALSE;
+    }
+}
+
+/**
+ * Function: ReturnBitmapValue
+ *
+ * Converts a range string (e.g. '1,3,5-9') into a bitmap, each value must be below the
+ * number of bits. The bitmap is built in a local buffer, allocated if too large for the
+ * stack, and only written if the whole string is valid
+ * Returns status of value
+ **/
+STATIC VALUE_STATUS ReturnBitmapValue(
+  IN CONST VOID     *String,        // ptr to value string
+  IN BOOLEAN        Narrow,         // TRUE if string is UTF-8 rather than CHAR16
+  IN UINTN          BitCount,       // number of bits in bitmap
+  OUT UINTN         *Bitmap         // ptr to bitmap
+  )
+{
+    CMDLINE_RANGE Range;
+    UINTN Pos = 0;
+    UINTN Words = CMDLINE_BITMAP_WORDS(BitCount);
+    UINTN LocalBitmap[BITMAP_LOCAL_WORDS];
+    UINTN *NewBitmap = LocalBitmap;
+    VALUE_STATUS ValStatus;
+
+    if (Words > BITMAP_LOCAL_WORDS) {
+        NewBitmap = AllocatePool(Words * sizeof(UINTN));
+        if (!NewBitmap) {
+            return VAL_NO_MEMORY;
+        }
+    }
+    ZeroMem(NewBitmap, Words * sizeof(UINTN));
+    do {
+        ValStatus = ParseRangeItem(String, Narrow, &Pos, &Range);
+        if (ValStatus != VAL_OK) {
+            break;
+        }
+        if (Range.Last >= BitCount) {
+            ValStatus = VAL_RANGE_OUT_OF_BOUNDS;
+            break;
+        }
+        // set a word at a time where the range covers whole words
+        UINTN Bit = (UINTN)Range.First;
+        UINTN Last = (UINTN)Range.Last;
+        while (Bit <= Last) {
+            if (((Bit % BITS_PER_WORD) == 0) && (Last - Bit >= BITS_PER_WORD - 1)) {
+                NewBitmap[Bit / BITS_PER_WORD] = MAX_UINTN;
+                Bit += BITS_PER_WORD;
+            } else {
+                BITSET_SET(NewBitmap, Bit);
+                Bit++;
+            }
+        }
+    } while (ARG_CHAR(String, Narrow, Pos) != L'\0');
+
+    if (ValStatus == VAL_OK) {
+        CopyMem(Bitmap, NewBitmap, Words * sizeof(UINTN));
+    }
+    if (NewBitmap != LocalBitmap) {
+        FreePool(NewBitmap);
+    }
+    return ValStatus;
+}
+
+/**
+ * Function: ReturnEnumSetValue
+ *
+ * Converts a list of enum strings (e.g. 'all,^debug') into a set, read from left to right; each
+ * string ORs its value into the set, or removes it if preceded by '^', and 'all' and 'none'
+ * stand for every value and no value. Strings are looked up in place, without copying
+ * Returns status of value
+ **/
+STATIC VALUE_STATUS ReturnEnumSetValue(
+  IN CONST VOID     *String,        // ptr to value string
+  IN BOOLEAN        Narrow,         // TRUE if string is UTF-8 rather than CHAR16
+  IN ENUM_STR_ARRAY *EnumStrArray,  // enum to string array
+  IN CONST CMDLINE_ENUM_INDEX *EnumIndex OPTIONAL, // enum index; NULL to scan enum array
+  OUT UINT64        *Set            // ptr to set
+  )
+{
+    UINT64 NewSet = 0;
+    BOOLEAN More;
+
+    do {
+        BOOLEAN Remove = (ARG_CHAR(String, Narrow, 0) == L'^');
+        if (Remove) {
+            String = ARG_PTR(String, Narrow, 1);
+        }
+        CONST VOID *End;
+        UINTN Len = ArgStrLen(String, Narrow, L',', &End);
+        if (!Len) {
+            return VAL_OPT_INVALID;
+        }
+        UINT64 Value = 0;
+        if ((Len == 4) && ArgStrniEqual(L"none", String, Narrow, 4)) {
+            NewSet = Remove ? NewSet : 0;
+        } else {
+            if ((Len == 3) && ArgStrniEqual(L"all", String, Narrow, 3)) {
+                for (UINTN i = 0; EnumStrArray[i].Str; i++) {
+                    Value |= EnumStrArray[i].Value;
+                }
+            } else if (EnumIndex) {
+                CONST STR_INDEX_KEY *Key = StrIndexFind(&EnumIndex->StrIndex, String, Narrow, L',');
+                if (!Key) {
+                    return VAL_OPT_INVALID;
+                }
+                Value = EnumStrArray[Key->Id].Value;
+            } else {
+                UINTN i = 0;
+                while (EnumStrArray[i].Str && !((StrLen(EnumStrArray[i].Str) == Len) && ArgStrniEqual(EnumStrArray[i].Str, String, Narrow, Len))) {
+                    i++;
+                }
+                if (!EnumStrArray[i].Str) {
+                    return VAL_OPT_INVALID;
+                }
+                Value = EnumStrArray[i].Value;
+            }
+            NewSet = Remove ? (NewSet & ~Value) : (NewSet | Value);
+        }
+        More = (ARG_CHAR(End, Narrow, 0) == L',');
+        String = ARG_PTR(End, Narrow, 1);
+    } while (More);
+    *Set = NewSet;
+
+    return VAL_OK;
+}
+
+/**
+ * Function: ReturnRangeValue
+ *
+ * Converts a range string (e.g. '0x1000:0x2000,0x8000+0x100') into a sorted list of ranges
+ * held in the arena, merging ranges that overlap or are adjacent
+ * Returns status of value
+ **/
+STATIC VALUE_STATUS ReturnRangeValue(
+  IN ARENA              *Arena,     // arena to hold ranges
+  IN CONST VOID         *String,    // ptr to value string
+  IN BOOLEAN            Narrow,     // TRUE if string is UTF-8 rather than CHAR16
+  OUT CMDLINE_RANGE_LIST *RangeList // ptr to range list
+  )
+{
+    CMDLINE_RANGE *Ranges = NULL;
+    UINTN Count = 0;
+    UINTN Capacity = 0;
+    UINTN Pos = 0;
+
+    do {
+        if (Count == Capacity) {
+            UINTN NewCapacity = Capacity ? Capacity * 2 : LIST_MIN_CAPACITY;
+            CMDLINE_RANGE *NewRanges = ArenaGrow(Arena, Ranges, Capacity * sizeof(CMDLINE_RANGE), NewCapacity * sizeof(CMDLINE_RANGE));
+            if (!NewRanges) {
+                return VAL_NO_MEMORY;
+            }
+            Ranges = NewRanges;
+            Capacity = NewCapacity;
+        }
+        VALUE_STATUS ValStatus = ParseRangeItem(String, Narrow, &Pos, &Ranges[Count]);
+        if (ValStatus != VAL_OK) {
+            return ValStatus;
+        }
+        Count++;
+    } while (ARG_CHAR(String, Narrow, Pos) != L'\0');
+
+    // sort and merge in place
+    if (Count > 1) {
+        CMDLINE_RANGE Temp;
+        QuickSort(Ranges, Count, sizeof(CMDLINE_RANGE), CompareRange, &Temp);
+    }
+    UINTN Merged = 0;
+    for (UINTN i = 1; i < Count; i++) {
+        if ((Ranges[Merged].Last == MAX_UINT64) || (Ranges[i].First <= Ranges[Merged].Last + 1)) {
+            Ranges[Merged].Last = MAX(Ranges[Merged].Last, Ranges[i].Last);
+        } else {
+            Ranges[++Merged] = Ranges[i];
+        }
+    }
+    RangeList->Count = Merged + 1;
+    RangeList->Ranges = Ranges;
+
+    return VAL_OK;
+}
+
+/**
+ * Function: ParseRangeItem
+ *
+ * Converts a range from a comma separated list; a value 'A', 'A-B' (inclusive), 'A:B' (B
+ * excluded) or 'A+L' (L values from A). Values are decimal or '0x' prefixed hex.
+ * Returns status of value, with position moved past the range and any following comma
+ **/
+STATIC VALUE_STATUS ParseRangeItem(
+  IN CONST VOID         *String,    // ptr to range string
+  IN BOOLEAN            Narrow,     // TRUE if string is UTF-8 rather than CHAR16
+  IN OUT UINTN          *Pos,       // ptr to position in string
+  OUT CMDLINE_RANGE     *Range      // converted range
+  )
+{
+    UINT64 Value = 0;
+
+    VALUE_STATUS ValStatus = ParseRangeNumber(String, Narrow, Pos, &Range->First);
+    if (ValStatus != VAL_OK) {
+        return ValStatus;
+    }
+    CHAR16 Op = ARG_CHAR(String, Narrow, *Pos);
+    if ((Op == L'-') || (Op == L':') || (Op == L'+')) {
+        (*Pos)++;
+        ValStatus = ParseRangeNumber(String, Narrow, Pos, &Value);
+        if (ValStatus != VAL_OK) {
+            return ValStatus;
+        }
+    }
+    switch (Op) {
+    case L'-':
+        if (Value < Range->First) {
+            return VAL_RANGE_INVALID;
+        }
+        Range->Last = Value;
+        break;
+    case L':':
+        if (Value <= Range->First) {
+            return VAL_RANGE_INVALID;
+        }
+        Range->Last = Value - 1;
+        break;
+    case L'+':
+        if (Value == 0) {
+            return VAL_RANGE_INVALID;
+        }
+        if (Value - 1 > MAX_UINT64 - Range->First) {
+            return VAL_RANGE_OUT_OF_BOUNDS;
+        }
+        Range->Last = Range->First + (Value - 1);
+        break;
+    default:
+        Range->Last = Range->First;
+        break;
+    }
+
+    if (ARG_CHAR(String, Narrow, *Pos) == L',') {
+        (*Pos)++;
+        if (ARG_CHAR(String, Narrow, *Pos) == L'\0') {
+            return VAL_RANGE_INVALID;
+        }
+    } else if (ARG_CHAR(String, Narrow, *Pos) != L'\0') {
+        return VAL_RANGE_INVALID;
+    }
+    return VAL_OK;
+}
+
+/**
+ * Function: ParseRangeNumber
+ *
+ * Converts a decimal or '0x' prefixed hex number at a position in a string
+ * Returns status of value, with position moved past the number
+ **/
+STATIC VALUE_STATUS ParseRangeNumber(
+  IN CONST VOID         *String,    // ptr to number string
+  IN BOOLEAN            Narrow,     // TRUE if string is UTF-8 rather than CHAR16
+  IN OUT UINTN          *Pos,       // ptr to position in string
+  OUT UINT64            *Value      // converted value
+  )
+{
+    UINTN i = *Pos;
+    BOOLEAN Hex = (ARG_CHAR(String, Narrow, i) == L'0') && (CharToUpper(ARG_CHAR(String, Narrow, i + 1)) == L'X');
+    if (Hex) {
+        i += 2;
+    }
+    UINT64 Number = 0;
+    BOOLEAN Digits = FALSE;
+    BOOLEAN OutOfRange = FALSE;
+    for (;; i++) {
+        CHAR16 Char = ARG_CHAR(String, Narrow, i);
+        UINTN Digit;
+        if ((Char >= L'0') && (Char <= L'9')) {
+            Digit = Char - L'0';
+        } else if (Hex && (CharToUpper(Char) >= L'A') && (CharToUpper(Char) <= L'F')) {
+            Digit = CharToUpper(Char) - L'A' + 10;
+        } else {
+            break;
+        }
+        Digits = TRUE;
+        if (Hex) {
+            OutOfRange = OutOfRange || (RShiftU64(Number, 60) != 0);
+            Number = LShiftU64(Number, 4) + Digit;
+        } else {
+            OutOfRange = OutOfRange || (Number > 0x1999999999999999ULL) || ((Number == 0x1999999999999999ULL) && (Digit > 5));
+            Number = MultU64x32(Number, 10) + Digit;
+        }
+    }
+    if (!Digits) {
+        return VAL_RANGE_INVALID;
+    }
+    if (OutOfRange) {
+        return VAL_UINT64_TOO_BIG;
+    }
+    *Pos = i;
+    *Value = Number;
+    return VAL_OK;
+}
+
+/**
+ * Function: CompareRange
+ *
+ * QuickSort() compare of ranges by first value
+ * Returns <0, 0 or >0 as for StrCmp()
+ **/
+STATIC INTN EFIAPI CompareRange(
+  IN CONST VOID *Buffer1,   // first range
+  IN CONST VOID *Buffer2    // second range
+  )
+{
+    CONST CMDLINE_RANGE *Range1 = Buffer1;
+    CONST CMDLINE_RANGE *Range2 = Buffer2;
+
+    if (Range1->First != Range2->First) {
+        return (Range1->First < Range2->First) ? -1 : 1;
+    }
+    return 0;
+}
+
+/**
+ * Function: TokenizeError
+ *
+ * Displays CmdLineTokenize() error, named as for argument errors
+ **/
+STATIC VOID TokenizeError(
+  IN SHELL_STATUS   ShellStatus,    // status from CmdLineTokenize()
+  IN CONST CHAR16   *CmdName,       // name used in place of the program name; NULL if none
+  IN UINTN          Argc,           // number of arguments split before the error
+  IN CHAR16         **Argv,         // arguments split before the error
+  IN UINTN          MaxArgs         // number of entries in Argv
+  )
+{
+    CONST CHAR16 *ProgName = CmdName ? CmdName : g_ProgName;
+    if (!ProgName) {
+        ProgName = Argc ? GetFileName(Argv[0]) : L"";
+    }
+    if (ShellStatus == SHELL_BUFFER_TOO_SMALL) {
+        ShellPrintEx(-1, -1, L"%H%s%N: Too many arguments, only %u allowed\r\n", ProgName, MaxArgs);
+    } else if (Argc) {
+        ShellPrintEx(-1, -1, L"%H%s%N: Missing closing quote - '%H%s%N'\r\n", ProgName, Argv[Argc - 1]);
+    }
+}
+
+/**
+ * Function: WidenArgv
+ *
+ * Converts an ASCII or UTF-8 argument vector to CHAR16, the vector and all of its strings
+ * are held in a single arena allocation
+ * Returns ptr to converted vector; NULL if out of memory
+ **/
+STATIC CHAR16** WidenArgv(
+  IN ARENA  *Arena,     // arena to allocate from
+  IN UINTN  Argc,       // number of entries in Argv
+  IN CHAR8  **Argv      // argument vector to convert
+  )
+{
+    // a char never takes more CHAR16s than bytes
+    UINTN Size = (Argc + 1) * sizeof(CHAR16 *);
+    for (UINTN i = 0; i < Argc; i++) {
+        Size += (AsciiStrLen(Argv[i]) + 1) * sizeof(CHAR16);
+    }
+    CHAR16 **WideArgv = ArenaAlloc(Arena, Size);
+    if (!WideArgv) {
+        return NULL;
+    }
+    CHAR16 *Dest = (CHAR16 *)&WideArgv[Argc + 1];
+    for (UINTN i = 0; i < Argc; i++) {
+        CONST CHAR8 *Src = Argv[i];
+        WideArgv[i] = Dest;
+        while (*Src) {
+            *Dest++ = DecodeUtf8Char(&Src);
+        }
+        *Dest++ = L'\0';
+    }
+    WideArgv[Argc] = NULL;
+    return WideArgv;
+}
+
+/**
+ * Function: DecodeUtf8Char
+ *
+ * Decodes a UTF-8 char and moves string past it; chars outside UCS-2 and invalid
+ * sequences are decoded as U+FFFD
+ * Returns decoded char
+ **/
+STATIC CHAR16 DecodeUtf8Char(
+  IN OUT CONST CHAR8 **String   // ptr to string ptr, at a non-zero byte
+  )
+{
+    CONST UINT8 *Str = (CONST UINT8 *)*String;
+    UINT32 Char = *Str++;
+    UINTN Follow = 0;
+    UINT32 Min = 0;
+
+    if (Char >= 0xF8) {
+        Char = 0xFFFD;      // not a UTF-8 byte
+    } else if (Char >= 0xF0) {
+        Char &= 0x07;
+        Follow = 3;
+        Min = 0x10000;
+    } else if (Char >= 0xE0) {
+        Char &= 0x0F;
+        Follow = 2;
+        Min = 0x800;
+    } else if (Char >= 0xC0) {
+        Char &= 0x1F;
+        Follow = 1;
+        Min = 0x80;
+    } else if (Char >= 0x80) {
+        Char = 0xFFFD;      // continuation byte without lead byte
+    }
+    for (; Follow; Follow--) {
+        if ((*Str & 0xC0) != 0x80) {
+            Char = 0xFFFD;  // truncated sequence, the byte is decoded next
+            break;
+        }
+        Char = (Char << 6) | (*Str++ & 0x3F);
+    }
+    if ((Char < Min) || (Char > 0xFFFF) || ((Char >= 0xD800) && (Char <= 0xDFFF))) {
+        Char = 0xFFFD;      // overlong, surrogate or outside UCS-2
+    }
+    *String = (CONST CHAR8 *)Str;
+    return (CHAR16)Char;
+}
+
+/**
+ * Function: WidenArg
+ *
+ * Converts an ASCII or UTF-8 argument to CHAR16 held in the arena, for values handed out as
+ * CHAR16 strings and for error messages
+ * Returns ptr to converted argument; NULL if out of memory
+ **/
+STATIC CHAR16* WidenArg(
+  IN ARENA          *Arena,     // arena to allocate from
+  IN CONST CHAR8    *Arg        // argument to convert
+  )
+{
+    // a char never takes more CHAR16s than bytes
+    CHAR16 *WideArg = ArenaAlloc(Arena, (AsciiStrLen(Arg) + 1) * sizeof(CHAR16));
+    if (!WideArg) {
+        return NULL;
+    }
+    CHAR16 *Dest = WideArg;
+    while (*Arg) {
+        *Dest++ = DecodeUtf8Char(&Arg);
+    }
+    *Dest = L'\0';
+    return WideArg;
+}
+
+/**
+ * Function: ReadArgChar
+ *
+ * Reads a char of a CHAR16 or UTF-8 argument and moves past it, a UTF-8 char is decoded; the
+ * terminator is read without moving past it
+ * Returns char read
+ **/
+STATIC CHAR16 ReadArgChar(
+  IN OUT CONST VOID **Arg,      // ptr to argument ptr
+  IN BOOLEAN        Narrow      // TRUE if argument is UTF-8 rather than CHAR16
+  )
+{
+    if (!Narrow) {
+        CONST CHAR16 *Ptr = *Arg;
+        if (*Ptr != L'\0') {
+            *Arg = Ptr + 1;
+        }
+        return *Ptr;
+    }
+    CONST CHAR8 *Ptr = *Arg;
+    if ((UINT8)*Ptr < 0x80) {
+        if (*Ptr != '\0') {
+            *Arg = Ptr + 1;
+        }
+        return (CHAR16)*Ptr;
+    }
+    CHAR16 Char = DecodeUtf8Char(&Ptr);
+    *Arg = Ptr;
+    return Char;
+}
+
+/**
+ * Function: ArgStrLen
+ *
+ * Counts the chars of a CHAR16 or UTF-8 argument up to its end or a stop char
+ * Returns number of chars
+ **/
+STATIC UINTN ArgStrLen(
+  IN CONST VOID     *Arg,       // argument
+  IN BOOLEAN        Narrow,     // TRUE if argument is UTF-8 rather than CHAR16
+  IN CHAR16         Stop,       // char that also ends the argument; L'\0' if none
+  OUT CONST VOID    **End OPTIONAL // ptr to return ptr to the terminator or stop char
+  )
+{
+    UINTN Len = 0;
+    for (;;) {
+        CONST VOID *Next = Arg;
+        CHAR16 Char = ReadArgChar(&Next, Narrow);
+        if ((Char == L'\0') || (Char == Stop)) {
+            break;
+        }
+        Arg = Next;
+        Len++;
+    }
+    if (End) {
+        *End = Arg;
+    }
+    return Len;
+}
+
+/**
+ * Function: DecodeUtf8Str
+ *
+ * Converts a UTF-8 string to CHAR16, as much as fits
+ * Returns EFI_BUFFER_TOO_SMALL if truncated
+ **/
+STATIC EFI_STATUS DecodeUtf8Str(
+  IN CONST CHAR8    *Source,    // string to convert
+  OUT CHAR16        *Dest,      // ptr to buffer for converted string
+  IN UINTN          DestSize    // size of buffer in chars, including terminator
+  )
+{
+    UINTN Count = 0;
+    while ((*Source != '\0') && (Count + 1 < DestSize)) {
+        Dest[Count++] = DecodeUtf8Char(&Source);
+    }
+    Dest[Count] = L'\0';
+    return (*Source != '\0') ? EFI_BUFFER_TOO_SMALL : EFI_SUCCESS;
+}
+
+/**
+ * Function: CopyAsciiStr
+ *
+ * Copies an ASCII string, as much as fits, checking every char is ASCII; as CmdLineNarrowStr()
+ * for a UTF-8 source, which is rejected if it has any multi-byte char
+ * Returns EFI_INVALID_PARAMETER if not ASCII or EFI_BUFFER_TOO_SMALL if truncated
+ **/
+STATIC EFI_STATUS CopyAsciiStr(
+  IN CONST CHAR8    *Source,    // string to copy
+  OUT CHAR8         *Dest,      // ptr to buffer for copy
+  IN UINTN          DestSize    // size of buffer, including terminator
+  )
+{
+    UINTN Room = DestSize - 1;
+    UINTN Count = 0;
+    for (; Source[Count] != '\0'; Count++) {
+        if ((UINT8)Source[Count] > 0x7F) {
+            Dest[MIN(Count, Room)] = '\0';
+            return EFI_INVALID_PARAMETER;
+        }
+        if (Count < Room) {
+            Dest[Count] = Source[Count];
+        }
+    }
+    Dest[MIN(Count, Room)] = '\0';
+    return (Count > Room) ? EFI_BUFFER_TOO_SMALL : EFI_SUCCESS;
+}
+
+/**
+ * Function: ArenaAlloc
+ *
+ * Allocates memory from arena, a new chunk is started when the current one is full
+ * Returns ptr to memory; NULL if out of memory
+ **/
+STATIC VOID* ArenaAlloc(
+  IN OUT ARENA  *Arena,     // arena to allocate from
+  IN UINTN      Size        // bytes required
+  )
+{
+    Size = ARENA_ALIGN(Size);
+    ARENA_CHUNK *Chunk = Arena->Chunk;
+    if (!Chunk || (Chunk->Size - Chunk->Used < Size)) {
+        UINTN ChunkSize = MAX(ARENA_CHUNK_SIZE, Size);
+        Chunk = AllocatePool(ARENA_ALIGN(sizeof(ARENA_CHUNK)) + ChunkSize);
+        if (!Chunk) {
+            return NULL;
+        }
+        Chunk->Next = Arena->Chunk;
+        Chunk->Size = ChunkSize;
+        Chunk->Used = 0;
+        Arena->Chunk = Chunk;
+    }
+    VOID *Ptr = CHUNK_DATA(Chunk) + Chunk->Used;
+    Chunk->Used += Size;
+    Arena->Last = Ptr;
+    return Ptr;
+}
+
+/**
+ * Function: ArenaGrow
+ *
+ * Grows an arena allocation, in place if it is the most recent allocation and there is room
+ * left in the chunk, otherwise by copying to a new allocation
+ * Returns ptr to memory; NULL if out of memory
+ **/
+STATIC VOID* ArenaGrow(
+  IN OUT ARENA  *Arena,     // arena allocated from
+  IN VOID       *Ptr,       // ptr to current allocation; NULL if none
+  IN UINTN      OldSize,    // bytes in current allocation
+  IN UINTN      NewSize     // bytes required
+  )
+{
+    if (Ptr && (Ptr == Arena->Last)) {
+        ARENA_CHUNK *Chunk = Arena->Chunk;
+        UINTN Offset = (UINT8 *)Ptr - CHUNK_DATA(Chunk);
+        if (Chunk->Size - Offset >= ARENA_ALIGN(NewSize)) {
+            Chunk->Used = Offset + ARENA_ALIGN(NewSize);
+            return Ptr;
+        }
+    }
+    VOID *NewPtr = ArenaAlloc(Arena, NewSize);
+    if (NewPtr && Ptr) {
+        CopyMem(NewPtr, Ptr, OldSize);
+    }
+    return NewPtr;
+}
+
+/**
+ * Function: ArenaMove
+ *
+ * Moves all allocations from one arena to another
+ **/
+STATIC VOID ArenaMove(
+  IN OUT ARENA  *Dest,      // arena to take allocations
+  IN OUT ARENA  *Src        // arena to give allocations, left empty
+  )
+{
+    if (!Src->Chunk) {
+        return;
+    }
+    ARENA_CHUNK *Tail = Src->Chunk;
+    while (Tail->Next) {
+        Tail = Tail->Next;
+    }
+    Tail->Next = Dest->Chunk;
+    Dest->Chunk = Src->Chunk;
+    Dest->Last = NULL;
+    Src->Chunk = NULL;
+    Src->Last = NULL;
+}
+
+/**
+ * Function: ArenaFree
+ *
+ * Releases all memory held by an arena
+ **/
+STATIC VOID ArenaFree(
+  IN OUT ARENA  *Arena      // arena to free
+  )
+{
+    while (Arena->Chunk) {
+        ARENA_CHUNK *Chunk = Arena->Chunk;
+        Arena->Chunk = Chunk->Next;
+        FreePool(Chunk);
+    }
+    Arena->Last = NULL;
+}
+
+/**
+ * Function: ParseInteger
+ *
+ * Validates and converts an integer string in one pass; leading whitespace and zeros are
+ * skipped and at least one digit is required. Decimal and integer (decimal or '0x' prefixed
+ * hex) values are unsigned, hex values may have a '0x' prefix and signed values are integers
+ * with an optional '+' or '-'. Range is checked against the size of the value as it is
+ * converted.
+ * Returns status of value, with signed values sign extended to 64 bits
+ **/
+STATIC VALUE_STATUS ParseInteger(
+  IN CONST VOID     *String,        // ptr to value string
+  IN BOOLEAN        Narrow,         // TRUE if string is UTF-8 rather than CHAR16
+  IN VALUE_TYPE     ValueType,      // type of value
+  IN VALUE_SIZE     ValSize,        // size of value
+  OUT UINT64        *Value          // converted value
+  )
+{
+    UINTN Bits;
+    VALUE_STATUS InvalidStatus;
+    VALUE_STATUS RangeStatus;
+
+    switch (ValSize) {
+    case SIZEN:  Bits = sizeof(UINTN) * 8; break;
+    case SIZE8:  Bits = 8; break;
+    case SIZE16: Bits = 16; break;
+    case SIZE32: Bits = 32; break;
+    case SIZE64: Bits = 64; break;
+    default:
+        ShellPrintEx(-1, -1, L"ERROR: Invalid decimal size\r\n");
+        return VAL_UNSUPPORTED_SIZE;
+    }
+    switch (ValueType) {
+    case VALTYPE_DECIMAL:     InvalidStatus = VAL_DEC_INVALID; break;
+    case VALTYPE_HEXIDECIMAL: InvalidStatus = VAL_HEX_INVALID; break;
+    case VALTYPE_INTEGER:     InvalidStatus = VAL_INT_INVALID; break;
+    case VALTYPE_SIGNED:      InvalidStatus = VAL_SINT_INVALID; break;
+    default:
+        return VAL_UNSUPPORTED_TYPE;
+    }
+    BOOLEAN Signed = (ValueType == VALTYPE_SIGNED);
+    switch (Bits) {
+    case 8:  RangeStatus = Signed ? VAL_INT8_OUT_OF_RANGE : VAL_UINT8_TOO_BIG; break;
+    case 16: RangeStatus = Signed ? VAL_INT16_OUT_OF_RANGE : VAL_UINT16_TOO_BIG; break;
+    case 32: RangeStatus = Signed ? VAL_INT32_OUT_OF_RANGE : VAL_UINT32_TOO_BIG; break;
+    default: RangeStatus = Signed ? VAL_INT64_OUT_OF_RANGE : VAL_UINT64_TOO_BIG; break;
+    }
+
+    UINTN i = 0;
+    while ((ARG_CHAR(String, Narrow, i) == L' ') || (ARG_CHAR(String, Narrow, i) == L'\t')) {
+        i++;
+    }
+    CHAR16 Char = ARG_CHAR(String, Narrow, i);
+    BOOLEAN Negative = FALSE;
+    if (Signed && ((Char == L'-') || (Char == L'+'))) {
+        Negative = (Char == L'-');
+        i++;
+    }
+    BOOLEAN Digits = FALSE;
+    while (ARG_CHAR(String, Narrow, i) == L'0') {
+        Digits = TRUE;
+        i++;
+    }
+    BOOLEAN Hex = (ValueType == VALTYPE_HEXIDECIMAL);
+    if (CharToUpper(ARG_CHAR(String, Narrow, i)) == L'X') {
+        if (!Digits || (ValueType == VALTYPE_DECIMAL)) {
+            return InvalidStatus;
+        }
+        Hex = TRUE;
+        Digits = FALSE;
+        i++;
+    }
+
+    // largest magnitude allowed for size
+    UINT64 Limit = (Bits == 64) ? MAX_UINT64 : LShiftU64(1, Bits) - 1;
+    if (Signed) {
+        Limit = RShiftU64(Limit, 1) + (Negative ? 1 : 0);
+    }
+    UINT64 Magnitude = 0;
+    BOOLEAN OutOfRange = FALSE;
+    for (; (Char = ARG_CHAR(String, Narrow, i)) != L'\0'; i++) {
+        UINTN Digit;
+        if ((Char >= L'0') && (Char <= L'9')) {
+            Digit = Char - L'0';
+        } else if (Hex && (CharToUpper(Char) >= L'A') && (CharToUpper(Char) <= L'F')) {
+            Digit = CharToUpper(Char) - L'A' + 10;
+        } else {
+            return InvalidStatus;
+        }
+        Digits = TRUE;
+        if (OutOfRange) {
+            continue; // keep validating
+        }
+        if (Hex) {
+            OutOfRange = (RShiftU64(Magnitude, 60) != 0);
+            Magnitude = LShiftU64(Magnitude, 4) + Digit;
+        } else {
+            OutOfRange = (Magnitude > 0x1999999999999999ULL) || ((Magnitude == 0x1999999999999999ULL) && (Digit > 5));
+            Magnitude = MultU64x32(Magnitude, 10) + Digit;
+        }
+        OutOfRange = OutOfRange || (Magnitude > Limit);
+    }
+    if (!Digits) {
+        return InvalidStatus;
+    }
+    if (OutOfRange) {
+        return RangeStatus;
+    }
+    *Value = Negative ? (0 - Magnitude) : Magnitude;
+    return VAL_OK;
+}
+
+/**
+ * Function: ProcessIntVal
+ *
+ * Stores integer, already range checked by ParseInteger(), in the return ptr; signed
+ * values are stored through the unsigned member of the same size
+ * Returns status of value
+ **/
+STATIC VALUE_STATUS ProcessIntVal(
+  IN UINT64         Value,          // integer value
+  IN VALUE_SIZE     ValSize,        // size of integer
   OUT VALUE_RET_PTR ValueRetPtr     // ptr to store converted value
   )
 {
-    UINTN Value;
-    UINTN srcLen, dstLen;
-    VALUE_STATUS ValStatus;
-    
-    if ( !String || (!ValueRetPtr.pVoid) ) {
-        return VAL_ERROR;
+    switch (ValSize) {
+    case SIZEN:
+        *ValueRetPtr.pUintn = (UINTN)Value;
+        break;
+    case SIZE8:
+        *ValueRetPtr.pUint8 = (UINT8)Value;
+        break;
+    case SIZE16:
+        *ValueRetPtr.pUint16 = (UINT16)Value;
+        break;
+    case SIZE32:
+        *ValueRetPtr.pUint32 = (UINT32)Value;
+        break;
+    case SIZE64:
+        *ValueRetPtr.pUint64 = Value;
+        break;
+    default:
+        ShellPrintEx(-1, -1, L"ERROR: Invalid decimal size\r\n");
+        return VAL_UNSUPPORTED_SIZE;
+    }
+    return VAL_OK;
+}
+
+/**
+ * Function: ParseUnitValue
+ *
+ * Validates and converts a size, time or frequency string in one pass, a decimal number with
+ * an optional fraction followed by an optional unit suffix, e.g. '4K', '1.5G', '250us' or
+ * '2.4GHz', or a '0x' prefixed hex whole number with no suffix, so '0x1B' is 27 bytes rather
+ * than 1 with a 'B' suffix. The '0x' prefix is detected first. Values are scaled with integer math to
+ * bytes, nanoseconds or hertz and must come to a whole number of them, up to 18 fraction
+ * digits are used. Range is checked against the size of the value.
+ * Returns status of value
+ **/
+STATIC VALUE_STATUS ParseUnitValue(
+  IN CONST VOID     *String,        // ptr to value string
+  IN BOOLEAN        Narrow,         // TRUE if string is UTF-8 rather than CHAR16
+  IN VALUE_TYPE     ValueType,      // type of value
+  IN VALUE_SIZE     ValSize,        // size of value
+  OUT UINT64        *Value          // converted value
+  )
+{
+    UINTN Bits;
+    CONST UNIT_SUFFIX *Unit;
+    VALUE_STATUS InvalidStatus;
+    VALUE_STATUS RangeStatus;
+
+    switch (ValSize) {
+    case SIZEN:  Bits = sizeof(UINTN) * 8; break;
+    case SIZE8:  Bits = 8; break;
+    case SIZE16: Bits = 16; break;
+    case SIZE32: Bits = 32; break;
+    case SIZE64: Bits = 64; break;
+    default:
+        ShellPrintEx(-1, -1, L"ERROR: Invalid decimal size\r\n");
+        return VAL_UNSUPPORTED_SIZE;
+    }
+    switch (ValueType) {
+    case VALTYPE_SIZE: Unit = g_SizeUnits; InvalidStatus = VAL_SIZE_INVALID; break;
+    case VALTYPE_TIME: Unit = g_TimeUnits; InvalidStatus = VAL_TIME_INVALID; break;
+    case VALTYPE_FREQ: Unit = g_FreqUnits; InvalidStatus = VAL_FREQ_INVALID; break;
+    default:
+        return VAL_UNSUPPORTED_TYPE;
+    }
+    switch (Bits) {
+    case 8:  RangeStatus = VAL_UINT8_TOO_BIG; break;
+    case 16: RangeStatus = VAL_UINT16_TOO_BIG; break;
+    case 32: RangeStatus = VAL_UINT32_TOO_BIG; break;
+    default: RangeStatus = VAL_UINT64_TOO_BIG; break;
+    }
+
+    UINTN i = 0;
+    while ((ARG_CHAR(String, Narrow, i) == L' ') || (ARG_CHAR(String, Narrow, i) == L'\t')) {
+        i++;
+    }
+    BOOLEAN Hex = (ARG_CHAR(String, Narrow, i) == L'0') && (CharToUpper(ARG_CHAR(String, Narrow, i + 1)) == L'X');
+    if (Hex) {
+        i += 2;
+    }
+
+    // whole number
+    CHAR16 Char;
+    UINT64 Whole = 0;
+    BOOLEAN Digits = FALSE;
+    BOOLEAN OutOfRange = FALSE;
+    for (; (Char = ARG_CHAR(String, Narrow, i)) != L'\0'; i++) {
+        UINTN Digit;
+        if ((Char >= L'0') && (Char <= L'9')) {
+            Digit = Char - L'0';
+        } else if (Hex && (CharToUpper(Char) >= L'A') && (CharToUpper(Char) <= L'F')) {
+            Digit = CharToUpper(Char) - L'A' + 10;
+        } else {
+            break;
+        }
+        Digits = TRUE;
+        if (OutOfRange) {
+            continue; // keep validating
+        }
+        if (Hex) {
+            OutOfRange = (RShiftU64(Whole, 60) != 0);
+            Whole = LShiftU64(Whole, 4) + Digit;
+        } else {
+            OutOfRange = (Whole > 0x1999999999999999ULL) || ((Whole == 0x1999999999999999ULL) && (Digit > 5));
+            Whole = MultU64x32(Whole, 10) + Digit;
+        }
+    }
+
+    // fraction, held as Frac / Scale
+    UINT64 Frac = 0;
+    UINT64 Scale = 1;
+    BOOLEAN Inexact = FALSE;
+    if (!Hex && (Char == L'.')) {
+        for (i++; ((Char = ARG_CHAR(String, Narrow, i)) >= L'0') && (Char <= L'9'); i++) {
+            Digits = TRUE;
+            if (Scale < UNIT_FRAC_MAX_SCALE) {
+                Frac = MultU64x32(Frac, 10) + (Char - L'0');
+                Scale = MultU64x32(Scale, 10);
+            } else if (Char != L'0') {
+                Inexact = TRUE;
+            }
+        }
+    }
+    if (!Digits) {
+        return InvalidStatus;
+    }
+
+    // unit suffix; a hex number is all digits, so anything after it is invalid
+    if (Hex && (Char != L'\0')) {
+        return InvalidStatus;
+    }
+    CONST VOID *Suffix = ARG_PTR(String, Narrow, i);
+    UINTN Len = ArgStrLen(Suffix, Narrow, L'\0', NULL);
+    while (Unit->Suffix && ((Unit->Len != Len) || !ArgStrniEqual(Unit->Suffix, Suffix, Narrow, Len))) {
+        Unit++;
+    }
+    if (!Unit->Suffix) {
+        return InvalidStatus;
+    }
+    if (Inexact) {
+        return VAL_UNIT_INEXACT;
+    }
+    if (OutOfRange || ((Unit->Multiplier > 1) && (Whole > DivU64x64Remainder(MAX_UINT64, Unit->Multiplier, NULL)))) {
+        return RangeStatus;
+    }
+    UINT64 Total = MultU64x64(Whole, Unit->Multiplier);
+
+    // scale fraction; in lowest terms, Scale must divide the multiplier for a whole number
+    if (Frac) {
+        while (!(Frac & 1) && !(Scale & 1)) {
+            Frac = RShiftU64(Frac, 1);
+            Scale = RShiftU64(Scale, 1);
+        }
+        for (;;) {
+            UINT32 FracRem;
+            UINT32 ScaleRem;
+            UINT64 Frac5 = DivU64x32Remainder(Frac, 5, &FracRem);
+            UINT64 Scale5 = DivU64x32Remainder(Scale, 5, &ScaleRem);
+            if (FracRem || ScaleRem) {
+                break;
+            }
+            Frac = Frac5;
+            Scale = Scale5;
+        }
+        UINT64 Rem;
+        UINT64 PerFrac = DivU64x64Remainder(Unit->Multiplier, Scale, &Rem);
+        if (Rem) {
+            return VAL_UNIT_INEXACT;
+        }
+        if (Frac > DivU64x64Remainder(MAX_UINT64 - Total, PerFrac, NULL)) {
+            return RangeStatus;
+        }
+        Total += MultU64x64(Frac, PerFrac);
+    }
+
+    if ((Bits < 64) && (RShiftU64(Total, Bits) != 0)) {
+        return RangeStatus;
+    }
+    *Value = Total;
+    return VAL_OK;
+}
+
+/**
+ * Function: IsNegativeNumber
+ *
+ * Returns TRUE if string is a '-' followed by a decimal digit
+ **/
+STATIC BOOLEAN IsNegativeNumber(
+  IN CONST VOID *String,    // string to check
+  IN BOOLEAN    Narrow      // TRUE if string is UTF-8 rather than CHAR16
+  )
+{
+    return (ARG_CHAR(String, Narrow, 0) == L'-') && (ARG_CHAR(String, Narrow, 1) >= L'0') && (ARG_CHAR(String, Narrow, 1) <= L'9');
+}
+
+/**
+ * Function: GetEnumVal
+ * 
+ * Gets value associated with an enum entry
+ * Returns TRUE if successful
+ **/
+STATIC BOOLEAN GetEnumVal(
+  IN ENUM_STR_ARRAY *EnumStrArray,      // enum to string array
+  IN CONST VOID     *Str,               // enum string
+  IN BOOLEAN        Narrow,             // TRUE if string is UTF-8 rather than CHAR16
+  OUT UINTN         *Value              // associated value
+  )
+{
+    UINTN Len = ArgStrLen(Str, Narrow, L'\0', NULL);
+    for (UINTN i = 0; EnumStrArray[i].Str; i++) {
+        if ((StrLen(EnumStrArray[i].Str) == Len) && ArgStrniEqual(EnumStrArray[i].Str, Str, Narrow, Len)) {
+            if (Value) {
+                *Value = EnumStrArray[i].Value;
+            }
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+/**
+ * Function: CompileEnumIndex
+ *
+ * Creates enum index for a parameter or switch with a large enum array
+ * Returns SHELL_SUCCESS, with NULL index if not required
+ **/
+STATIC SHELL_STATUS CompileEnumIndex(
+  IN VALUE_TYPE             ValueType,  // type of value
+  IN DATA                   *Data,      // ptr to misc data for value
+  OUT CMDLINE_ENUM_INDEX    **EnumIndex // ptr to return enum index
+  )
+{
+    *EnumIndex = NULL;
+    if (((ValueType != VALTYPE_ENUM) && (ValueType != VALTYPE_ENUM_SET)) || !Data->EnumStrArray) {
+        return SHELL_SUCCESS;
+    }
+    UINTN Count = 0;
+    while (Data->EnumStrArray[Count].Str && (Count < ENUM_INDEX_MIN_ENTRIES)) {
+        Count++;
+    }
+    if (Count < ENUM_INDEX_MIN_ENTRIES) {
+        return SHELL_SUCCESS;
+    }
+    return CmdLineEnumIndexCreate(Data->EnumStrArray, EnumIndex);
+}
+
+/**
+ * CmdLineEnumIndexCreate()
+ *
+ * Strings are hashed into a STR_INDEX. Values are found in a dense table indexed by value when
+ * the values span less than four times the number of entries (range < Count * 4), so the table
+ * costs at most four UINTNs an entry; otherwise the array indices are sorted by value and found
+ * by binary search
+ **/
+SHELL_STATUS CmdLineEnumIndexCreate(
+  IN ENUM_STR_ARRAY         *EnumStrArray,
+  OUT CMDLINE_ENUM_INDEX    **EnumIndex
+  )
+{
+    if (!EnumStrArray || !EnumIndex) {
+        return SHELL_INVALID_PARAMETER;
+    }
+    *EnumIndex = NULL;
+
+    CMDLINE_ENUM_INDEX *NewIndex = AllocateZeroPool(sizeof(CMDLINE_ENUM_INDEX));
+    if (!NewIndex) {
+        return SHELL_OUT_OF_RESOURCES;
+    }
+    NewIndex->EnumStrArray = EnumStrArray;
+    UINTN MaxValue = 0;
+    NewIndex->MinValue = MAX_UINTN;
+    while (EnumStrArray[NewIndex->Count].Str) {
+        UINTN Value = EnumStrArray[NewIndex->Count].Value;
+        NewIndex->MinValue = MIN(NewIndex->MinValue, Value);
+        MaxValue = MAX(MaxValue, Value);
+        NewIndex->Count++;
+    }
+    UINTN Count = NewIndex->Count;
+
+    // strings, the first entry wins if a string appears more than once as with GetEnumVal()
+    if (EFI_ERROR(StrIndexInit(&NewIndex->StrIndex, Count))) {
+        goto Error_exit;
+    }
+    for (UINTN i = 0; i < Count; i++) {
+        StrIndexAdd(&NewIndex->StrIndex, EnumStrArray[i].Str, i);
+    }
+
+    // values, the first entry wins if a value appears more than once
+    if (Count && (MaxValue - NewIndex->MinValue < Count * 4)) {
+        NewIndex->DenseSize = MaxValue - NewIndex->MinValue + 1;
+        NewIndex->ByValue = AllocateZeroPool(NewIndex->DenseSize * sizeof(UINTN));
+        if (!NewIndex->ByValue) {
+            goto Error_exit;
+        }
+        for (UINTN i = Count; i > 0; i--) {
+            NewIndex->ByValue[EnumStrArray[i-1].Value - NewIndex->MinValue] = i;
+        }
+    } else if (Count) {
+        ENUM_VALUE_PAIR *Sorted = AllocatePool(Count * sizeof(ENUM_VALUE_PAIR));
+        NewIndex->ByValue = AllocatePool(Count * sizeof(UINTN));
+        if (!Sorted || !NewIndex->ByValue) {
+            if (Sorted) {
+                FreePool(Sorted);
+            }
+            goto Error_exit;
+        }
+        // sort (value, array index) pairs so equal values keep array order
+        ENUM_VALUE_PAIR Temp;
+        for (UINTN i = 0; i < Count; i++) {
+            Sorted[i].Value = EnumStrArray[i].Value;
+            Sorted[i].Index = i;
+        }
+        QuickSort(Sorted, Count, sizeof(ENUM_VALUE_PAIR), CompareEnumValue, &Temp);
+        for (UINTN i = 0; i < Count; i++) {
+            NewIndex->ByValue[i] = Sorted[i].Index;
+        }
+        FreePool(Sorted);
+    }
+
+    *EnumIndex = NewIndex;
+    return SHELL_SUCCESS;
+
+Error_exit:
+    CmdLineEnumIndexFree(NewIndex);
+    return SHELL_OUT_OF_RESOURCES;
+}
+
+/**
+ * Function: CompareEnumValue
+ *
+ * QuickSort() compare of (value, array index) pairs
+ * Returns <0, 0 or >0 as for StrCmp()
+ **/
+STATIC INTN EFIAPI CompareEnumValue(
+  IN CONST VOID *Buffer1,   // first pair
+  IN CONST VOID *Buffer2    // second pair
+  )
+{
+    CONST ENUM_VALUE_PAIR *Pair1 = Buffer1;
+    CONST ENUM_VALUE_PAIR *Pair2 = Buffer2;
+
+    if (Pair1->Value != Pair2->Value) {
+        return (Pair1->Value < Pair2->Value) ? -1 : 1;
     }
+    return (Pair1->Index < Pair2->Index) ? -1 : (Pair1->Index > Pair2->Index);
+}
 
-    switch (ValueType) {
-    case VALTYPE_STRING:
-        StrnCpyS(ValueRetPtr.pChar16, Data->MaxStrSize, String, Data->MaxStrSize-1);
-        if (StrLen(String) > Data->MaxStrSize-1) {
-            return VAL_STR_TRUNCATED;
+/**
+ * CmdLineEnumIndexFind()
+ * 
+ **/
+BOOLEAN CmdLineEnumIndexFind(
+  IN CONST CMDLINE_ENUM_INDEX   *EnumIndex,
+  IN CONST CHAR16               *Str,
+  OUT UINTN                     *Value OPTIONAL
+  )
+{
+    return FindEnumIndex(EnumIndex, Str, FALSE, Value);
+}
+
+/**
+ * Function: FindEnumIndex
+ *
+ * Looks up an enum string in an enum index
+ * Returns TRUE if found
+ **/
+STATIC BOOLEAN FindEnumIndex(
+  IN CONST CMDLINE_ENUM_INDEX   *EnumIndex, // enum index
+  IN CONST VOID                 *Str,       // enum string
+  IN BOOLEAN                    Narrow,     // TRUE if string is UTF-8 rather than CHAR16
+  OUT UINTN                     *Value OPTIONAL // associated value
+  )
+{
+    CONST STR_INDEX_KEY *Key = StrIndexFind(&EnumIndex->StrIndex, Str, Narrow, L'\0');
+    if (!Key) {
+        return FALSE;
+    }
+    if (Value) {
+        *Value = EnumIndex->EnumStrArray[Key->Id].Value;
+    }
+    return TRUE;
+}
+
+/**
+ * CmdLineEnumIndexName()
+ * 
+ **/
+CONST CHAR16* CmdLineEnumIndexName(
+  IN CONST CMDLINE_ENUM_INDEX   *EnumIndex,
+  IN UINTN                      Value
+  )
+{
+    if (Value < EnumIndex->MinValue) {
+        return NULL;
+    }
+    if (EnumIndex->DenseSize) {
+        if (Value - EnumIndex->MinValue >= EnumIndex->DenseSize) {
+            return NULL;
         }
-        break;
-    case VALTYPE_ASCII_STRING:
-        srcLen = StrLen(String);
-        UnicodeStrnToAsciiStrS(String, srcLen, ValueRetPtr.pChar8, Data->MaxStrSize, &dstLen);
-        if (srcLen > Data->MaxStrSize-1) {
-            return VAL_STR_TRUNCATED;
+        UINTN Entry = EnumIndex->ByValue[Value - EnumIndex->MinValue];
+        return Entry ? EnumIndex->EnumStrArray[Entry - 1].Str : NULL;
+    }
+    // binary search for first entry with value
+    UINTN Low = 0;
+    UINTN High = EnumIndex->Count;
+    while (Low < High) {
+        UINTN Mid = Low + (High - Low) / 2;
+        if (EnumIndex->EnumStrArray[EnumIndex->ByValue[Mid]].Value < Value) {
+            Low = Mid + 1;
+        } else {
+            High = Mid;
         }
-        break;
-    case VALTYPE_DECIMAL:
-        if (!IsDecimalString(String)) {
-            return VAL_DEC_INVALID;
+    }
+    if ((Low < EnumIndex->Count) && (EnumIndex->EnumStrArray[EnumIndex->ByValue[Low]].Value == Value)) {
+        return EnumIndex->EnumStrArray[EnumIndex->ByValue[Low]].Str;
+    }
+    return NULL;
+}
+
+/**
+ * CmdLineEnumIndexFree()
+ * 
+ **/
+VOID CmdLineEnumIndexFree(
+  IN CMDLINE_ENUM_INDEX *EnumIndex OPTIONAL
+  )
+{
+    if (!EnumIndex) {
+        return;
+    }
+    StrIndexFree(&EnumIndex->StrIndex);
+    if (EnumIndex->ByValue) {
+        FreePool(EnumIndex->ByValue);
+    }
+    FreePool(EnumIndex);
+}
+
+/**
+ * CmdLineGenMatch()
+ * 
+ **/
+BOOLEAN CmdLineGenMatch(
+  IN CONST CHAR16   *Arg,
+  IN CONST CHAR16   *SwStr,
+  IN UINTN          Len
+  )
+{
+    return StrniEqual(Arg, SwStr, Len);
+}
+
+/**
+ * CmdLineGenInteger()
+ * 
+ **/
+BOOLEAN CmdLineGenInteger(
+  IN CONST CHAR16   *String,
+  IN VALUE_TYPE     ValueType,
+  IN VALUE_SIZE     ValSize,
+  OUT UINT64        *Value
+  )
+{
+    return ParseInteger(String, FALSE, ValueType, ValSize, Value) == VAL_OK;
+}
+
+/**
+ * Function: StriCmp
+ *
+ * Case insenitive unicode string compare, chars are only folded once they differ
+ * Returns value same as strcmp()
+ **/
+STATIC INTN EFIAPI StriCmp(
+  IN CONST CHAR16 *FirstString,     // first string
+  IN CONST CHAR16 *SecondString     // second string
+  )
+{
+    CHAR16  UpperFirstString;
+    CHAR16  UpperSecondString;
+
+    do {
+        while ((*FirstString == *SecondString) && (*FirstString != L'\0')) {
+            FirstString++;
+            SecondString++;
         }
-        Value = StrDecimalToUintn(String);
-        ValStatus = ProcessIntVal(Value, Data->ValSize, ValueRetPtr);
-        if (ValStatus != VAL_OK) {
-            return ValStatus;
+        UpperFirstString = CharToUpper(*FirstString);
+        UpperSecondString = CharToUpper(*SecondString);
+        FirstString++;
+        SecondString++;
+    } while ((UpperFirstString == UpperSecondString) && (UpperFirstString != L'\0'));
+
+    return UpperFirstString - UpperSecondString;
+}
+
+/**
+ * Function: FoldChar16x4
+ *
+ * Case folds four chars packed in a UINT64 as CharToUpper() does, 'a' to 'z' only
+ * Returns folded chars
+ **/
+STATIC UINT64 FoldChar16x4(
+  IN UINT64 Chars       // four chars
+  )
+{
+    // lanes are compared on their low 15 bits with the top bit used as the borrow guard,
+    // lanes with the top bit set are outside 'a' to 'z' and masked out
+    UINT64 Low15 = Chars & ~LANES_HIGH;
+    UINT64 GeA = ((Low15 | LANES_HIGH) - LANES_LOW * L'a');
+    UINT64 LeZ = ((LANES_LOW * L'z' | LANES_HIGH) - Low15);
+    UINT64 Lower = GeA & LeZ & ~Chars & LANES_HIGH;
+    return Chars - (Lower >> 10);   // 0x8000 >> 10 == 'a' - 'A'
+}
+
+/**
+ * Function: StrniEqual
+ *
+ * Case insensitive compare of two strings of known equal length, four chars at a time
+ * Returns TRUE if equal
+ **/
+STATIC BOOLEAN StrniEqual(
+  IN CONST CHAR16   *FirstString,   // first string
+  IN CONST CHAR16   *SecondString,  // second string
+  IN UINTN          Len             // length of both strings
+  )
+{
+    for (; Len >= 4; Len -= 4) {
+        UINT64 First = ReadUnaligned64((CONST UINT64 *)FirstString);
+        UINT64 Second = ReadUnaligned64((CONST UINT64 *)SecondString);
+        if ((First != Second) && (FoldChar16x4(First) != FoldChar16x4(Second))) {
+            return FALSE;
         }
-        break;                
-    case VALTYPE_HEXIDECIMAL:
-        if (!IsHexString(String)) {
-            return VAL_HEX_INVALID;
+        FirstString += 4;
+        SecondString += 4;
+    }
+    for (; Len > 0; Len--) {
+        if ((*FirstString != *SecondString) && (CharToUpper(*FirstString) != CharToUpper(*SecondString))) {
+            return FALSE;
         }
-        Value = StrHexToUintn(String);
-        ValStatus = ProcessIntVal(Value, Data->ValSize, ValueRetPtr);
-        if (ValStatus != VAL_OK) {
-            return ValStatus;
+        FirstString++;
+        SecondString++;
+    }
+    return TRUE;
+}
+
+/**
+ * Function: ArgStrniEqual
+ *
+ * Case insensitive compare of a string with a CHAR16 or UTF-8 argument, both of known equal
+ * length in chars; a CHAR16 argument is compared four chars at a time
+ * Returns TRUE if equal
+ **/
+STATIC BOOLEAN ArgStrniEqual(
+  IN CONST CHAR16   *String,        // string
+  IN CONST VOID     *Arg,           // argument
+  IN BOOLEAN        Narrow,         // TRUE if argument is UTF-8 rather than CHAR16
+  IN UINTN          Len             // length of both in chars
+  )
+{
+    if (!Narrow) {
+        return StrniEqual(String, Arg, Len);
+    }
+    for (; Len > 0; Len--) {
+        CHAR16 Char = ReadArgChar(&Arg, TRUE);
+        if ((Char == L'\0') || ((Char != *String) && (CharToUpper(Char) != CharToUpper(*String)))) {
+            return FALSE;
         }
-        break;
-    case VALTYPE_INTEGER:
-        if (HasHexPrefix(String)) {
-            if (!IsHexString(String)) {
-                return VAL_INT_INVALID; // hex
+        String++;
+    }
+    return TRUE;
+}
+
+/**
+ * CmdLineNarrowStr()
+ * 
+ **/
+EFI_STATUS CmdLineNarrowStr(
+  IN CONST CHAR16   *Source,
+  OUT CHAR8         *Dest OPTIONAL,
+  IN UINTN          DestSize,
+  OUT UINTN         *Len OPTIONAL
+  )
+{
+    if (!Source || (!Dest && DestSize)) {
+        return EFI_INVALID_PARAMETER;
+    }
+    UINTN SrcLen = StrLen(Source);
+    UINTN Room = DestSize ? DestSize - 1 : 0;   // chars that fit before terminator
+    UINTN Count = 0;
+    EFI_STATUS Status = EFI_SUCCESS;
+
+    // four chars at a time while they are within the string and fit the destination,
+    // stopping at the word holding a non-ASCII char
+    UINTN WordEnd = MIN(SrcLen, Room);
+    while (Count + 4 <= WordEnd) {
+        UINT64 Chars = ReadUnaligned64((CONST UINT64 *)&Source[Count]);
+        if (Chars & LANES_NOT_ASCII) {
+            break;
+        }
+        // pack low bytes of the four (little endian) lanes
+        Chars = (Chars | RShiftU64(Chars, 8)) & 0x0000FFFF0000FFFFULL;
+        WriteUnaligned32((UINT32 *)&Dest[Count], (UINT32)(Chars | RShiftU64(Chars, 16)));
+        Count += 4;
+    }
+    // rest a char at a time, still validating chars that do not fit
+    for (; Count < SrcLen; Count++) {
+        if (Source[Count] > 0x7F) {
+            Status = EFI_INVALID_PARAMETER;
+            break;
+        }
+        if (Count < Room) {
+            Dest[Count] = (CHAR8)Source[Count];
+        }
+    }
+    if (DestSize) {
+        Dest[MIN(Count, Room)] = '\0';
+    }
+    if (Len) {
+        *Len = Count;
+    }
+    if (!EFI_ERROR(Status) && (Count > Room)) {
+        Status = EFI_BUFFER_TOO_SMALL;
+    }
+    return Status;
+}
+
+/**
+ * Function: HashFoldStr
+ *
+ * Case insensitive (FNV-1a) hash of a unicode string, folded the same way as StriCmp(); a UTF-8
+ * string is hashed by its decoded chars, so it hashes the same as its CHAR16 form
+ * Returns hash value and length of string in chars
+ **/
+STATIC UINT32 HashFoldStr(
+  IN CONST VOID   *String,  // string to hash
+  IN BOOLEAN      Narrow,   // TRUE if string is UTF-8 rather than CHAR16
+  IN CHAR16       Stop,     // char that also ends the string (e.g. ',' for list items); L'\0' if none
+  OUT UINTN       *Len      // length of string
+  )
+{
+    UINT32 Hash = 0x811C9DC5;
+
+    if (!Narrow) {
+        CONST CHAR16 *Ptr = String;
+        while ((*Ptr != L'\0') && (*Ptr != Stop)) {
+            Hash = (Hash ^ CharToUpper(*Ptr)) * 0x01000193;
+            Ptr++;
+        }
+        *Len = Ptr - (CONST CHAR16 *)String;
+        return Hash;
+    }
+    UINTN Count = 0;
+    for (;;) {
+        CHAR16 Char = ReadArgChar(&String, TRUE);
+        if ((Char == L'\0') || (Char == Stop)) {
+            break;
+        }
+        Hash = (Hash ^ CharToUpper(Char)) * 0x01000193;
+        Count++;
+    }
+    *Len = Count;
+    return Hash;
+}
+
+/**
+ * Function: StrIndexInit
+ *
+ * Allocates an empty string index large enough for 'Count' strings
+ * Returns EFI_OUT_OF_RESOURCES if memory could not be allocated or too many strings
+ **/
+STATIC EFI_STATUS StrIndexInit(
+  OUT STR_INDEX *Index,     // index to initialise
+  IN UINTN      Count       // number of strings to be added
+  )
+{
+    ZeroMem(Index, sizeof(STR_INDEX));
+    if (Count > STR_INDEX_MAX_KEYS) {
+        return EFI_OUT_OF_RESOURCES;
+    }
+    // keep load factor at or below 50%
+    UINTN Size = 8;
+    while (Size < Count * 2) {
+        Size <<= 1;
+    }
+    Index->Slots = AllocateZeroPool(Size * sizeof(STR_INDEX_SLOT));
+    Index->Keys = AllocatePool(MAX(Count, 1) * sizeof(STR_INDEX_KEY));
+    if (!Index->Slots || !Index->Keys) {
+        StrIndexFree(Index);
+        return EFI_OUT_OF_RESOURCES;
+    }
+    Index->Mask = Size - 1;
+    return EFI_SUCCESS;
+}
+
+/**
+ * Function: StrIndexFree
+ *
+ * Releases memory held by a string index
+ **/
+STATIC VOID StrIndexFree(
+  IN STR_INDEX *Index       // index to free
+  )
+{
+    if (Index->Slots) {
+        FreePool(Index->Slots);
+        Index->Slots = NULL;
+    }
+    if (Index->Keys) {
+        FreePool(Index->Keys);
+        Index->Keys = NULL;
+    }
+    Index->Mask = 0;
+    Index->KeyCount = 0;
+}
+
+/**
+ * Function: StrIndexAdd
+ *
+ * Adds string to index, the first string added wins if the same string (ignoring case) is added again
+ * Returns TRUE if added; FALSE if already present
+ **/
+STATIC BOOLEAN StrIndexAdd(
+  IN STR_INDEX      *Index, // index to add to
+  IN CONST CHAR16   *Str,   // string to add
+  IN UINTN          Id      // table index associated with string
+  )
+{
+    if (StrIndexFind(Index, Str, FALSE, L'\0')) {
+        return FALSE;
+    }
+    UINTN Len;
+    UINT32 Hash = HashFoldStr(Str, FALSE, L'\0', &Len);
+    UINTN i = Hash & Index->Mask;
+    while (Index->Slots[i].Key) {
+        i = (i + 1) & Index->Mask;
+    }
+    Index->Keys[Index->KeyCount].Str = Str;
+    Index->Keys[Index->KeyCount].Id = Id;
+    Index->KeyCount++;
+    Index->Slots[i].Hash = Hash;
+    Index->Slots[i].Len = (UINT16)Len;
+    Index->Slots[i].Key = (UINT16)Index->KeyCount;
+    return TRUE;
+}
+
+/**
+ * Function: StrIndexFind
+ *
+ * Looks up string (ignoring case) in index; slots are pre-rejected on length and hash before
+ * the string itself is read
+ * Returns ptr to matching key; NULL if not found
+ **/
+STATIC CONST STR_INDEX_KEY* StrIndexFind(
+  IN CONST STR_INDEX    *Index, // index to search
+  IN CONST VOID         *Str,   // string to find
+  IN BOOLEAN            Narrow, // TRUE if string is UTF-8 rather than CHAR16
+  IN CHAR16             Stop    // char that also ends the string; L'\0' if none
+  )
+{
+    if (!Index->Slots) {
+        return NULL;
+    }
+    UINTN Len;
+    UINT32 Hash = HashFoldStr(Str, Narrow, Stop, &Len);
+    UINTN i = Hash & Index->Mask;
+    while (Index->Slots[i].Key) {
+        CONST STR_INDEX_SLOT *Slot = &Index->Slots[i];
+        if ((Slot->Len == Len) && (Slot->Hash == Hash)) {
+            CONST STR_INDEX_KEY *Key = &Index->Keys[Slot->Key - 1];
+            if (ArgStrniEqual(Key->Str, Str, Narrow, Len)) {
+                return Key;
             }
-            Value = StrHexToUintn(String);
-        } else if (IsDecimalString(String)) {
-            Value = StrDecimalToUintn(String);
-        } else {
-            return VAL_INT_INVALID; // decimal
         }
-        ValStatus = ProcessIntVal(Value, Data->ValSize, ValueRetPtr);
-        if (ValStatus != VAL_OK) {
-            return ValStatus;
+        i = (i + 1) & Index->Mask;
+    }
+    return NULL;
+}
+
+/**
+ * Function: BuildSwitchIndex
+ *
+ * Builds hash index of built-in and table switch names; built-in switches take priority,
+ * followed by earlier table entries
+ * Returns EFI_OUT_OF_RESOURCES if memory could not be allocated
+ **/
+STATIC EFI_STATUS BuildSwitchIndex(
+  IN SWITCH_TABLE   *SwTable,   // ptr to switch table; may be NULL
+  IN UINTN          SwCount,    // number of entries in switch table
+  IN UINT16         FuncOpt,    // functional options
+  OUT STR_INDEX     *Index      // index to build
+  )
+{
+    EFI_STATUS Status = StrIndexInit(Index, SwCount * 2 + 4);
+    if (EFI_ERROR(Status)) {
+        return Status;
+    }
+    // break switch is always recognised, even if ignored due to NO_BREAK
+    StrIndexAdd(Index, g_BreakSwStr1, SWID_BREAK);
+    StrIndexAdd(Index, g_BreakSwStr2, SWID_BREAK);
+    if (!(FuncOpt & NO_HELP)) {
+        StrIndexAdd(Index, g_HelpSwStr1, SWID_HELP);
+        StrIndexAdd(Index, g_HelpSwStr2, SWID_HELP);
+    }
+    for (UINTN i = 0; i < SwCount; i++) {
+        if (SwTable[i].SwStr1) {
+            StrIndexAdd(Index, SwTable[i].SwStr1, i);
         }
-        break;
-    case VALTYPE_ENUM:
-        if(GetEnumVal(Data->EnumStrArray, String, &Value)) {
-            *ValueRetPtr.pEnum = (unsigned int)Value;
-        } else {
-            return VAL_OPT_INVALID;
+        if (SwTable[i].SwStr2) {
+            StrIndexAdd(Index, SwTable[i].SwStr2, i);
         }
-        break;
-    default:
-        return VAL_UNSUPPORTED_TYPE;
     }
-    
-    return VAL_OK;
+    return EFI_SUCCESS;
 }
 
 /**
- * Function: ProcessIntVal
+ * Function: ResolveSwitchList
+ *
+ * Finds the table switches named in a space separated list, ignoring case, and sets
+ * their bits in a switch bitset
+ * Returns FALSE if the list is empty or names an unknown switch
+ **/
+STATIC BOOLEAN ResolveSwitchList(
+  IN SWITCH_TABLE   *SwTable,   // ptr to switch table
+  IN UINTN          SwCount,    // number of switches in switch table
+  IN CONST CHAR16   *List,      // ptr to list of switch names; may be NULL
+  OUT UINTN         *Mask       // bitset to set switch bits in; NULL to only check the list
+  )
+{
+    BOOLEAN Found = FALSE;
+    while (List && *List) {
+        if (*List == L' ') {
+            List++;
+            continue;
+        }
+        UINTN Len = 0;
+        while (List[Len] && (List[Len] != L' ')) {
+            Len++;
+        }
+        UINTN i = 0;
+        for (; i < SwCount; i++) {
+            if ((SwTable[i].SwStr1 && (StrLen(SwTable[i].SwStr1) == Len) && StrniEqual(SwTable[i].SwStr1, List, Len))
+                || (SwTable[i].SwStr2 && (StrLen(SwTable[i].SwStr2) == Len) && StrniEqual(SwTable[i].SwStr2, List, Len))) {
+                break;
+            }
+        }
+        if (i == SwCount) {
+            return FALSE;
+        }
+        if (Mask) {
+            BITSET_SET(Mask, i);
+        }
+        Found = TRUE;
+        List += Len;
+    }
+    return Found;
+}
+
+/**
+ * Function: BuildSwitchTrie
  *
- * Check integer will fit into allocated size before storing it in the return ptr
- * Returns status of value
+ * Builds case-folded character trie of built-in and table switch names, in the same priority
+ * order as BuildSwitchIndex(); one node is allocated for every character so it never grows
+ * Returns EFI_OUT_OF_RESOURCES if memory could not be allocated
  **/
-STATIC VALUE_STATUS ProcessIntVal(
-  IN UINTN          Value,          // integer value
-  IN VALUE_SIZE     ValSize,        // size of integer
-  OUT VALUE_RET_PTR ValueRetPtr     // ptr to store converted value
+STATIC EFI_STATUS BuildSwitchTrie(
+  IN SWITCH_TABLE   *SwTable,   // ptr to switch table; may be NULL
+  IN UINTN          SwCount,    // number of entries in switch table
+  IN UINT16         FuncOpt,    // functional options
+  OUT TRIE_NODE     **Trie      // ptr to return trie
   )
 {
-    switch (ValSize) {
-    case SIZEN:
-        *ValueRetPtr.pUintn = Value;
-        break;
-    case SIZE8:
-        if (Value > MAX_UINT8) {
-            return VAL_UINT8_TOO_BIG;
-        }
-        *ValueRetPtr.pUint8 = (UINT8)Value;
-        break;
-    case SIZE16:
-        if (Value > MAX_UINT16) {
-            return VAL_UINT16_TOO_BIG;
+    UINTN MaxNodes = 1 + StrLen(g_BreakSwStr1) + StrLen(g_BreakSwStr2) + StrLen(g_HelpSwStr1) + StrLen(g_HelpSwStr2);
+    for (UINTN i = 0; i < SwCount; i++) {
+        MaxNodes += (SwTable[i].SwStr1 ? StrLen(SwTable[i].SwStr1) : 0) + (SwTable[i].SwStr2 ? StrLen(SwTable[i].SwStr2) : 0);
+    }
+    TRIE_NODE *Nodes = AllocateZeroPool(MaxNodes * sizeof(TRIE_NODE));
+    if (!Nodes) {
+        return EFI_OUT_OF_RESOURCES;
+    }
+    Nodes[0].Id = SWID_AMBIGUOUS;   // root, every switch is below it
+    UINTN NodeCount = 1;
+    TrieAdd(Nodes, &NodeCount, g_BreakSwStr1, SWID_BREAK);
+    TrieAdd(Nodes, &NodeCount, g_BreakSwStr2, SWID_BREAK);
+    if (!(FuncOpt & NO_HELP)) {
+        TrieAdd(Nodes, &NodeCount, g_HelpSwStr1, SWID_HELP);
+        TrieAdd(Nodes, &NodeCount, g_HelpSwStr2, SWID_HELP);
+    }
+    for (UINTN i = 0; i < SwCount; i++) {
+        if (SwTable[i].SwStr1) {
+            TrieAdd(Nodes, &NodeCount, SwTable[i].SwStr1, i);
         }
-        *ValueRetPtr.pUint16 = (UINT16)Value;
-        break;
-    case SIZE32:
-        if (Value > MAX_UINT32) {
-            return VAL_UINT32_TOO_BIG;
+        if (SwTable[i].SwStr2) {
+            TrieAdd(Nodes, &NodeCount, SwTable[i].SwStr2, i);
         }
-        *ValueRetPtr.pUint32 = (UINT32)Value;
-        break;
-    default:
-        ShellPrintEx(-1, -1, L"ERROR: Invalid decimal size\r\n");
-        return VAL_UNSUPPORTED_SIZE;
     }
-    return VAL_OK;
+    *Trie = Nodes;
+    return EFI_SUCCESS;
 }
 
 /**
- * Function: GetEnumVal
- * 
- * Gets value associated with an enum entry
- * Returns TRUE if successful
+ * Function: TrieAdd
+ *
+ * Adds switch name to trie, a name already present (ignoring case) is not added again
  **/
-STATIC BOOLEAN GetEnumVal(
-  IN ENUM_STR_ARRAY *EnumStrArray,      // enum to string array
-  IN CONST CHAR16   *Str,               // enum string
-  OUT UINTN         *Value              // associated value
+STATIC VOID TrieAdd(
+  IN OUT TRIE_NODE  *Trie,      // trie to add to
+  IN OUT UINTN      *NodeCount, // number of nodes in use
+  IN CONST CHAR16   *Str,       // switch name to add
+  IN UINTN          Id          // switch id
   )
 {
-    BOOLEAN found = FALSE;
-    UINTN i = 0;
-    while (EnumStrArray[i].Str) {
-        if (StriCmp(Str, EnumStrArray[i].Str) == 0) {
-            if (Value) {
-                *Value = EnumStrArray[i].Value;
+    UINTN Node = TrieWalk(Trie, Str, FALSE);
+    if (Node && Trie[Node].Term) {
+        return;
+    }
+    Node = 0;
+    for (CONST CHAR16 *Ptr = Str; *Ptr != L'\0'; Ptr++) {
+        CHAR16 c = CharToUpper(*Ptr);
+        UINTN Prev = 0;
+        UINTN Child = Trie[Node].Child;
+        while (Child && (Trie[Child].Char != c)) {
+            Prev = Child;
+            Child = Trie[Child].Sibling;
+        }
+        if (Child) {
+            if (Trie[Child].Id != Id) {
+                Trie[Child].Id = SWID_AMBIGUOUS;
+            }
+        } else {
+            // append new node to end of sibling list, keeping table order
+            Child = (*NodeCount)++;
+            Trie[Child].Char = c;
+            Trie[Child].Id = Id;
+            Trie[Child].Str = Str;
+            if (Prev) {
+                Trie[Prev].Sibling = (UINT32)Child;
+            } else {
+                Trie[Node].Child = (UINT32)Child;
             }
-            found = TRUE;
-            break;
         }
-        i++;
+        Node = Child;
     }
-    return found;
+    Trie[Node].Term = Str;
+    Trie[Node].TermId = Id;
 }
 
 /**
- * Function: StriCmp
+ * Function: TrieWalk
  *
- * Case insenitive unicode string compare
- * Returns value same as strcmp()
+ * Follows string (ignoring case) down the trie
+ * Returns index of node reached; 0 if string not in trie
  **/
-STATIC INTN EFIAPI StriCmp(
-  IN CONST CHAR16 *FirstString,     // first string
-  IN CONST CHAR16 *SecondString     // second string
+STATIC UINTN TrieWalk(
+  IN CONST TRIE_NODE    *Trie,  // trie to search
+  IN CONST VOID         *Str,   // string to follow
+  IN BOOLEAN            Narrow  // TRUE if string is UTF-8 rather than CHAR16
   )
 {
-    CHAR16  UpperFirstString;
-    CHAR16  UpperSecondString;
-
-    UpperFirstString = CharToUpper(*FirstString);
-    UpperSecondString = CharToUpper(*SecondString);
-    while ((*FirstString != L'\0') && (*SecondString != L'\0') && (UpperFirstString == UpperSecondString)) {
-        FirstString++;
-        SecondString++;
-        UpperFirstString = CharToUpper(*FirstString);
-        UpperSecondString = CharToUpper(*SecondString);
+    UINTN Node = 0;
+    CHAR16 Char;
+    while ((Char = ReadArgChar(&Str, Narrow)) != L'\0') {
+        CHAR16 c = CharToUpper(Char);
+        Node = Trie[Node].Child;
+        while (Node && (Trie[Node].Char != c)) {
+            Node = Trie[Node].Sibling;
+        }
+        if (!Node) {
+            return 0;
+        }
     }
-
-    return UpperFirstString - UpperSecondString;
+    return Node;
 }
 
 /**
- * Function: HasHexPrefix
+ * Function: PrintTrieNames
  *
- * Checks if string has hex prefix; '0x' or '0X'
- * Returns TRUE if pressent; FALSE if not or invalid char encountered
+ * Prints all switch names below a trie node
  **/
-STATIC BOOLEAN HasHexPrefix(
-  IN CONST CHAR16 *String   // string to check
+STATIC VOID PrintTrieNames(
+  IN CONST TRIE_NODE    *Trie,  // trie
+  IN UINTN              Node    // node to start from
   )
 {
-    BOOLEAN LeadingZero = FALSE;
-
-    while ((*String == L' ') || (*String == L'\t')) {
-        String++;
-    }
-    while (*String == L'0') {
-        LeadingZero = TRUE;
-        String++;
-    }
-    if (CharToUpper(*String) == L'X') {
-        if (!LeadingZero) {
-            return FALSE;
+    for (UINTN Child = Trie[Node].Child; Child; Child = Trie[Child].Sibling) {
+        if (Trie[Child].Term) {
+            ShellPrintEx(-1, -1, L" %s", Trie[Child].Term);
         }
-    } else {
-        return FALSE;
+        PrintTrieNames(Trie, Child);
     }
-    return TRUE;
 }
 
 /**
- * Function: IsHexString
+ * Function: LookupSwitch
  *
- * Returns TRUE if valid hexidecimal value
+ * Looks up switch name by hash or, if abbreviations are allowed, by walking the trie where an
+ * exact name match takes priority over a unique prefix
+ * Returns switch id; SWID_NONE if not found or SWID_AMBIGUOUS if prefix is not unique
  **/
-STATIC BOOLEAN IsHexString(
-  IN CONST CHAR16 *String   // string to check
+STATIC UINTN LookupSwitch(
+  IN CONST CMDLINE_PARSER   *Parser,    // ptr to parser
+  IN CONST VOID             *Arg,       // cmd line argument
+  IN BOOLEAN                Narrow,     // TRUE if argument is UTF-8 rather than CHAR16
+  OUT CONST CHAR16          **SwStr     // ptr to return matching switch name
   )
 {
-    BOOLEAN LeadingZero = FALSE;
-
-    while ((*String == L' ') || (*String == L'\t')) {
-        String++;
-    }
-    while (*String == L'0') {
-        LeadingZero = TRUE;
-        String++;
-    }
-    if (CharToUpper(*String) == L'X') {
-        if (!LeadingZero) {
-            return FALSE;
+    if (Parser->SwTrie) {
+        UINTN Node = TrieWalk(Parser->SwTrie, Arg, Narrow);
+        if (!Node) {
+            return SWID_NONE;
+        }
+        CONST TRIE_NODE *TrieNode = &Parser->SwTrie[Node];
+        if (TrieNode->Term) {
+            *SwStr = TrieNode->Term;
+            return TrieNode->TermId;
         }
-        String++; // Skip the 'X'
+        if (ARG_CHAR(Arg, Narrow, 1) == L'\0') {
+            // switch char on its own is not an abbreviation
+            return SWID_NONE;
+        }
+        *SwStr = TrieNode->Str;
+        return TrieNode->Id;
     }
-    while (InternalIsHexaDecimalDigitCharacter(*String)) {
-        String++;
+    CONST STR_INDEX_KEY *Key = StrIndexFind(&Parser->SwIndex, Arg, Narrow, L'\0');
+    if (!Key) {
+        return SWID_NONE;
     }
-    return *String == L'\0' ? TRUE : FALSE;
+    *SwStr = Key->Str;
+    return Key->Id;
 }
 
 /**
- * Function: IsDecimalString
+ * Function: GetShellArgs
  *
- * Returns TRUE if valid decimal value
-  **/
-STATIC BOOLEAN IsDecimalString(
-  IN CONST CHAR16 *String   //string to check
+ * Gets cmd line arguments from the shell, also sets program name if not already set
+ * Returns EFI_UNSUPPORTED if no shell protocol found
+ **/
+STATIC EFI_STATUS GetShellArgs(
+  OUT UINTN     *Argc,      // number of arguments
+  OUT CHAR16    ***Argv     // argument array
   )
 {
-    while ((*String == L' ') || (*String == L'\t')) {
-        String++;
+    if (gEfiShellParametersProtocol != NULL) {  // Check for UEFI Shell 2.0 protocols
+        *Argc = gEfiShellParametersProtocol->Argc;
+        *Argv = gEfiShellParametersProtocol->Argv;
+    } else if  (mEfiShellInterface != NULL) {
+        *Argc = mEfiShellInterface->Argc;
+        *Argv = mEfiShellInterface->Argv;
+    } else {
+        return EFI_UNSUPPORTED;
     }
-    while (InternalIsDecimalDigitCharacter(*String)) {
-        String++;
+    // use cmd line parameter for program name if non specified
+    if (!g_ProgName && *Argc) {
+        g_ProgName = GetFileName((*Argv)[0]);
     }
-    return *String == L'\0' ? TRUE : FALSE;
+    return EFI_SUCCESS;
 }
 
 /**
@@ -613,17 +4084,269 @@ STATIC CONST CHAR16* GetFileName(
     return PathName;
 }
 
+/**
+ * Function: BuildCommandLine
+ *
+ * Joins arguments into a shell command line, quoting arguments that are empty or contain
+ * spaces and escaping chars special to the shell with '^'
+ * Returns length of command line, excluding the terminator
+ **/
+STATIC UINTN BuildCommandLine(
+  IN UINTN      Argc,       // number of arguments
+  IN CHAR16     **Argv,     // argument vector
+  OUT CHAR16    *CmdLine    // ptr to buffer for command line; NULL to only measure
+  )
+{
+    UINTN Len = 0;
+    for (UINTN i = 0; i < Argc; i++) {
+        CONST CHAR16 *Arg = Argv[i];
+        BOOLEAN Quote = (Arg[0] == L'\0');
+        for (UINTN j = 0; Arg[j] && !Quote; j++) {
+            Quote = (Arg[j] == L' ') || (Arg[j] == L'\t');
+        }
+        if (i) {
+            if (CmdLine) {
+                CmdLine[Len] = L' ';
+            }
+            Len++;
+        }
+        if (Quote) {
+            if (CmdLine) {
+                CmdLine[Len] = L'"';
+            }
+            Len++;
+        }
+        for (; *Arg; Arg++) {
+            switch (*Arg) {
+            case L'^': case L'"': case L'%': case L'#': case L'<': case L'>': case L'|':
+                if (CmdLine) {
+                    CmdLine[Len] = L'^';
+                }
+                Len++;
+                break;
+            default:
+                break;
+            }
+            if (CmdLine) {
+                CmdLine[Len] = *Arg;
+            }
+            Len++;
+        }
+        if (Quote) {
+            if (CmdLine) {
+                CmdLine[Len] = L'"';
+            }
+            Len++;
+        }
+    }
+    if (CmdLine) {
+        CmdLine[Len] = L'\0';
+    }
+    return Len;
+}
+
+/**
+ * Function: CounterTicks
+ *
+ * Counts the performance counter ticks between two readings, allowing for a counter that
+ * counts down or wraps
+ * Returns number of ticks
+ **/
+STATIC UINT64 CounterTicks(
+  IN UINT64 Start,  // counter before
+  IN UINT64 End     // counter after
+  )
+{
+    UINT64 First;
+    UINT64 Last;
+    GetPerformanceCounterProperties(&First, &Last);
+    if (First > Last) {
+        // counts down, so measure from the end
+        UINT64 Tmp = First;
+        First = Last;
+        Last = Tmp;
+        Tmp = Start;
+        Start = End;
+        End = Tmp;
+    }
+    return (End >= Start) ? End - Start : (Last - Start) + (End - First) + 1;
+}
+
 /**
  * TableError()
  * 
  * Runtime table error function
  **/
 STATIC VOID TableError(
-  IN UINTN  i,          // table entry
-  IN CHAR16 *errStr     // error string
+  IN CONST CHAR16   *Table,     // table name
+  IN UINTN          i,          // table entry
+  IN CONST CHAR16   *errStr     // error string
+  )
+{
+    ShellPrintEx(-1, -1, L"TBLERR(%d): %s: %s\n", i, Table, errStr);
+}
+
+/**
+ * Function: ValidateSwitchTable
+ *
+ * Checks every switch of a switch table, names against the built-in switches and each other,
+ * and the constraints that follow them, reporting each problem found
+ * Returns SHELL_SUCCESS if table is valid
+ **/
+STATIC SHELL_STATUS ValidateSwitchTable(
+  IN SWITCH_TABLE   *SwTable,   // ptr to switch table
+  IN UINTN          SwCount,    // number of switches, before the constraints
+  IN UINT16         FuncOpt     // functional options
+  )
+{
+    SHELL_STATUS ShellStatus = SHELL_SUCCESS;
+    CONST CHAR16 *ErrStr;
+
+    STR_INDEX Index;
+    if (EFI_ERROR(StrIndexInit(&Index, SwCount * 2 + 4))) {
+        return SHELL_OUT_OF_RESOURCES;
+    }
+    StrIndexAdd(&Index, g_BreakSwStr1, SWID_BREAK);
+    StrIndexAdd(&Index, g_BreakSwStr2, SWID_BREAK);
+    if (!(FuncOpt & NO_HELP)) {
+        StrIndexAdd(&Index, g_HelpSwStr1, SWID_HELP);
+        StrIndexAdd(&Index, g_HelpSwStr2, SWID_HELP);
+    }
+    for (UINTN i = 0; i < SwCount; i++) {
+        if (!SwTable[i].SwStr1 && !SwTable[i].SwStr2) {
+            TableError(L"Switch", i, L"No name");
+            ShellStatus = SHELL_INVALID_PARAMETER;
+        }
+        CONST CHAR16 *SwStr[2] = { SwTable[i].SwStr1, SwTable[i].SwStr2 };
+        for (UINTN n = 0; n < 2; n++) {
+            if (!SwStr[n]) {
+                continue;
+            }
+            if (((SwStr[n][0] != L'-') && (SwStr[n][0] != L'/')) || !SwStr[n][1]) {
+                TableError(L"Switch", i, L"Invalid name");
+                ShellStatus = SHELL_INVALID_PARAMETER;
+            } else if (!StrIndexAdd(&Index, SwStr[n], i)) {
+                TableError(L"Switch", i, L"Duplicate name");
+                ShellStatus = SHELL_INVALID_PARAMETER;
+            }
+        }
+        if (SwTable[i].ValueRetPtr.pVoid == NULL) {
+            TableError(L"Switch", i, L"Null 'RetValPtr'");
+            ShellStatus = SHELL_INVALID_PARAMETER;
+        }
+        ErrStr = CheckTableData(SwTable[i].ValueType, &SwTable[i].Data);
+        if (ErrStr) {
+            TableError(L"Switch", i, ErrStr);
+            ShellStatus = SHELL_INVALID_PARAMETER;
+        }
+    }
+    StrIndexFree(&Index);
+
+    // constraints follow the switches and may only name them
+    for (UINTN i = SwCount; SwTable[i].SwitchNecessity != NO_SW; i++) {
+        if (IS_SWITCH(SwTable[i])) {
+            TableError(L"Switch", i, L"Switch after constraint");
+            ShellStatus = SHELL_INVALID_PARAMETER;
+        } else if (SwTable[i].SwitchNecessity > ONE_OF_SW) {
+            TableError(L"Switch", i, L"Invalid 'SwitchNecessity'");
+            ShellStatus = SHELL_INVALID_PARAMETER;
+        } else if (((SwTable[i].SwitchNecessity != ONE_OF_SW) && !ResolveSwitchList(SwTable, SwCount, SwTable[i].SwStr1, NULL))
+                   || !ResolveSwitchList(SwTable, SwCount, SwTable[i].SwStr2, NULL)) {
+            TableError(L"Switch", i, L"Unknown constraint switch");
+            ShellStatus = SHELL_INVALID_PARAMETER;
+        }
+    }
+
+    return ShellStatus;
+}
+
+/**
+ * Function: CheckTableData
+ *
+ * Checks the value type and misc data of a parameter or switch table entry
+ * Returns error string; NULL if valid
+ **/
+STATIC CONST CHAR16* CheckTableData(
+  IN VALUE_TYPE ValueType,  // type of value
+  IN DATA       *Data       // ptr to misc data for value
+  )
+{
+    switch (ValueType) {
+    case VALTYPE_STRING:
+    case VALTYPE_ASCII_STRING:
+        return Data->MaxStrSize ? NULL : L"Zero 'StrSize'";
+    case VALTYPE_DECIMAL:
+    case VALTYPE_HEXIDECIMAL:
+    case VALTYPE_INTEGER:
+    case VALTYPE_SIGNED:
+    case VALTYPE_SIZE:
+    case VALTYPE_TIME:
+    case VALTYPE_FREQ:
+        return (Data->ValSize <= SIZE64) ? NULL : L"Invalid 'ValSize'";
+    case VALTYPE_BITMAP:
+        return Data->BitCount ? NULL : L"Zero 'Bits'";
+    case VALTYPE_ENUM:
+        return CheckEnumArray(Data->EnumStrArray, FALSE);
+    case VALTYPE_ENUM_SET:
+        return CheckEnumArray(Data->EnumStrArray, TRUE);
+    case VALTYPE_NONE:
+    case VALTYPE_STRREF:
+    case VALTYPE_RANGES:
+    case VALTYPE_DEC_LIST:
+    case VALTYPE_HEX_LIST:
+    case VALTYPE_INT_LIST:
+    case VALTYPE_STR_LIST:
+        return NULL;
+    }
+    return L"Invalid 'ValueType'";
+}
+
+/**
+ * Function: CheckEnumArray
+ *
+ * Checks enum array has entries, ends with {0, NULL} and has no string more than once; the end
+ * entry is only looked for in the first ENUM_MAX_ENTRIES, and duplicates are only looked for if
+ * memory allows. An enum set may not have the strings 'all' or 'none', which would be hidden
+ * by the keywords
+ * Returns error string; NULL if valid
+ **/
+STATIC CONST CHAR16* CheckEnumArray(
+  IN ENUM_STR_ARRAY *EnumStrArray,  // ptr to enum array
+  IN BOOLEAN        IsSet           // TRUE if array is for an enum set
   )
 {
-    ShellPrintEx(-1, -1, L"TBLERR(%d): %s\n", i, errStr);
+    if (!EnumStrArray) {
+        return L"Null 'EnumArray'";
+    }
+    UINTN Count = 0;
+    while (EnumStrArray[Count].Str) {
+        CONST CHAR16 *Str = EnumStrArray[Count].Str;
+        if (!Str[0]) {
+            return L"Empty string in 'EnumArray'";
+        }
+        if (IsSet && (((StrLen(Str) == 3) && ArgStrniEqual(L"all", Str, FALSE, 3)) ||
+                      ((StrLen(Str) == 4) && ArgStrniEqual(L"none", Str, FALSE, 4)))) {
+            return L"Keyword 'all' or 'none' in enum set 'EnumArray'";
+        }
+        if (++Count == ENUM_MAX_ENTRIES) {
+            return L"No end entry in 'EnumArray'";
+        }
+    }
+    if (!Count) {
+        return L"Empty 'EnumArray'";
+    }
+    CONST CHAR16 *ErrStr = NULL;
+    STR_INDEX Index;
+    if (!EFI_ERROR(StrIndexInit(&Index, Count))) {
+        for (UINTN i = 0; i < Count; i++) {
+            if (!StrIndexAdd(&Index, EnumStrArray[i].Str, i)) {
+                ErrStr = L"Duplicate string in 'EnumArray'";
+                break;
+            }
+        }
+        StrIndexFree(&Index);
+    }
+    return ErrStr;
 }
 
 /**
@@ -707,6 +4430,7 @@ STATIC UINTN GetArgName(
 #define PAD_SIZE        20
 
 STATIC VOID ShowHelp(
+  IN CONST CHAR16    *ProgName,         // program name
   IN UINTN           ManParamCount,     // number of mandatory parameters
   IN PARAMETER_TABLE *ParamTable,       // ptr to parameter table
   IN SWITCH_TABLE    *SwTable,          // ptr to switch table
@@ -736,8 +4460,8 @@ STATIC VOID ShowHelp(
     }
 
     // Usage line
-    if (g_ProgName) {
-        ShellPrintEx(-1, -1, L"Usage: %s", g_ProgName);
+    if (ProgName) {
+        ShellPrintEx(-1, -1, L"Usage: %s", ProgName);
     } else {
         ShellPrintEx(-1, -1, L"Usage: ");
     }
@@ -746,13 +4470,13 @@ STATIC VOID ShowHelp(
         while (ParamTable[i].ValueType != VALTYPE_NONE) {
             // usage: parameters
             GetArgName(ParamTable[i].HelpStr, ArgName, ARG_NAME_SIZE, (i + 1 <= ManParamCount), g_DefaultArgName);
-            ShellPrintEx(-1, -1, L" %s", ArgName);
+            ShellPrintEx(-1, -1, IsListType(ParamTable[i].ValueType) ? L" %s..." : L" %s", ArgName);
             i++;
         }
     }
     if (SwTable) {
         UINTN i = 0;
-        while (SwTable[i].SwitchNecessity != NO_SW) {
+        while (IS_SWITCH(SwTable[i])) {
             // usage: mandatory switches
             if (SwTable[i].SwitchNecessity == MAN_SW) {
                 CHAR16* SwStr = SwTable[i].SwStr1 ? SwTable[i].SwStr1 : SwTable[i].SwStr2;
@@ -767,7 +4491,7 @@ STATIC VOID ShowHelp(
             i++;
         }
         i = 0;
-        while (SwTable[i].SwitchNecessity != NO_SW) {
+        while (IS_SWITCH(SwTable[i])) {
             // usage: optional switches
             if (SwTable[i].SwitchNecessity != MAN_SW) {
                 ShellPrintEx(-1, -1, L" [options]");
@@ -776,6 +4500,9 @@ STATIC VOID ShowHelp(
             i++;
         }
     }
+    if (FuncOpt & PASS_THROUGH) {
+        ShellPrintEx(-1, -1, L" [-- command]");
+    }
     ShellPrintEx(-1, -1, L"\n");
 
     // Parameter help
@@ -794,7 +4521,7 @@ STATIC VOID ShowHelp(
         // Mandatory switches
         UINTN i = 0;
         UINTN count = 0;
-        while (SwTable[i].SwitchNecessity != NO_SW) {
+        while (IS_SWITCH(SwTable[i])) {
             if (SwTable[i].SwitchNecessity == MAN_SW) {
                 if (count++ == 0) {
                     ShellPrintEx(-1, -1, L"\n Required switches:\n");
@@ -806,7 +4533,7 @@ STATIC VOID ShowHelp(
         // Optional switches
         i = 0;
         count = 0;
-        while (SwTable[i].SwitchNecessity != NO_SW) {
+        while (IS_SWITCH(SwTable[i])) {
             if (SwTable[i].SwitchNecessity != MAN_SW) {
                 if (count++ == 0) {
                     ShellPrintEx(-1, -1, L"\n Optional switches:\n");
@@ -817,7 +4544,76 @@ STATIC VOID ShowHelp(
         }
     }
     // help switch
-    ShellPrintEx(-1, -1, L"  %s, %s %s%s\n\n", g_HelpSwStr1, g_HelpSwStr2, &pad[StrLen(g_HelpSwStr2)], g_HelpSwStr);
+    ShellPrintEx(-1, -1, L"  %s, %s %s%s\n", g_HelpSwStr1, g_HelpSwStr2, &pad[StrLen(g_HelpSwStr2)], g_HelpSwStr);
+    // Switch constraints
+    if (SwTable) {
+        UINTN i = 0;
+        while (IS_SWITCH(SwTable[i])) {
+            i++;
+        }
+        if (SwTable[i].SwitchNecessity != NO_SW) {
+            ShellPrintEx(-1, -1, L"\n Switch rules:\n");
+        }
+        while (SwTable[i].SwitchNecessity != NO_SW) {
+            PrintConstraintHelp(&SwTable[i]);
+            i++;
+        }
+    }
+    ShellPrintEx(-1, -1, L"\n");
+}
+
+/**
+ * Function: IsBuiltInSwitch
+ *
+ * Checks argument (ignoring case) against the short and long name of a built-in switch
+ * Returns TRUE if argument is the switch
+ **/
+STATIC BOOLEAN IsBuiltInSwitch(
+  IN CONST CHAR16   *Arg,       // cmd line argument
+  IN CONST CHAR16   *SwStr1,    // short switch name
+  IN CONST CHAR16   *SwStr2     // long switch name
+  )
+{
+    UINTN Len = StrLen(Arg);
+    return ((Len == StrLen(SwStr1)) && StrniEqual(Arg, SwStr1, Len)) || ((Len == StrLen(SwStr2)) && StrniEqual(Arg, SwStr2, Len));
+}
+
+/**
+ * Function: ShowSubCmdHelp
+ * 
+ * Display program help listing the subcommands
+ **/
+STATIC VOID ShowSubCmdHelp(
+  IN CONST CHAR16           *ProgName,  // program name
+  IN CONST CMDLINE_SUBCMDS  *SubCmds    // ptr to subcommands
+  )
+{
+    // initialise padding string
+    CHAR16 pad[PAD_SIZE];
+    for (UINTN i=0; i<PAD_SIZE; i++) {
+        pad[i] = L' ';
+    }
+    pad[PAD_SIZE-1] = L'\0';
+
+    // program description
+    ShellPrintEx(-1, -1, L"\n");
+
+    if (SubCmds->ProgHelpStr) {
+        ShellPrintEx(-1, -1, L"%s\n\n", SubCmds->ProgHelpStr);
+    }
+
+    // Usage line
+    ShellPrintEx(-1, -1, L"Usage: %s <command> [args]\n", ProgName);
+
+    // Command help
+    ShellPrintEx(-1, -1, L"\n Commands:\n");
+    for (UINTN i = 0; i < SubCmds->SubCmdCount; i++) {
+        SUBCMD_TABLE *SubCmd = &SubCmds->SubCmdTable[i];
+        ShellPrintEx(-1, -1, L"  %s%s     %s\n", SubCmd->Name, &pad[MIN(StrLen(SubCmd->Name), PAD_SIZE - 1)], SubCmd->HelpStr ? SubCmd->HelpStr : L"");
+    }
+    // help switch
+    ShellPrintEx(-1, -1, L"  %s, %s %s%s\n", g_HelpSwStr1, g_HelpSwStr2, &pad[StrLen(g_HelpSwStr2)], g_HelpSwStr);
+    ShellPrintEx(-1, -1, L"\n '%s <command> %s' displays help for a command\n\n", ProgName, g_HelpSwStr1);
 }
 
 STATIC VOID PrintSwitchHelp(
@@ -849,8 +4645,8 @@ STATIC VOID PrintSwitchHelp(
     UINTN TotalLen = StrLen(SwStr2) + StrLen(ArgName);
     CHAR16 *PadStr = (TotalLen > PAD_SIZE-1) ? &pad[(PAD_SIZE-1)-1] : &pad[TotalLen];
     ShellPrintEx(-1, -1, L"  %s%c %s %s%s%s", SwStr1, SeperatorChar, SwStr2, ArgName, PadStr, &SwTableEntry->HelpStr[HelpIdx]);
-    if (SwTableEntry->ValueType == VALTYPE_ENUM) {
-        // print all valid options for enum switches
+    if ((SwTableEntry->ValueType == VALTYPE_ENUM) || (SwTableEntry->ValueType == VALTYPE_ENUM_SET)) {
+        // print all valid options for enum and enum set switches
         ShellPrintEx(-1, -1, L" (");
         UINTN j = 0;
         while (SwTableEntry->Data.EnumStrArray[j].Str) {
@@ -860,11 +4656,38 @@ STATIC VOID PrintSwitchHelp(
                 ShellPrintEx(-1, -1, L"|");
             }
         }
+        if (SwTableEntry->ValueType == VALTYPE_ENUM_SET) {
+            ShellPrintEx(-1, -1, L"|all|none");
+        }
         ShellPrintEx(-1, -1, L")");
     }
     ShellPrintEx(-1, -1, L"\n");
 }
 
+/**
+ * Function: PrintConstraintHelp
+ * 
+ * Display help line for a switch constraint
+ **/
+STATIC VOID PrintConstraintHelp(
+  IN SWITCH_TABLE *SwTableEntry     // ptr to switch table constraint entry
+  )
+{
+    switch (SwTableEntry->SwitchNecessity) {
+    case REQUIRES_SW:
+        ShellPrintEx(-1, -1, L"  %s requires %s\n", SwTableEntry->SwStr1, SwTableEntry->SwStr2);
+        break;
+    case CONFLICTS_SW:
+        ShellPrintEx(-1, -1, L"  %s cannot be used with %s\n", SwTableEntry->SwStr1, SwTableEntry->SwStr2);
+        break;
+    case ONE_OF_SW:
+        ShellPrintEx(-1, -1, L"  exactly one of %s\n", SwTableEntry->SwStr2);
+        break;
+    default:
+        break;
+    }
+}
+
 /**
  * Function: CheckProgAbort
  * 
@@ -1050,17 +4873,7 @@ EFI_STATUS DecimalInput(
   IN CONST CHAR16 *PromptStr OPTIONAL
   )
 {
-    CHAR16 InputBuffer[INPUT_BUFF_LEN];    
-    EFI_STATUS Status = StringInput(InputBuffer, INPUT_BUFF_LEN, PromptStr);
-    if (!EFI_ERROR(Status)) {
-        if (!IsDecimalString(InputBuffer)) {
-            ShellPrintEx(-1, -1, L"%H%s%N: Invalid decimal input!\r\n", g_ProgName);
-            Status = EFI_INVALID_PARAMETER;
-        } else {
-            *Value = StrDecimalToUintn(InputBuffer);
-        }
-    }
-    return Status;
+    return IntegerTypeInput(Value, PromptStr, VALTYPE_DECIMAL, L"decimal");
 }
 
 /**
@@ -1072,17 +4885,7 @@ EFI_STATUS HexidecimalInput(
   IN CONST CHAR16 *PromptStr OPTIONAL
   )
 {
-    CHAR16 InputBuffer[INPUT_BUFF_LEN];    
-    EFI_STATUS Status = StringInput(InputBuffer, INPUT_BUFF_LEN, PromptStr);
-    if (!EFI_ERROR(Status)) {
-        if (!IsHexString(InputBuffer)) {
-            ShellPrintEx(-1, -1, L"%H%s%N: Invalid hexidecimal input!\r\n", g_ProgName);
-            Status = EFI_INVALID_PARAMETER;
-        } else {
-            *Value = StrHexToUintn(InputBuffer);
-        }
-    }
-    return Status;
+    return IntegerTypeInput(Value, PromptStr, VALTYPE_HEXIDECIMAL, L"hexidecimal");
 }
 
 /**
@@ -1094,19 +4897,35 @@ EFI_STATUS IntegerInput(
   IN CONST CHAR16 *PromptStr OPTIONAL
   )
 {
-    CHAR16 InputBuffer[INPUT_BUFF_LEN];    
+    return IntegerTypeInput(Value, PromptStr, VALTYPE_INTEGER, L"integer");
+}
+
+/**
+ * Function: IntegerTypeInput
+ *
+ * Accept integer input of given type from keyboard, converted as for cmd line values
+ * Returns EFI_INVALID_PARAMETER if invalid or too large a value entered
+ **/
+STATIC EFI_STATUS IntegerTypeInput(
+  OUT UINTN         *Value,         // ptr to UINTN to store input
+  IN CONST CHAR16   *PromptStr,     // ptr to prompt string; NULL for none
+  IN VALUE_TYPE     ValueType,      // type of value
+  IN CONST CHAR16   *TypeStr        // name of type for error message
+  )
+{
+    CHAR16 InputBuffer[INPUT_BUFF_LEN];
+    UINT64 IntValue;
     EFI_STATUS Status = StringInput(InputBuffer, INPUT_BUFF_LEN, PromptStr);
     if (!EFI_ERROR(Status)) {
-        if (HasHexPrefix(InputBuffer)) {
-            if (!IsHexString(InputBuffer)) {
-                ShellPrintEx(-1, -1, L"%H%s%N: Invalid hexidecimal input!\r\n", g_ProgName);
-            Status = EFI_INVALID_PARAMETER;
-            }
-            *Value = StrHexToUintn(InputBuffer);
-        } else if (IsDecimalString(InputBuffer)) {
-            *Value = StrDecimalToUintn(InputBuffer);
+        VALUE_STATUS ValStatus = ParseInteger(InputBuffer, FALSE, ValueType, SIZEN, &IntValue);
+        if (ValStatus == VAL_OK) {
+            *Value = (UINTN)IntValue;
         } else {
-            ShellPrintEx(-1, -1, L"%H%s%N: Invalid decimal input!\r\n", g_ProgName);
+            if ((ValStatus == VAL_UINT32_TOO_BIG) || (ValStatus == VAL_UINT64_TOO_BIG)) {
+                ShellPrintEx(-1, -1, L"%H%s%N: Too large %s input!\r\n", g_ProgName, TypeStr);
+            } else {
+                ShellPrintEx(-1, -1, L"%H%s%N: Invalid %s input!\r\n", g_ProgName, TypeStr);
+            }
             Status = EFI_INVALID_PARAMETER;
         }
     }
@@ -17,6 +17,20 @@ extern "C" {
 #include <Library/ShellLib.h>
 #include "CmdLineInternal.h"
 
+//-------------------------------------
+// Table Checks
+//-------------------------------------
+
+// evaluates to Value, failing to compile if Cond is a constant that is FALSE (e.g. a zero string size);
+// Cond is only checked when it is a constant, so tables may still be built from runtime values, and
+// only by GCC and Clang C builds; the rest of a table is checked by CmdLineValidateTables()
+#if defined(__GNUC__) && !defined(__cplusplus)
+#define CMDLINE_CHECKED(Value, Cond) \
+    ((Value) + 0 * sizeof(char[__builtin_choose_expr(__builtin_constant_p(Cond), (Cond) ? 1 : -1, 1)]))
+#else
+#define CMDLINE_CHECKED(Value, Cond)    (Value)
+#endif
+
 //-------------------------------------
 // Parameter Table Macros
 //-------------------------------------
@@ -31,20 +45,31 @@ extern "C" {
 
 /**
   PARAMTABLE_STR - Adds string parameter to table
+  PARAMTABLE_STR8 - Adds ASCII string parameter to table; a value with a char above 0x7F is
+                    rejected rather than truncated to its low byte
 
-  ValueRetPtr   Ptr to CHAR16 string to hold value entered
+  ValueRetPtr   Ptr to CHAR16 (CHAR8 for STR8) string to hold value entered
   StrSize       Size of above string
   HelpStr       Ptr to CHAR16 help string for parameter
 **/
 #define PARAMTABLE_STR(ValueRetPtr, StrSize, HelpStr) \
-    {VALTYPE_STRING, {.MaxStrSize=StrSize}, {.pChar16=ValueRetPtr}, HelpStr},
+    {VALTYPE_STRING, {.MaxStrSize=CMDLINE_CHECKED(StrSize, (StrSize) > 0)}, {.pChar16=ValueRetPtr}, HelpStr},
 #define PARAMTABLE_STR8(ValueRetPtr, StrSize, HelpStr) \
-    {VALTYPE_ASCII_STRING, {.MaxStrSize=StrSize}, {.pChar8=ValueRetPtr}, HelpStr},
+    {VALTYPE_ASCII_STRING, {.MaxStrSize=CMDLINE_CHECKED(StrSize, (StrSize) > 0)}, {.pChar8=ValueRetPtr}, HelpStr},
+
+/**
+  PARAMTABLE_STRREF - Adds string parameter to table, returned without copying
+
+  ValueRetPtr   Ptr to CMDLINE_STRREF, set to the string in the argument vector and its length
+  HelpStr       Ptr to CHAR16 help string for parameter
+**/
+#define PARAMTABLE_STRREF(ValueRetPtr, HelpStr) \
+    {VALTYPE_STRREF, {0}, {.pStrRef=ValueRetPtr}, HelpStr},
 
 /**
   PARAMTABLE_DEC - Adds decimal parameter to table
 
-  ValueRetPtr   Ptr to (UINTN|UINT8|UINT16|UINT32) to hold value entered
+  ValueRetPtr   Ptr to (UINTN|UINT8|UINT16|UINT32|UINT64) to hold value entered
   HelpStr       Ptr to CHAR16 help string for parameter
 **/
 #define PARAMTABLE_DEC(ValueRetPtr, HelpStr) \
@@ -55,11 +80,13 @@ extern "C" {
     {VALTYPE_DECIMAL, {.ValSize=SIZE16}, {.pUint16=ValueRetPtr}, HelpStr},
 #define PARAMTABLE_DEC32(ValueRetPtr, HelpStr) \
     {VALTYPE_DECIMAL, {.ValSize=SIZE32}, {.pUint32=ValueRetPtr}, HelpStr},
+#define PARAMTABLE_DEC64(ValueRetPtr, HelpStr) \
+    {VALTYPE_DECIMAL, {.ValSize=SIZE64}, {.pUint64=ValueRetPtr}, HelpStr},
 
 /**
   PARAMTABLE_HEX - Adds hexidecimal parameter to table
 
-  ValueRetPtr   Ptr to (UINTN|UINT8|UINT16|UINT32) to hold value entered
+  ValueRetPtr   Ptr to (UINTN|UINT8|UINT16|UINT32|UINT64) to hold value entered
   HelpStr       Ptr to CHAR16 help string for parameter
 **/
 #define PARAMTABLE_HEX(ValueRetPtr, HelpStr) \
@@ -70,11 +97,13 @@ extern "C" {
     {VALTYPE_HEXIDECIMAL, {.ValSize=SIZE16}, {.pUint16=ValueRetPtr}, HelpStr},
 #define PARAMTABLE_HEX32(ValueRetPtr, HelpStr) \
     {VALTYPE_HEXIDECIMAL, {.ValSize=SIZE32}, {.pUint32=ValueRetPtr}, HelpStr},
+#define PARAMTABLE_HEX64(ValueRetPtr, HelpStr) \
+    {VALTYPE_HEXIDECIMAL, {.ValSize=SIZE64}, {.pUint64=ValueRetPtr}, HelpStr},
 
 /**
   PARAMTABLE_INT - Adds integer parameter (decimal or hex) to table
 
-  ValueRetPtr   Ptr to (UINTN|UINT8|UINT16|UINT32) to hold value entered
+  ValueRetPtr   Ptr to (UINTN|UINT8|UINT16|UINT32|UINT64) to hold value entered
   HelpStr       Ptr to CHAR16 help string for parameter
 **/
 #define PARAMTABLE_INT(ValueRetPtr, HelpStr) \
@@ -85,6 +114,90 @@ extern "C" {
     {VALTYPE_INTEGER, {.ValSize=SIZE16}, {.pUint16=ValueRetPtr}, HelpStr},
 #define PARAMTABLE_INT32(ValueRetPtr, HelpStr) \
     {VALTYPE_INTEGER, {.ValSize=SIZE32}, {.pUint32=ValueRetPtr}, HelpStr},
+#define PARAMTABLE_INT64(ValueRetPtr, HelpStr) \
+    {VALTYPE_INTEGER, {.ValSize=SIZE64}, {.pUint64=ValueRetPtr}, HelpStr},
+
+/**
+  PARAMTABLE_SINT - Adds signed integer parameter (decimal or hex, optional sign) to table
+                    a negative value is taken as the parameter rather than as a switch
+
+  ValueRetPtr   Ptr to (INTN|INT8|INT16|INT32|INT64) to hold value entered
+  HelpStr       Ptr to CHAR16 help string for parameter
+**/
+#define PARAMTABLE_SINT(ValueRetPtr, HelpStr) \
+    {VALTYPE_SIGNED, {.ValSize=SIZEN}, {.pIntn=ValueRetPtr}, HelpStr},
+#define PARAMTABLE_SINT8(ValueRetPtr, HelpStr) \
+    {VALTYPE_SIGNED, {.ValSize=SIZE8}, {.pInt8=ValueRetPtr}, HelpStr},
+#define PARAMTABLE_SINT16(ValueRetPtr, HelpStr) \
+    {VALTYPE_SIGNED, {.ValSize=SIZE16}, {.pInt16=ValueRetPtr}, HelpStr},
+#define PARAMTABLE_SINT32(ValueRetPtr, HelpStr) \
+    {VALTYPE_SIGNED, {.ValSize=SIZE32}, {.pInt32=ValueRetPtr}, HelpStr},
+#define PARAMTABLE_SINT64(ValueRetPtr, HelpStr) \
+    {VALTYPE_SIGNED, {.ValSize=SIZE64}, {.pInt64=ValueRetPtr}, HelpStr},
+
+/**
+  PARAMTABLE_SIZE - Adds size parameter to table, stored in bytes
+                   (e.g. 4K, 1.5G; suffixes B, K, M, G, T, P, E (binary multiples))
+                   A '0x' prefixed hex value takes no suffix, so 0x1B is 27 bytes
+
+  ValueRetPtr   Ptr to (UINTN|UINT32|UINT64) to hold value entered
+  HelpStr       Ptr to CHAR16 help string for parameter
+**/
+#define PARAMTABLE_SIZE(ValueRetPtr, HelpStr) \
+    {VALTYPE_SIZE, {.ValSize=SIZEN}, {.pUintn=ValueRetPtr}, HelpStr},
+#define PARAMTABLE_SIZE32(ValueRetPtr, HelpStr) \
+    {VALTYPE_SIZE, {.ValSize=SIZE32}, {.pUint32=ValueRetPtr}, HelpStr},
+#define PARAMTABLE_SIZE64(ValueRetPtr, HelpStr) \
+    {VALTYPE_SIZE, {.ValSize=SIZE64}, {.pUint64=ValueRetPtr}, HelpStr},
+
+/**
+  PARAMTABLE_TIME - Adds time parameter to table, stored in nanoseconds
+                   (e.g. 250us, 2s; suffixes ns, us, ms, s)
+
+  ValueRetPtr   Ptr to (UINTN|UINT32|UINT64) to hold value entered
+  HelpStr       Ptr to CHAR16 help string for parameter
+**/
+#define PARAMTABLE_TIME(ValueRetPtr, HelpStr) \
+    {VALTYPE_TIME, {.ValSize=SIZEN}, {.pUintn=ValueRetPtr}, HelpStr},
+#define PARAMTABLE_TIME32(ValueRetPtr, HelpStr) \
+    {VALTYPE_TIME, {.ValSize=SIZE32}, {.pUint32=ValueRetPtr}, HelpStr},
+#define PARAMTABLE_TIME64(ValueRetPtr, HelpStr) \
+    {VALTYPE_TIME, {.ValSize=SIZE64}, {.pUint64=ValueRetPtr}, HelpStr},
+
+/**
+  PARAMTABLE_FREQ - Adds frequency parameter to table, stored in hertz
+                   (e.g. 2.4GHz; suffixes Hz, kHz, MHz, GHz)
+
+  ValueRetPtr   Ptr to (UINTN|UINT32|UINT64) to hold value entered
+  HelpStr       Ptr to CHAR16 help string for parameter
+**/
+#define PARAMTABLE_FREQ(ValueRetPtr, HelpStr) \
+    {VALTYPE_FREQ, {.ValSize=SIZEN}, {.pUintn=ValueRetPtr}, HelpStr},
+#define PARAMTABLE_FREQ32(ValueRetPtr, HelpStr) \
+    {VALTYPE_FREQ, {.ValSize=SIZE32}, {.pUint32=ValueRetPtr}, HelpStr},
+#define PARAMTABLE_FREQ64(ValueRetPtr, HelpStr) \
+    {VALTYPE_FREQ, {.ValSize=SIZE64}, {.pUint64=ValueRetPtr}, HelpStr},
+
+/**
+  PARAMTABLE_BITMAP - Adds bitmap parameter to table, a comma separated list of values and
+                      ranges (e.g. '0-3,8,12+4'), for small sets such as CPU numbers
+
+  ValueRetPtr   Ptr to UINTN array of CMDLINE_BITMAP_WORDS(Bits) words to hold values entered
+  Bits          Number of bits in bitmap, values must be below this
+  HelpStr       Ptr to CHAR16 help string for parameter
+**/
+#define PARAMTABLE_BITMAP(ValueRetPtr, Bits, HelpStr) \
+    {VALTYPE_BITMAP, {.BitCount=CMDLINE_CHECKED(Bits, (Bits) > 0)}, {.pBitmap=ValueRetPtr}, HelpStr},
+
+/**
+  PARAMTABLE_RANGES - Adds range list parameter to table, a comma separated list of values and
+                      ranges (e.g. '0x1000:0x2000,0x8000+0x100'), for 64-bit address ranges
+
+  ValueRetPtr   Ptr to CMDLINE_RANGE_LIST to hold sorted, merged ranges entered
+  HelpStr       Ptr to CHAR16 help string for parameter
+**/
+#define PARAMTABLE_RANGES(ValueRetPtr, HelpStr) \
+    {VALTYPE_RANGES, {0}, {.pRangeList=ValueRetPtr}, HelpStr},
 
 /**
   PARAMTABLE_ENUM - Adds enum parameter to table (string entry)
@@ -96,6 +209,37 @@ extern "C" {
 #define PARAMTABLE_ENUM(ValueRetPtr, EnumArray, HelpStr) \
     {VALTYPE_ENUM, EnumArray, {.pEnum=ValueRetPtr}, HelpStr},
 
+/**
+  PARAMTABLE_ENUM_SET - Adds enum set parameter to table (comma separated string entries)
+
+  ValueRetPtr   Ptr to UINT64 to hold the values of the strings entered ORed together
+  EnumArray     Ptr to array defining enum value (a bit mask) to string
+  HelpStr       Ptr to CHAR16 help string for parameter
+**/
+#define PARAMTABLE_ENUM_SET(ValueRetPtr, EnumArray, HelpStr) \
+    {VALTYPE_ENUM_SET, {.EnumStrArray=EnumArray}, {.pUint64=ValueRetPtr}, HelpStr},
+
+/**
+  PARAMTABLE_DEC_REST - Adds decimal list parameter to table
+  PARAMTABLE_HEX_REST - Adds hexidecimal list parameter to table
+  PARAMTABLE_INT_REST - Adds integer (decimal or hex) list parameter to table
+  PARAMTABLE_STR_REST - Adds string list parameter to table
+
+  Must be the last parameter in the table, it takes all of the remaining parameters
+
+  ValueRetPtr   Ptr to CMDLINE_LIST to hold values entered, as UINTN or CONST CHAR16 ptrs;
+                values remain valid until CmdLineFree()
+  HelpStr       Ptr to CHAR16 help string for parameter
+**/
+#define PARAMTABLE_DEC_REST(ValueRetPtr, HelpStr) \
+    {VALTYPE_DEC_LIST, {0}, {.pList=ValueRetPtr}, HelpStr},
+#define PARAMTABLE_HEX_REST(ValueRetPtr, HelpStr) \
+    {VALTYPE_HEX_LIST, {0}, {.pList=ValueRetPtr}, HelpStr},
+#define PARAMTABLE_INT_REST(ValueRetPtr, HelpStr) \
+    {VALTYPE_INT_LIST, {0}, {.pList=ValueRetPtr}, HelpStr},
+#define PARAMTABLE_STR_REST(ValueRetPtr, HelpStr) \
+    {VALTYPE_STR_LIST, {0}, {.pList=ValueRetPtr}, HelpStr},
+
 /**
   PARAMTABLE_END - Ends the parameter table
 **/
@@ -139,9 +283,9 @@ extern "C" {
   HelpStr       Ptr to CHAR16 help string for switch
 **/
 #define SWTABLE_OPT_FLGVAL(SwStr1, SwStr2, ValueRetPtr, Value, HelpStr) \
-    {SwStr1, SwStr2, OPT_SW, VALTYPE_NONE, {.FlagValue=Value}, NULL, {.pUintn=ValueRetPtr}, HelpStr},
+    {SwStr1, SwStr2, OPT_SW, VALTYPE_NONE, {.FlagValue=CMDLINE_CHECKED(Value, (Value) != 0)}, NULL, {.pUintn=ValueRetPtr}, HelpStr},
 #define SWTABLE_MAN_FLGVAL(SwStr1, SwStr2, ValueRetPtr, Value, HelpStr) \
-    {SwStr1, SwStr2, MAN_SW, VALTYPE_NONE, {.FlagValue=Value}, NULL, {.pUintn=ValueRetPtr}, HelpStr},
+    {SwStr1, SwStr2, MAN_SW, VALTYPE_NONE, {.FlagValue=CMDLINE_CHECKED(Value, (Value) != 0)}, NULL, {.pUintn=ValueRetPtr}, HelpStr},
 
 /**
   SWTABLE_OPT_STR - Adds an optional string switch to table
@@ -150,32 +294,61 @@ extern "C" {
   SWTABLE_OPT_STR_FLGD - Adds an optional string switch to table + switch presence flag
   SWTABLE_MAN_STR_FLGD - Adds a mandatory string switch to table + switch presence flag
 
+  The STR8 forms hold an ASCII string; a value with a char above 0x7F is rejected rather
+  than truncated to its low byte
+
   SwStr1        Ptr to CHAR16 defining short switch name
   SwStr2        Ptr to CHAR16 defining long switch name
   PresentPtr    Ptr to BOOLEAN, set to TRUE if switch present
-  ValueRetPtr   Ptr to CHAR16 string to hold value entered
+  ValueRetPtr   Ptr to CHAR16 (CHAR8 for STR8) string to hold value entered
   StrSize       Size of above string
   HelpStr       Ptr to CHAR16 help string for parameter
 **/
 #define SWTABLE_OPT_STR(SwStr1, SwStr2, ValueRetPtr, StrSize, HelpStr) \
-    { SwStr1, SwStr2, OPT_SW, VALTYPE_STRING, {.MaxStrSize=StrSize}, NULL, {.pChar16=ValueRetPtr}, HelpStr},
+    { SwStr1, SwStr2, OPT_SW, VALTYPE_STRING, {.MaxStrSize=CMDLINE_CHECKED(StrSize, (StrSize) > 0)}, NULL, {.pChar16=ValueRetPtr}, HelpStr},
 #define SWTABLE_OPT_STR8(SwStr1, SwStr2, ValueRetPtr, StrSize, HelpStr) \
-    { SwStr1, SwStr2, OPT_SW, VALTYPE_ASCII_STRING, {.MaxStrSize=StrSize}, NULL, {.pChar8=ValueRetPtr}, HelpStr},
+    { SwStr1, SwStr2, OPT_SW, VALTYPE_ASCII_STRING, {.MaxStrSize=CMDLINE_CHECKED(StrSize, (StrSize) > 0)}, NULL, {.pChar8=ValueRetPtr}, HelpStr},
 
 #define SWTABLE_MAN_STR(SwStr1, SwStr2, ValueRetPtr, StrSize, HelpStr) \
-    { SwStr1, SwStr2, MAN_SW, VALTYPE_STRING, {.MaxStrSize=StrSize}, NULL, {.pChar16=ValueRetPtr}, HelpStr},
+    { SwStr1, SwStr2, MAN_SW, VALTYPE_STRING, {.MaxStrSize=CMDLINE_CHECKED(StrSize, (StrSize) > 0)}, NULL, {.pChar16=ValueRetPtr}, HelpStr},
 #define SWTABLE_MAN_STR8(SwStr1, SwStr2, ValueRetPtr, StrSize, HelpStr) \
-    { SwStr1, SwStr2, MAN_SW, VALTYPE_ASCII_STRING, {.MaxStrSize=StrSize}, NULL, {.pChar8=ValueRetPtr}, HelpStr},
+    { SwStr1, SwStr2, MAN_SW, VALTYPE_ASCII_STRING, {.MaxStrSize=CMDLINE_CHECKED(StrSize, (StrSize) > 0)}, NULL, {.pChar8=ValueRetPtr}, HelpStr},
 
 #define SWTABLE_OPT_STR_FLGD(SwStr1, SwStr2, PresentPtr, ValueRetPtr, StrSize, HelpStr) \
-    { SwStr1, SwStr2, OPT_SW, VALTYPE_STRING, {.MaxStrSize=StrSize}, PresentPtr, {.pChar16=ValueRetPtr}, HelpStr},
+    { SwStr1, SwStr2, OPT_SW, VALTYPE_STRING, {.MaxStrSize=CMDLINE_CHECKED(StrSize, (StrSize) > 0)}, PresentPtr, {.pChar16=ValueRetPtr}, HelpStr},
 #define SWTABLE_OPT_STR8_FLGD(SwStr1, SwStr2, PresentPtr, ValueRetPtr, StrSize, HelpStr) \
-    { SwStr1, SwStr2, OPT_SW, VALTYPE_ASCII_STRING, {.MaxStrSize=StrSize}, PresentPtr, {.pChar8=ValueRetPtr}, HelpStr},
+    { SwStr1, SwStr2, OPT_SW, VALTYPE_ASCII_STRING, {.MaxStrSize=CMDLINE_CHECKED(StrSize, (StrSize) > 0)}, PresentPtr, {.pChar8=ValueRetPtr}, HelpStr},
+
+#define SWTABLE_MAN_STR_FLGD(SwStr1, SwStr2, PresentPtr, ValueRetPtr, StrSize, HelpStr) \
+    { SwStr1, SwStr2, MAN_SW, VALTYPE_STRING, {.MaxStrSize=CMDLINE_CHECKED(StrSize, (StrSize) > 0)}, PresentPtr, {.pChar16=ValueRetPtr}, HelpStr},
+#define SWTABLE_MAN_STR8_FLGD(SwStr1, SwStr2, PresentPtr, ValueRetPtr, StrSize, HelpStr) \
+    { SwStr1, SwStr2, MAN_SW, VALTYPE_ASCII_STRING, {.MaxStrSize=CMDLINE_CHECKED(StrSize, (StrSize) > 0)}, PresentPtr, {.pChar8=ValueRetPtr}, HelpStr},
+
+/**
+  SWTABLE_OPT_STRREF - Adds an optional string switch to table, value returned without copying
+  SWTABLE_MAN_STRREF - Adds a mandatory string switch to table, value returned without copying
+
+  SWTABLE_OPT_STRREF_FLGD - Adds an optional string switch to table + switch presence flag
+  SWTABLE_MAN_STRREF_FLGD - Adds a mandatory string switch to table + switch presence flag
+
+  The string remains valid for as long as the argument vector, which for the shell
+  command line is the life of the application
+
+  SwStr1        Ptr to CHAR16 defining short switch name
+  SwStr2        Ptr to CHAR16 defining long switch name
+  PresentPtr    Ptr to BOOLEAN, set to TRUE if switch present
+  ValueRetPtr   Ptr to CMDLINE_STRREF, set to the string in the argument vector and its length
+  HelpStr       Ptr to CHAR16 help string for parameter
+**/
+#define SWTABLE_OPT_STRREF(SwStr1, SwStr2, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, OPT_SW, VALTYPE_STRREF, {0}, NULL, {.pStrRef=ValueRetPtr}, HelpStr},
+#define SWTABLE_MAN_STRREF(SwStr1, SwStr2, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, MAN_SW, VALTYPE_STRREF, {0}, NULL, {.pStrRef=ValueRetPtr}, HelpStr},
 
-#define SWTABLE_MAN_STR_FLGD(SwStr1, SwStr2, PresentPtr, alueRetPtr, StrSize, HelpStr) \
-    { SwStr1, SwStr2, MAN_SW, VALTYPE_STRING, {.MaxStrSize=StrSize}, PresentPtr, {.pChar16=ValueRetPtr}, HelpStr},
-#define SWTABLE_MAN_STR8_FLGD(SwStr1, SwStr2, PresentPtr, alueRetPtr, StrSize, HelpStr) \
-    { SwStr1, SwStr2, MAN_SW, VALTYPE_ASCII_STRING, {.MaxStrSize=StrSize}, PresentPtr, {.pChar8=ValueRetPtr}, HelpStr},
+#define SWTABLE_OPT_STRREF_FLGD(SwStr1, SwStr2, PresentPtr, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, OPT_SW, VALTYPE_STRREF, {0}, PresentPtr, {.pStrRef=ValueRetPtr}, HelpStr},
+#define SWTABLE_MAN_STRREF_FLGD(SwStr1, SwStr2, PresentPtr, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, MAN_SW, VALTYPE_STRREF, {0}, PresentPtr, {.pStrRef=ValueRetPtr}, HelpStr},
 
 
 /**
@@ -188,7 +361,7 @@ extern "C" {
   SwStr1        Ptr to CHAR16 defining short switch name
   SwStr2        Ptr to CHAR16 defining long switch name
   PresentPtr    Ptr to BOOLEAN, set to TRUE if switch present
-  ValueRetPtr   Ptr to (UINTN|UINT8|UINT16|UINT32) to hold value entered
+  ValueRetPtr   Ptr to (UINTN|UINT8|UINT16|UINT32|UINT64) to hold value entered
   HelpStr       Ptr to CHAR16 help string for parameter
 **/
 #define SWTABLE_OPT_DEC(SwStr1, SwStr2, ValueRetPtr, HelpStr) \
@@ -199,6 +372,8 @@ extern "C" {
     { SwStr1, SwStr2, OPT_SW, VALTYPE_DECIMAL, {.ValSize=SIZE16}, NULL, {.pUint16=ValueRetPtr}, HelpStr},
 #define SWTABLE_OPT_DEC32(SwStr1, SwStr2, ValueRetPtr, HelpStr) \
     { SwStr1, SwStr2, OPT_SW, VALTYPE_DECIMAL, {.ValSize=SIZE32}, NULL, {.pUint32=ValueRetPtr}, HelpStr},
+#define SWTABLE_OPT_DEC64(SwStr1, SwStr2, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, OPT_SW, VALTYPE_DECIMAL, {.ValSize=SIZE64}, NULL, {.pUint64=ValueRetPtr}, HelpStr},
 
 #define SWTABLE_MAN_DEC(SwStr1, SwStr2, ValueRetPtr, HelpStr) \
     { SwStr1, SwStr2, MAN_SW, VALTYPE_DECIMAL, {.ValSize=SIZEN}, NULL, {.pUintn=ValueRetPtr}, HelpStr},
@@ -208,6 +383,8 @@ extern "C" {
     { SwStr1, SwStr2, MAN_SW, VALTYPE_DECIMAL, {.ValSize=SIZE16}, NULL, {.pUint16=ValueRetPtr}, HelpStr},
 #define SWTABLE_MAN_DEC32(SwStr1, SwStr2, ValueRetPtr, HelpStr) \
     { SwStr1, SwStr2, MAN_SW, VALTYPE_DECIMAL, {.ValSize=SIZE32}, NULL, {.pUint32=ValueRetPtr}, HelpStr},
+#define SWTABLE_MAN_DEC64(SwStr1, SwStr2, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, MAN_SW, VALTYPE_DECIMAL, {.ValSize=SIZE64}, NULL, {.pUint64=ValueRetPtr}, HelpStr},
 
 #define SWTABLE_OPT_DEC_FLGD(SwStr1, SwStr2, PresentPtr, ValueRetPtr, HelpStr) \
     { SwStr1, SwStr2, OPT_SW, VALTYPE_DECIMAL, {.ValSize=SIZEN}, PresentPtr, {.pUintn=ValueRetPtr}, HelpStr},
@@ -217,6 +394,8 @@ extern "C" {
     { SwStr1, SwStr2, OPT_SW, VALTYPE_DECIMAL, {.ValSize=SIZE16}, PresentPtr, {.pUint16=ValueRetPtr}, HelpStr},
 #define SWTABLE_OPT_DEC32_FLGD(SwStr1, SwStr2, PresentPtr, ValueRetPtr, HelpStr) \
     { SwStr1, SwStr2, OPT_SW, VALTYPE_DECIMAL, {.ValSize=SIZE32}, PresentPtr, {.pUint32=ValueRetPtr}, HelpStr},
+#define SWTABLE_OPT_DEC64_FLGD(SwStr1, SwStr2, PresentPtr, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, OPT_SW, VALTYPE_DECIMAL, {.ValSize=SIZE64}, PresentPtr, {.pUint64=ValueRetPtr}, HelpStr},
 
 #define SWTABLE_MAN_DEC_FLGD(SwStr1, SwStr2, PresentPtr, ValueRetPtr, HelpStr) \
     { SwStr1, SwStr2, MAN_SW, VALTYPE_DECIMAL, {.ValSize=SIZEN}, PresentPtr, {.pUintn=ValueRetPtr}, HelpStr},
@@ -226,6 +405,8 @@ extern "C" {
     { SwStr1, SwStr2, MAN_SW, VALTYPE_DECIMAL, {.ValSize=SIZE16}, PresentPtr, {.pUint16=ValueRetPtr}, HelpStr},
 #define SWTABLE_MAN_DEC32_FLGD(SwStr1, SwStr2, PresentPtr, ValueRetPtr, HelpStr) \
     { SwStr1, SwStr2, MAN_SW, VALTYPE_DECIMAL, {.ValSize=SIZE32}, PresentPtr, {.pUint32=ValueRetPtr}, HelpStr},
+#define SWTABLE_MAN_DEC64_FLGD(SwStr1, SwStr2, PresentPtr, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, MAN_SW, VALTYPE_DECIMAL, {.ValSize=SIZE64}, PresentPtr, {.pUint64=ValueRetPtr}, HelpStr},
 
 /**
   SWTABLE_OPT_HEX - Adds an optional hexidecimal switch to table
@@ -237,7 +418,7 @@ extern "C" {
   SwStr1        Ptr to CHAR16 defining short switch name
   SwStr2        Ptr to CHAR16 defining long switch name
   PresentPtr    Ptr to BOOLEAN, set to TRUE if switch present
-  ValueRetPtr   Ptr to (UINTN|UINT8|UINT16|UINT32) to hold value entered
+  ValueRetPtr   Ptr to (UINTN|UINT8|UINT16|UINT32|UINT64) to hold value entered
   HelpStr       Ptr to CHAR16 help string for parameter
 **/
 #define SWTABLE_OPT_HEX(SwStr1, SwStr2, ValueRetPtr, HelpStr) \
@@ -248,6 +429,8 @@ extern "C" {
     { SwStr1, SwStr2, OPT_SW, VALTYPE_HEXIDECIMAL, {.ValSize=SIZE16}, NULL, {.pUint16=ValueRetPtr}, HelpStr},
 #define SWTABLE_OPT_HEX32(SwStr1, SwStr2, ValueRetPtr, HelpStr) \
     { SwStr1, SwStr2, OPT_SW, VALTYPE_HEXIDECIMAL, {.ValSize=SIZE32}, NULL, {.pUint32=ValueRetPtr}, HelpStr},
+#define SWTABLE_OPT_HEX64(SwStr1, SwStr2, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, OPT_SW, VALTYPE_HEXIDECIMAL, {.ValSize=SIZE64}, NULL, {.pUint64=ValueRetPtr}, HelpStr},
 
 #define SWTABLE_MAN_HEX(SwStr1, SwStr2, ValueRetPtr, HelpStr) \
     { SwStr1, SwStr2, MAN_SW, VALTYPE_HEXIDECIMAL, {.ValSize=SIZEN}, NULL, {.pUintn=ValueRetPtr}, HelpStr},
@@ -257,6 +440,8 @@ extern "C" {
     { SwStr1, SwStr2, MAN_SW, VALTYPE_HEXIDECIMAL, {.ValSize=SIZE16}, NULL, {.pUint16=ValueRetPtr}, HelpStr},
 #define SWTABLE_MAN_HEX32(SwStr1, SwStr2, ValueRetPtr, HelpStr) \
     { SwStr1, SwStr2, MAN_SW, VALTYPE_HEXIDECIMAL, {.ValSize=SIZE32}, NULL, {.pUint32=ValueRetPtr}, HelpStr},
+#define SWTABLE_MAN_HEX64(SwStr1, SwStr2, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, MAN_SW, VALTYPE_HEXIDECIMAL, {.ValSize=SIZE64}, NULL, {.pUint64=ValueRetPtr}, HelpStr},
 
 #define SWTABLE_OPT_HEX_FLGD(SwStr1, SwStr2, PresentPtr, ValueRetPtr, HelpStr) \
     { SwStr1, SwStr2, OPT_SW, VALTYPE_HEXIDECIMAL, {.ValSize=SIZEN}, PresentPtr, {.pUintn=ValueRetPtr}, HelpStr},
@@ -266,6 +451,8 @@ extern "C" {
     { SwStr1, SwStr2, OPT_SW, VALTYPE_HEXIDECIMAL, {.ValSize=SIZE16}, PresentPtr, {.pUint16=ValueRetPtr}, HelpStr},
 #define SWTABLE_OPT_HEX32_FLGD(SwStr1, SwStr2, PresentPtr, ValueRetPtr, HelpStr) \
     { SwStr1, SwStr2, OPT_SW, VALTYPE_HEXIDECIMAL, {.ValSize=SIZE32}, PresentPtr, {.pUint32=ValueRetPtr}, HelpStr},
+#define SWTABLE_OPT_HEX64_FLGD(SwStr1, SwStr2, PresentPtr, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, OPT_SW, VALTYPE_HEXIDECIMAL, {.ValSize=SIZE64}, PresentPtr, {.pUint64=ValueRetPtr}, HelpStr},
 
 #define SWTABLE_MAN_HEX_FLGD(SwStr1, SwStr2, PresentPtr, ValueRetPtr, HelpStr) \
     { SwStr1, SwStr2, MAN_SW, VALTYPE_HEXIDECIMAL, {.ValSize=SIZEN}, PresentPtr, {.pUintn=ValueRetPtr}, HelpStr},
@@ -275,6 +462,8 @@ extern "C" {
     { SwStr1, SwStr2, MAN_SW, VALTYPE_HEXIDECIMAL, {.ValSize=SIZE16}, PresentPtr, {.pUint16=ValueRetPtr}, HelpStr},
 #define SWTABLE_MAN_HEX32_FLGD(SwStr1, SwStr2, PresentPtr, ValueRetPtr, HelpStr) \
     { SwStr1, SwStr2, MAN_SW, VALTYPE_HEXIDECIMAL, {.ValSize=SIZE32}, PresentPtr, {.pUint32=ValueRetPtr}, HelpStr},
+#define SWTABLE_MAN_HEX64_FLGD(SwStr1, SwStr2, PresentPtr, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, MAN_SW, VALTYPE_HEXIDECIMAL, {.ValSize=SIZE64}, PresentPtr, {.pUint64=ValueRetPtr}, HelpStr},
 
 /**
   SWTABLE_OPT_INT - Adds an optional integer (decimal or hex) switch to table
@@ -286,7 +475,7 @@ extern "C" {
   SwStr1        Ptr to CHAR16 defining short switch name
   SwStr2        Ptr to CHAR16 defining long switch name
   PresentPtr    Ptr to BOOLEAN, set to TRUE if switch present
-  ValueRetPtr   Ptr to UINTN to hold value entered
+  ValueRetPtr   Ptr to (UINTN|UINT8|UINT16|UINT32|UINT64) to hold value entered
   HelpStr       Ptr to CHAR16 help string for parameter
 **/
 #define SWTABLE_OPT_INT(SwStr1, SwStr2, ValueRetPtr, HelpStr) \
@@ -297,6 +486,8 @@ extern "C" {
     { SwStr1, SwStr2, OPT_SW, VALTYPE_INTEGER, {.ValSize=SIZE16}, NULL, {.pUint16=ValueRetPtr}, HelpStr},
 #define SWTABLE_OPT_INT32(SwStr1, SwStr2, ValueRetPtr, HelpStr) \
     { SwStr1, SwStr2, OPT_SW, VALTYPE_INTEGER, {.ValSize=SIZE32}, NULL, {.pUint32=ValueRetPtr}, HelpStr},
+#define SWTABLE_OPT_INT64(SwStr1, SwStr2, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, OPT_SW, VALTYPE_INTEGER, {.ValSize=SIZE64}, NULL, {.pUint64=ValueRetPtr}, HelpStr},
 
 #define SWTABLE_MAN_INT(SwStr1, SwStr2, ValueRetPtr, HelpStr) \
     { SwStr1, SwStr2, MAN_SW, VALTYPE_INTEGER, {.ValSize=SIZEN}, NULL, {.pUintn=ValueRetPtr}, HelpStr},
@@ -306,6 +497,8 @@ extern "C" {
     { SwStr1, SwStr2, MAN_SW, VALTYPE_INTEGER, {.ValSize=SIZE16}, NULL, {.pUint16=ValueRetPtr}, HelpStr},
 #define SWTABLE_MAN_INT32(SwStr1, SwStr2, ValueRetPtr, HelpStr) \
     { SwStr1, SwStr2, MAN_SW, VALTYPE_INTEGER, {.ValSize=SIZE32}, NULL, {.pUint32=ValueRetPtr}, HelpStr},
+#define SWTABLE_MAN_INT64(SwStr1, SwStr2, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, MAN_SW, VALTYPE_INTEGER, {.ValSize=SIZE64}, NULL, {.pUint64=ValueRetPtr}, HelpStr},
 
 #define SWTABLE_OPT_INT_FLGD(SwStr1, SwStr2, PresentPtr, ValueRetPtr, HelpStr) \
     { SwStr1, SwStr2, OPT_SW, VALTYPE_INTEGER, {.ValSize=SIZEN}, PresentPtr, {.pUintn=ValueRetPtr}, HelpStr},
@@ -315,6 +508,8 @@ extern "C" {
     { SwStr1, SwStr2, OPT_SW, VALTYPE_INTEGER, {.ValSize=SIZE16}, PresentPtr, {.pUint16=ValueRetPtr}, HelpStr},
 #define SWTABLE_OPT_INT32_FLGD(SwStr1, SwStr2, PresentPtr, ValueRetPtr, HelpStr) \
     { SwStr1, SwStr2, OPT_SW, VALTYPE_INTEGER, {.ValSize=SIZE32}, PresentPtr, {.pUint32=ValueRetPtr}, HelpStr},
+#define SWTABLE_OPT_INT64_FLGD(SwStr1, SwStr2, PresentPtr, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, OPT_SW, VALTYPE_INTEGER, {.ValSize=SIZE64}, PresentPtr, {.pUint64=ValueRetPtr}, HelpStr},
 
 #define SWTABLE_MAN_INT_FLGD(SwStr1, SwStr2, PresentPtr, ValueRetPtr, HelpStr) \
     { SwStr1, SwStr2, MAN_SW, VALTYPE_INTEGER, {.ValSize=SIZEN}, PresentPtr, {.pUintn=ValueRetPtr}, HelpStr},
@@ -324,6 +519,248 @@ extern "C" {
     { SwStr1, SwStr2, MAN_SW, VALTYPE_INTEGER, {.ValSize=SIZE16}, PresentPtr, {.pUint16=ValueRetPtr}, HelpStr},
 #define SWTABLE_MAN_INT32_FLGD(SwStr1, SwStr2, PresentPtr, ValueRetPtr, HelpStr) \
     { SwStr1, SwStr2, MAN_SW, VALTYPE_INTEGER, {.ValSize=SIZE32}, PresentPtr, {.pUint32=ValueRetPtr}, HelpStr},
+#define SWTABLE_MAN_INT64_FLGD(SwStr1, SwStr2, PresentPtr, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, MAN_SW, VALTYPE_INTEGER, {.ValSize=SIZE64}, PresentPtr, {.pUint64=ValueRetPtr}, HelpStr},
+
+/**
+  SWTABLE_OPT_SINT - Adds an optional signed integer (decimal or hex, optional sign) switch to table
+  SWTABLE_MAN_SINT - Adds a mandatory signed integer (decimal or hex, optional sign) switch to table
+
+  SWTABLE_OPT_SINT_FLGD - Adds an optional signed integer switch to table + switch presence flag
+  SWTABLE_MAN_SINT_FLGD - Adds a mandatory signed integer switch to table + switch presence flag
+
+  A negative value may follow the switch, e.g. '-offset -8'
+
+  SwStr1        Ptr to CHAR16 defining short switch name
+  SwStr2        Ptr to CHAR16 defining long switch name
+  PresentPtr    Ptr to BOOLEAN, set to TRUE if switch present
+  ValueRetPtr   Ptr to (INTN|INT8|INT16|INT32|INT64) to hold value entered
+  HelpStr       Ptr to CHAR16 help string for parameter
+**/
+#define SWTABLE_OPT_SINT(SwStr1, SwStr2, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, OPT_SW, VALTYPE_SIGNED, {.ValSize=SIZEN}, NULL, {.pIntn=ValueRetPtr}, HelpStr},
+#define SWTABLE_OPT_SINT8(SwStr1, SwStr2, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, OPT_SW, VALTYPE_SIGNED, {.ValSize=SIZE8}, NULL, {.pInt8=ValueRetPtr}, HelpStr},
+#define SWTABLE_OPT_SINT16(SwStr1, SwStr2, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, OPT_SW, VALTYPE_SIGNED, {.ValSize=SIZE16}, NULL, {.pInt16=ValueRetPtr}, HelpStr},
+#define SWTABLE_OPT_SINT32(SwStr1, SwStr2, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, OPT_SW, VALTYPE_SIGNED, {.ValSize=SIZE32}, NULL, {.pInt32=ValueRetPtr}, HelpStr},
+#define SWTABLE_OPT_SINT64(SwStr1, SwStr2, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, OPT_SW, VALTYPE_SIGNED, {.ValSize=SIZE64}, NULL, {.pInt64=ValueRetPtr}, HelpStr},
+
+#define SWTABLE_MAN_SINT(SwStr1, SwStr2, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, MAN_SW, VALTYPE_SIGNED, {.ValSize=SIZEN}, NULL, {.pIntn=ValueRetPtr}, HelpStr},
+#define SWTABLE_MAN_SINT8(SwStr1, SwStr2, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, MAN_SW, VALTYPE_SIGNED, {.ValSize=SIZE8}, NULL, {.pInt8=ValueRetPtr}, HelpStr},
+#define SWTABLE_MAN_SINT16(SwStr1, SwStr2, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, MAN_SW, VALTYPE_SIGNED, {.ValSize=SIZE16}, NULL, {.pInt16=ValueRetPtr}, HelpStr},
+#define SWTABLE_MAN_SINT32(SwStr1, SwStr2, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, MAN_SW, VALTYPE_SIGNED, {.ValSize=SIZE32}, NULL, {.pInt32=ValueRetPtr}, HelpStr},
+#define SWTABLE_MAN_SINT64(SwStr1, SwStr2, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, MAN_SW, VALTYPE_SIGNED, {.ValSize=SIZE64}, NULL, {.pInt64=ValueRetPtr}, HelpStr},
+
+#define SWTABLE_OPT_SINT_FLGD(SwStr1, SwStr2, PresentPtr, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, OPT_SW, VALTYPE_SIGNED, {.ValSize=SIZEN}, PresentPtr, {.pIntn=ValueRetPtr}, HelpStr},
+#define SWTABLE_OPT_SINT8_FLGD(SwStr1, SwStr2, PresentPtr, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, OPT_SW, VALTYPE_SIGNED, {.ValSize=SIZE8}, PresentPtr, {.pInt8=ValueRetPtr}, HelpStr},
+#define SWTABLE_OPT_SINT16_FLGD(SwStr1, SwStr2, PresentPtr, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, OPT_SW, VALTYPE_SIGNED, {.ValSize=SIZE16}, PresentPtr, {.pInt16=ValueRetPtr}, HelpStr},
+#define SWTABLE_OPT_SINT32_FLGD(SwStr1, SwStr2, PresentPtr, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, OPT_SW, VALTYPE_SIGNED, {.ValSize=SIZE32}, PresentPtr, {.pInt32=ValueRetPtr}, HelpStr},
+#define SWTABLE_OPT_SINT64_FLGD(SwStr1, SwStr2, PresentPtr, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, OPT_SW, VALTYPE_SIGNED, {.ValSize=SIZE64}, PresentPtr, {.pInt64=ValueRetPtr}, HelpStr},
+
+#define SWTABLE_MAN_SINT_FLGD(SwStr1, SwStr2, PresentPtr, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, MAN_SW, VALTYPE_SIGNED, {.ValSize=SIZEN}, PresentPtr, {.pIntn=ValueRetPtr}, HelpStr},
+#define SWTABLE_MAN_SINT8_FLGD(SwStr1, SwStr2, PresentPtr, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, MAN_SW, VALTYPE_SIGNED, {.ValSize=SIZE8}, PresentPtr, {.pInt8=ValueRetPtr}, HelpStr},
+#define SWTABLE_MAN_SINT16_FLGD(SwStr1, SwStr2, PresentPtr, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, MAN_SW, VALTYPE_SIGNED, {.ValSize=SIZE16}, PresentPtr, {.pInt16=ValueRetPtr}, HelpStr},
+#define SWTABLE_MAN_SINT32_FLGD(SwStr1, SwStr2, PresentPtr, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, MAN_SW, VALTYPE_SIGNED, {.ValSize=SIZE32}, PresentPtr, {.pInt32=ValueRetPtr}, HelpStr},
+#define SWTABLE_MAN_SINT64_FLGD(SwStr1, SwStr2, PresentPtr, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, MAN_SW, VALTYPE_SIGNED, {.ValSize=SIZE64}, PresentPtr, {.pInt64=ValueRetPtr}, HelpStr},
+
+/**
+  SWTABLE_OPT_SIZE - Adds an optional size switch to table, stored in bytes
+  SWTABLE_MAN_SIZE - Adds a mandatory size switch to table, stored in bytes
+
+  SWTABLE_OPT_SIZE_FLGD - Adds an optional size switch to table + switch presence flag
+  SWTABLE_MAN_SIZE_FLGD - Adds a mandatory size switch to table + switch presence flag
+
+  Values are e.g. 4K, 1.5G; suffixes B, K, M, G, T, P, E (binary multiples)
+  A '0x' prefixed hex value takes no suffix, so 0x1B is 27 bytes
+
+  SwStr1        Ptr to CHAR16 defining short switch name
+  SwStr2        Ptr to CHAR16 defining long switch name
+  PresentPtr    Ptr to BOOLEAN, set to TRUE if switch present
+  ValueRetPtr   Ptr to (UINTN|UINT32|UINT64) to hold value entered
+  HelpStr       Ptr to CHAR16 help string for parameter
+**/
+#define SWTABLE_OPT_SIZE(SwStr1, SwStr2, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, OPT_SW, VALTYPE_SIZE, {.ValSize=SIZEN}, NULL, {.pUintn=ValueRetPtr}, HelpStr},
+#define SWTABLE_OPT_SIZE32(SwStr1, SwStr2, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, OPT_SW, VALTYPE_SIZE, {.ValSize=SIZE32}, NULL, {.pUint32=ValueRetPtr}, HelpStr},
+#define SWTABLE_OPT_SIZE64(SwStr1, SwStr2, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, OPT_SW, VALTYPE_SIZE, {.ValSize=SIZE64}, NULL, {.pUint64=ValueRetPtr}, HelpStr},
+
+#define SWTABLE_MAN_SIZE(SwStr1, SwStr2, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, MAN_SW, VALTYPE_SIZE, {.ValSize=SIZEN}, NULL, {.pUintn=ValueRetPtr}, HelpStr},
+#define SWTABLE_MAN_SIZE32(SwStr1, SwStr2, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, MAN_SW, VALTYPE_SIZE, {.ValSize=SIZE32}, NULL, {.pUint32=ValueRetPtr}, HelpStr},
+#define SWTABLE_MAN_SIZE64(SwStr1, SwStr2, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, MAN_SW, VALTYPE_SIZE, {.ValSize=SIZE64}, NULL, {.pUint64=ValueRetPtr}, HelpStr},
+
+#define SWTABLE_OPT_SIZE_FLGD(SwStr1, SwStr2, PresentPtr, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, OPT_SW, VALTYPE_SIZE, {.ValSize=SIZEN}, PresentPtr, {.pUintn=ValueRetPtr}, HelpStr},
+#define SWTABLE_OPT_SIZE32_FLGD(SwStr1, SwStr2, PresentPtr, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, OPT_SW, VALTYPE_SIZE, {.ValSize=SIZE32}, PresentPtr, {.pUint32=ValueRetPtr}, HelpStr},
+#define SWTABLE_OPT_SIZE64_FLGD(SwStr1, SwStr2, PresentPtr, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, OPT_SW, VALTYPE_SIZE, {.ValSize=SIZE64}, PresentPtr, {.pUint64=ValueRetPtr}, HelpStr},
+
+#define SWTABLE_MAN_SIZE_FLGD(SwStr1, SwStr2, PresentPtr, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, MAN_SW, VALTYPE_SIZE, {.ValSize=SIZEN}, PresentPtr, {.pUintn=ValueRetPtr}, HelpStr},
+#define SWTABLE_MAN_SIZE32_FLGD(SwStr1, SwStr2, PresentPtr, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, MAN_SW, VALTYPE_SIZE, {.ValSize=SIZE32}, PresentPtr, {.pUint32=ValueRetPtr}, HelpStr},
+#define SWTABLE_MAN_SIZE64_FLGD(SwStr1, SwStr2, PresentPtr, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, MAN_SW, VALTYPE_SIZE, {.ValSize=SIZE64}, PresentPtr, {.pUint64=ValueRetPtr}, HelpStr},
+
+/**
+  SWTABLE_OPT_TIME - Adds an optional time switch to table, stored in nanoseconds
+  SWTABLE_MAN_TIME - Adds a mandatory time switch to table, stored in nanoseconds
+
+  SWTABLE_OPT_TIME_FLGD - Adds an optional time switch to table + switch presence flag
+  SWTABLE_MAN_TIME_FLGD - Adds a mandatory time switch to table + switch presence flag
+
+  Values are e.g. 250us, 2s; suffixes ns, us, ms, s
+
+  SwStr1        Ptr to CHAR16 defining short switch name
+  SwStr2        Ptr to CHAR16 defining long switch name
+  PresentPtr    Ptr to BOOLEAN, set to TRUE if switch present
+  ValueRetPtr   Ptr to (UINTN|UINT32|UINT64) to hold value entered
+  HelpStr       Ptr to CHAR16 help string for parameter
+**/
+#define SWTABLE_OPT_TIME(SwStr1, SwStr2, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, OPT_SW, VALTYPE_TIME, {.ValSize=SIZEN}, NULL, {.pUintn=ValueRetPtr}, HelpStr},
+#define SWTABLE_OPT_TIME32(SwStr1, SwStr2, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, OPT_SW, VALTYPE_TIME, {.ValSize=SIZE32}, NULL, {.pUint32=ValueRetPtr}, HelpStr},
+#define SWTABLE_OPT_TIME64(SwStr1, SwStr2, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, OPT_SW, VALTYPE_TIME, {.ValSize=SIZE64}, NULL, {.pUint64=ValueRetPtr}, HelpStr},
+
+#define SWTABLE_MAN_TIME(SwStr1, SwStr2, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, MAN_SW, VALTYPE_TIME, {.ValSize=SIZEN}, NULL, {.pUintn=ValueRetPtr}, HelpStr},
+#define SWTABLE_MAN_TIME32(SwStr1, SwStr2, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, MAN_SW, VALTYPE_TIME, {.ValSize=SIZE32}, NULL, {.pUint32=ValueRetPtr}, HelpStr},
+#define SWTABLE_MAN_TIME64(SwStr1, SwStr2, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, MAN_SW, VALTYPE_TIME, {.ValSize=SIZE64}, NULL, {.pUint64=ValueRetPtr}, HelpStr},
+
+#define SWTABLE_OPT_TIME_FLGD(SwStr1, SwStr2, PresentPtr, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, OPT_SW, VALTYPE_TIME, {.ValSize=SIZEN}, PresentPtr, {.pUintn=ValueRetPtr}, HelpStr},
+#define SWTABLE_OPT_TIME32_FLGD(SwStr1, SwStr2, PresentPtr, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, OPT_SW, VALTYPE_TIME, {.ValSize=SIZE32}, PresentPtr, {.pUint32=ValueRetPtr}, HelpStr},
+#define SWTABLE_OPT_TIME64_FLGD(SwStr1, SwStr2, PresentPtr, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, OPT_SW, VALTYPE_TIME, {.ValSize=SIZE64}, PresentPtr, {.pUint64=ValueRetPtr}, HelpStr},
+
+#define SWTABLE_MAN_TIME_FLGD(SwStr1, SwStr2, PresentPtr, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, MAN_SW, VALTYPE_TIME, {.ValSize=SIZEN}, PresentPtr, {.pUintn=ValueRetPtr}, HelpStr},
+#define SWTABLE_MAN_TIME32_FLGD(SwStr1, SwStr2, PresentPtr, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, MAN_SW, VALTYPE_TIME, {.ValSize=SIZE32}, PresentPtr, {.pUint32=ValueRetPtr}, HelpStr},
+#define SWTABLE_MAN_TIME64_FLGD(SwStr1, SwStr2, PresentPtr, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, MAN_SW, VALTYPE_TIME, {.ValSize=SIZE64}, PresentPtr, {.pUint64=ValueRetPtr}, HelpStr},
+
+/**
+  SWTABLE_OPT_FREQ - Adds an optional frequency switch to table, stored in hertz
+  SWTABLE_MAN_FREQ - Adds a mandatory frequency switch to table, stored in hertz
+
+  SWTABLE_OPT_FREQ_FLGD - Adds an optional frequency switch to table + switch presence flag
+  SWTABLE_MAN_FREQ_FLGD - Adds a mandatory frequency switch to table + switch presence flag
+
+  Values are e.g. 2.4GHz; suffixes Hz, kHz, MHz, GHz
+
+  SwStr1        Ptr to CHAR16 defining short switch name
+  SwStr2        Ptr to CHAR16 defining long switch name
+  PresentPtr    Ptr to BOOLEAN, set to TRUE if switch present
+  ValueRetPtr   Ptr to (UINTN|UINT32|UINT64) to hold value entered
+  HelpStr       Ptr to CHAR16 help string for parameter
+**/
+#define SWTABLE_OPT_FREQ(SwStr1, SwStr2, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, OPT_SW, VALTYPE_FREQ, {.ValSize=SIZEN}, NULL, {.pUintn=ValueRetPtr}, HelpStr},
+#define SWTABLE_OPT_FREQ32(SwStr1, SwStr2, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, OPT_SW, VALTYPE_FREQ, {.ValSize=SIZE32}, NULL, {.pUint32=ValueRetPtr}, HelpStr},
+#define SWTABLE_OPT_FREQ64(SwStr1, SwStr2, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, OPT_SW, VALTYPE_FREQ, {.ValSize=SIZE64}, NULL, {.pUint64=ValueRetPtr}, HelpStr},
+
+#define SWTABLE_MAN_FREQ(SwStr1, SwStr2, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, MAN_SW, VALTYPE_FREQ, {.ValSize=SIZEN}, NULL, {.pUintn=ValueRetPtr}, HelpStr},
+#define SWTABLE_MAN_FREQ32(SwStr1, SwStr2, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, MAN_SW, VALTYPE_FREQ, {.ValSize=SIZE32}, NULL, {.pUint32=ValueRetPtr}, HelpStr},
+#define SWTABLE_MAN_FREQ64(SwStr1, SwStr2, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, MAN_SW, VALTYPE_FREQ, {.ValSize=SIZE64}, NULL, {.pUint64=ValueRetPtr}, HelpStr},
+
+#define SWTABLE_OPT_FREQ_FLGD(SwStr1, SwStr2, PresentPtr, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, OPT_SW, VALTYPE_FREQ, {.ValSize=SIZEN}, PresentPtr, {.pUintn=ValueRetPtr}, HelpStr},
+#define SWTABLE_OPT_FREQ32_FLGD(SwStr1, SwStr2, PresentPtr, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, OPT_SW, VALTYPE_FREQ, {.ValSize=SIZE32}, PresentPtr, {.pUint32=ValueRetPtr}, HelpStr},
+#define SWTABLE_OPT_FREQ64_FLGD(SwStr1, SwStr2, PresentPtr, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, OPT_SW, VALTYPE_FREQ, {.ValSize=SIZE64}, PresentPtr, {.pUint64=ValueRetPtr}, HelpStr},
+
+#define SWTABLE_MAN_FREQ_FLGD(SwStr1, SwStr2, PresentPtr, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, MAN_SW, VALTYPE_FREQ, {.ValSize=SIZEN}, PresentPtr, {.pUintn=ValueRetPtr}, HelpStr},
+#define SWTABLE_MAN_FREQ32_FLGD(SwStr1, SwStr2, PresentPtr, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, MAN_SW, VALTYPE_FREQ, {.ValSize=SIZE32}, PresentPtr, {.pUint32=ValueRetPtr}, HelpStr},
+#define SWTABLE_MAN_FREQ64_FLGD(SwStr1, SwStr2, PresentPtr, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, MAN_SW, VALTYPE_FREQ, {.ValSize=SIZE64}, PresentPtr, {.pUint64=ValueRetPtr}, HelpStr},
+
+/**
+  SWTABLE_OPT_BITMAP - Adds an optional bitmap switch to table
+  SWTABLE_MAN_BITMAP - Adds a mandatory bitmap switch to table
+
+  SWTABLE_OPT_BITMAP_FLGD - Adds an optional bitmap switch to table + switch presence flag
+  SWTABLE_MAN_BITMAP_FLGD - Adds a mandatory bitmap switch to table + switch presence flag
+
+  Values are as for PARAMTABLE_BITMAP
+
+  SwStr1        Ptr to CHAR16 defining short switch name
+  SwStr2        Ptr to CHAR16 defining long switch name
+  PresentPtr    Ptr to BOOLEAN, set to TRUE if switch present
+  ValueRetPtr   Ptr to UINTN array of CMDLINE_BITMAP_WORDS(Bits) words to hold values entered
+  Bits          Number of bits in bitmap, values must be below this
+  HelpStr       Ptr to CHAR16 help string for parameter
+**/
+#define SWTABLE_OPT_BITMAP(SwStr1, SwStr2, ValueRetPtr, Bits, HelpStr) \
+    { SwStr1, SwStr2, OPT_SW, VALTYPE_BITMAP, {.BitCount=CMDLINE_CHECKED(Bits, (Bits) > 0)}, NULL, {.pBitmap=ValueRetPtr}, HelpStr},
+#define SWTABLE_MAN_BITMAP(SwStr1, SwStr2, ValueRetPtr, Bits, HelpStr) \
+    { SwStr1, SwStr2, MAN_SW, VALTYPE_BITMAP, {.BitCount=CMDLINE_CHECKED(Bits, (Bits) > 0)}, NULL, {.pBitmap=ValueRetPtr}, HelpStr},
+
+#define SWTABLE_OPT_BITMAP_FLGD(SwStr1, SwStr2, PresentPtr, ValueRetPtr, Bits, HelpStr) \
+    { SwStr1, SwStr2, OPT_SW, VALTYPE_BITMAP, {.BitCount=CMDLINE_CHECKED(Bits, (Bits) > 0)}, PresentPtr, {.pBitmap=ValueRetPtr}, HelpStr},
+#define SWTABLE_MAN_BITMAP_FLGD(SwStr1, SwStr2, PresentPtr, ValueRetPtr, Bits, HelpStr) \
+    { SwStr1, SwStr2, MAN_SW, VALTYPE_BITMAP, {.BitCount=CMDLINE_CHECKED(Bits, (Bits) > 0)}, PresentPtr, {.pBitmap=ValueRetPtr}, HelpStr},
+
+/**
+  SWTABLE_OPT_RANGES - Adds an optional range list switch to table
+  SWTABLE_MAN_RANGES - Adds a mandatory range list switch to table
+
+  SWTABLE_OPT_RANGES_FLGD - Adds an optional range list switch to table + switch presence flag
+  SWTABLE_MAN_RANGES_FLGD - Adds a mandatory range list switch to table + switch presence flag
+
+  Values are as for PARAMTABLE_RANGES
+
+  SwStr1        Ptr to CHAR16 defining short switch name
+  SwStr2        Ptr to CHAR16 defining long switch name
+  PresentPtr    Ptr to BOOLEAN, set to TRUE if switch present
+  ValueRetPtr   Ptr to CMDLINE_RANGE_LIST to hold sorted, merged ranges entered
+  HelpStr       Ptr to CHAR16 help string for parameter
+**/
+#define SWTABLE_OPT_RANGES(SwStr1, SwStr2, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, OPT_SW, VALTYPE_RANGES, {0}, NULL, {.pRangeList=ValueRetPtr}, HelpStr},
+#define SWTABLE_MAN_RANGES(SwStr1, SwStr2, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, MAN_SW, VALTYPE_RANGES, {0}, NULL, {.pRangeList=ValueRetPtr}, HelpStr},
+
+#define SWTABLE_OPT_RANGES_FLGD(SwStr1, SwStr2, PresentPtr, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, OPT_SW, VALTYPE_RANGES, {0}, PresentPtr, {.pRangeList=ValueRetPtr}, HelpStr},
+#define SWTABLE_MAN_RANGES_FLGD(SwStr1, SwStr2, PresentPtr, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, MAN_SW, VALTYPE_RANGES, {0}, PresentPtr, {.pRangeList=ValueRetPtr}, HelpStr},
 
 /**
   SWTABLE_OPT_ENUM - Adds an optional enum switch to table (string entry)
@@ -349,12 +786,356 @@ extern "C" {
 #define SWTABLE_MAN_ENUM_FLGD(SwStr1, SwStr2, EnumArray, PresentPtr, ValueRetPtr, HelpStr) \
     { SwStr1, SwStr2, MAN_SW, VALTYPE_ENUM, {.EnumStrArray=EnumArray}, PresentPtr, {.pEnum=(unsigned int *)ValueRetPtr}, HelpStr},
 
+/**
+  SWTABLE_OPT_ENUM_SET - Adds an optional enum set switch to table (comma separated string entries)
+  SWTABLE_MAN_ENUM_SET - Adds a mandatory enum set switch to table (comma separated string entries)
+
+  SWTABLE_OPT_ENUM_SET_FLGD - Adds an optional enum set switch to table + switch presence flag
+  SWTABLE_MAN_ENUM_SET_FLGD - Adds a mandatory enum set switch to table + switch presence flag
+
+  The value is a list of enum strings, 'all' or 'none' (e.g. "all,^debug"), read from left to
+  right; a string ORs its value into the set, and removes it if preceded by '^'
+
+  SwStr1        Ptr to CHAR16 defining short switch name
+  SwStr2        Ptr to CHAR16 defining long switch name
+  PresentPtr    Ptr to BOOLEAN, set to TRUE if switch present
+  ValueRetPtr   Ptr to UINT64 to hold the values of the strings entered ORed together
+  EnumArray     Ptr to array defining enum value (a bit mask) to string
+  HelpStr       Ptr to CHAR16 help string for parameter
+**/
+#define SWTABLE_OPT_ENUM_SET(SwStr1, SwStr2, ValueRetPtr, EnumArray, HelpStr) \
+    { SwStr1, SwStr2, OPT_SW, VALTYPE_ENUM_SET, {.EnumStrArray=EnumArray}, NULL, {.pUint64=ValueRetPtr}, HelpStr},
+#define SWTABLE_MAN_ENUM_SET(SwStr1, SwStr2, ValueRetPtr, EnumArray, HelpStr) \
+    { SwStr1, SwStr2, MAN_SW, VALTYPE_ENUM_SET, {.EnumStrArray=EnumArray}, NULL, {.pUint64=ValueRetPtr}, HelpStr},
+
+#define SWTABLE_OPT_ENUM_SET_FLGD(SwStr1, SwStr2, PresentPtr, ValueRetPtr, EnumArray, HelpStr) \
+    { SwStr1, SwStr2, OPT_SW, VALTYPE_ENUM_SET, {.EnumStrArray=EnumArray}, PresentPtr, {.pUint64=ValueRetPtr}, HelpStr},
+#define SWTABLE_MAN_ENUM_SET_FLGD(SwStr1, SwStr2, PresentPtr, ValueRetPtr, EnumArray, HelpStr) \
+    { SwStr1, SwStr2, MAN_SW, VALTYPE_ENUM_SET, {.EnumStrArray=EnumArray}, PresentPtr, {.pUint64=ValueRetPtr}, HelpStr},
+
+/**
+  SWTABLE_OPT_DEC_LIST - Adds an optional decimal list switch to table
+  SWTABLE_OPT_HEX_LIST - Adds an optional hexidecimal list switch to table
+  SWTABLE_OPT_INT_LIST - Adds an optional integer (decimal or hex) list switch to table
+  SWTABLE_OPT_STR_LIST - Adds an optional string list switch to table
+  SWTABLE_MAN_..._LIST - Adds a mandatory list switch to table
+
+  SWTABLE_OPT_..._LIST_FLGD - Adds an optional list switch to table + switch presence flag
+  SWTABLE_MAN_..._LIST_FLGD - Adds a mandatory list switch to table + switch presence flag
+
+  The switch may be repeated, each value is added to the list
+
+  SwStr1        Ptr to CHAR16 defining short switch name
+  SwStr2        Ptr to CHAR16 defining long switch name
+  PresentPtr    Ptr to BOOLEAN, set to TRUE if switch present
+  ValueRetPtr   Ptr to CMDLINE_LIST to hold values entered, as UINTN or CONST CHAR16 ptrs;
+                values remain valid until CmdLineFree()
+  HelpStr       Ptr to CHAR16 help string for parameter
+**/
+#define SWTABLE_OPT_DEC_LIST(SwStr1, SwStr2, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, OPT_SW, VALTYPE_DEC_LIST, {0}, NULL, {.pList=ValueRetPtr}, HelpStr},
+#define SWTABLE_OPT_HEX_LIST(SwStr1, SwStr2, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, OPT_SW, VALTYPE_HEX_LIST, {0}, NULL, {.pList=ValueRetPtr}, HelpStr},
+#define SWTABLE_OPT_INT_LIST(SwStr1, SwStr2, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, OPT_SW, VALTYPE_INT_LIST, {0}, NULL, {.pList=ValueRetPtr}, HelpStr},
+#define SWTABLE_OPT_STR_LIST(SwStr1, SwStr2, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, OPT_SW, VALTYPE_STR_LIST, {0}, NULL, {.pList=ValueRetPtr}, HelpStr},
+
+#define SWTABLE_MAN_DEC_LIST(SwStr1, SwStr2, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, MAN_SW, VALTYPE_DEC_LIST, {0}, NULL, {.pList=ValueRetPtr}, HelpStr},
+#define SWTABLE_MAN_HEX_LIST(SwStr1, SwStr2, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, MAN_SW, VALTYPE_HEX_LIST, {0}, NULL, {.pList=ValueRetPtr}, HelpStr},
+#define SWTABLE_MAN_INT_LIST(SwStr1, SwStr2, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, MAN_SW, VALTYPE_INT_LIST, {0}, NULL, {.pList=ValueRetPtr}, HelpStr},
+#define SWTABLE_MAN_STR_LIST(SwStr1, SwStr2, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, MAN_SW, VALTYPE_STR_LIST, {0}, NULL, {.pList=ValueRetPtr}, HelpStr},
+
+#define SWTABLE_OPT_DEC_LIST_FLGD(SwStr1, SwStr2, PresentPtr, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, OPT_SW, VALTYPE_DEC_LIST, {0}, PresentPtr, {.pList=ValueRetPtr}, HelpStr},
+#define SWTABLE_OPT_HEX_LIST_FLGD(SwStr1, SwStr2, PresentPtr, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, OPT_SW, VALTYPE_HEX_LIST, {0}, PresentPtr, {.pList=ValueRetPtr}, HelpStr},
+#define SWTABLE_OPT_INT_LIST_FLGD(SwStr1, SwStr2, PresentPtr, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, OPT_SW, VALTYPE_INT_LIST, {0}, PresentPtr, {.pList=ValueRetPtr}, HelpStr},
+#define SWTABLE_OPT_STR_LIST_FLGD(SwStr1, SwStr2, PresentPtr, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, OPT_SW, VALTYPE_STR_LIST, {0}, PresentPtr, {.pList=ValueRetPtr}, HelpStr},
+
+#define SWTABLE_MAN_DEC_LIST_FLGD(SwStr1, SwStr2, PresentPtr, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, MAN_SW, VALTYPE_DEC_LIST, {0}, PresentPtr, {.pList=ValueRetPtr}, HelpStr},
+#define SWTABLE_MAN_HEX_LIST_FLGD(SwStr1, SwStr2, PresentPtr, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, MAN_SW, VALTYPE_HEX_LIST, {0}, PresentPtr, {.pList=ValueRetPtr}, HelpStr},
+#define SWTABLE_MAN_INT_LIST_FLGD(SwStr1, SwStr2, PresentPtr, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, MAN_SW, VALTYPE_INT_LIST, {0}, PresentPtr, {.pList=ValueRetPtr}, HelpStr},
+#define SWTABLE_MAN_STR_LIST_FLGD(SwStr1, SwStr2, PresentPtr, ValueRetPtr, HelpStr) \
+    { SwStr1, SwStr2, MAN_SW, VALTYPE_STR_LIST, {0}, PresentPtr, {.pList=ValueRetPtr}, HelpStr},
+
+/**
+  Switch constraints, checked once the command line has been parsed. Constraints must follow
+  all of the switches in the table, and name them by either their short or long name.
+
+  SWTABLE_REQUIRES  - If switch is entered, all of the listed switches must also be entered
+  SWTABLE_CONFLICTS - If switch is entered, none of the listed switches may be entered
+  SWTABLE_ONE_OF    - Exactly one of the listed switches must be entered
+
+  SwStr         Ptr to CHAR16 naming switch
+  SwList        Ptr to CHAR16 naming switches, separated by spaces (e.g. L"-r -w -v")
+**/
+#define SWTABLE_REQUIRES(SwStr, SwList) \
+    { SwStr, SwList, REQUIRES_SW, VALTYPE_NONE, {0}, NULL, {0}, NULL},
+#define SWTABLE_CONFLICTS(SwStr, SwList) \
+    { SwStr, SwList, CONFLICTS_SW, VALTYPE_NONE, {0}, NULL, {0}, NULL},
+#define SWTABLE_ONE_OF(SwList) \
+    { NULL, SwList, ONE_OF_SW, VALTYPE_NONE, {0}, NULL, {0}, NULL},
+
 /**
   SWTABLE_END -Ends the switch table
 **/
 #define SWTABLE_END \
     {NULL,NULL,NO_SW,VALTYPE_NONE,{0},NULL,{0},NULL}};
 
+//-------------------------------------
+// Subcommand Table Macros
+//-------------------------------------
+
+/**
+  SUBCMDTABLE_START - Begins the subcommand table, which maps the first argument to the
+                      tables and handler of a subcommand
+
+  ArrayName     Defines name of subcommand table
+**/
+#define SUBCMDTABLE_START(ArrayName) \
+    SUBCMD_TABLE ArrayName[] = {
+
+/**
+  SUBCMDTABLE_ENTRY - Adds a subcommand to table
+
+  Name          Ptr to CHAR16 defining subcommand name (e.g. L"list")
+  ParamTable    Ptr to PARAMETER_TABLE of subcommand; NULL if no parameters
+  ManParmCount  Number of manatory parameters required
+  SwTable       Ptr to SWITCH_TABLE of subcommand; NULL if no switches
+  Handler       SUBCMD_HANDLER called once the command line has been parsed
+  HelpStr       Ptr to CHAR16 help string for subcommand
+**/
+#define SUBCMDTABLE_ENTRY(Name, ParamTable, ManParmCount, SwTable, Handler, HelpStr) \
+    { Name, ParamTable, ManParmCount, SwTable, Handler, HelpStr },
+
+/**
+  SUBCMDTABLE_END - Ends the subcommand table
+**/
+#define SUBCMDTABLE_END \
+    {NULL,NULL,0,NULL,NULL,NULL}};
+
+//-------------------------------------
+// Config Struct Binding
+//-------------------------------------
+
+/**
+  CMDLINE_FIELD - Gives the ValueRetPtr (or PresentPtr) of a table entry as a field of a config
+                  struct rather than an absolute address, so that one table can fill any number
+                  of config structs; tables using it must be parsed with CmdLineParseConfig()
+                  or CmdLineParseArgvConfig()
+
+  Type          Config struct type
+  Field         Field within config struct
+**/
+#define CMDLINE_FIELD_BIAS  1   // keeps a field at offset zero from being a NULL ptr
+#define CMDLINE_FIELD(Type, Field) \
+    ((VOID *)(UINTN)(OFFSET_OF(Type, Field) + CMDLINE_FIELD_BIAS))
+
+//-------------------------------------
+// Generated Parsers
+//-------------------------------------
+
+/**
+  CMDLINE_DEFINE_PARSER - Generates a parser dedicated to one tool from X-macro lists of its
+                          switches and parameters, alongside the table API
+
+  Name          Name of parser; defines the config struct Name_CONFIG, with a field for each
+                switch and parameter, the parse function:
+
+                  SHELL_STATUS Name_Parse(IN UINTN Argc, IN CHAR16 **Argv,
+                                          OUT Name_CONFIG *Config, OUT UINTN *NumParams OPTIONAL)
+
+                and VOID Name_Free(VOID), which frees the table parser kept for the fallback
+
+  SwList        X-macro listing the (optional) switches, each as
+                X(Kind, Type, SwStr1, SwStr2, Field, HelpStr)
+  ParamList     X-macro listing the parameters, each as X(Kind, Type, Field, HelpStr)
+  ManParamCount Number of manatory parameters
+  ProgHelpStr   Ptr to help string for program; NULL if not required
+
+  Kind and Type are one of:
+                FLAG    BOOLEAN                     switch with no value (switches only)
+                STRREF  CMDLINE_STRREF              string, not copied
+                DEC     UINT8|UINT16|UINT32|UINT64  decimal number
+                HEX     UINT8|UINT16|UINT32|UINT64  hexidecimal number
+                INT     UINT8|UINT16|UINT32|UINT64  integer number (decimal or hex)
+                SINT    INT8|INT16|INT32|INT64      signed integer (decimal or hex)
+
+  Switch names are string literals, L"" if not required. The parse function matches switch names by length
+  and first char, and converts each value for its exact kind and size, with no tables involved.
+  Help, break, abbreviated switches, negative values and any error are handed to the table
+  parser, on tables generated from the same lists, so behaviour and messages are as for
+  CmdLineParseArgvConfig(). The table parser is compiled the first time it is needed and kept
+  until Name_Free(). Values entered are stored in Config, other fields are left as is; Config is
+  only written if the parse succeeds.
+
+  e.g.
+    #define TOOL_SWITCHES(X) \
+        X(FLAG, BOOLEAN, L"-v", L"-verbose", Verbose, L"verbose output") \
+        X(INT,  UINT32,  L"-n", L"-count",   Count,   L"[num]repeat count")
+    #define TOOL_PARAMS(X) \
+        X(STRREF, CMDLINE_STRREF, Device, L"[dev]device name")
+    CMDLINE_DEFINE_PARSER(Tool, TOOL_SWITCHES, TOOL_PARAMS, 1, L"Device tool")
+**/
+#define CMDLINE_DEFINE_PARSER(Name, SwList, ParamList, ManParamCount, ProgHelpStr) \
+    typedef struct { \
+        SwList(CMDLINE_GEN_SW_FIELD) \
+        ParamList(CMDLINE_GEN_PARAM_FIELD) \
+    } Name##_CONFIG; \
+    STATIC CMDLINE_PARSER *Name##_Parser = NULL; \
+    VOID Name##_Free(VOID) \
+    { \
+        if (Name##_Parser) { \
+            CmdLineFreeParser(Name##_Parser); \
+            Name##_Parser = NULL; \
+        } \
+    } \
+    SHELL_STATUS Name##_Parse(IN UINTN Argc, IN CHAR16 **Argv, OUT Name##_CONFIG *Config, OUT UINTN *NumParams OPTIONAL) \
+    { \
+        typedef Name##_CONFIG CMDLINE_GEN_CONFIG; \
+        enum { SwList(CMDLINE_GEN_SW_ID) CMDLINE_GEN_SW_COUNT }; \
+        enum { ParamList(CMDLINE_GEN_PARAM_ID) CMDLINE_GEN_PARAM_COUNT }; \
+        STATIC PARAMTABLE_START(ParamTable) ParamList(CMDLINE_GEN_PARAM_ENTRY) PARAMTABLE_END \
+        STATIC SWTABLE_START(SwTable) SwList(CMDLINE_GEN_SW_ENTRY) SWTABLE_END \
+        BOOLEAN Present[CMDLINE_GEN_SW_COUNT + 1] = { 0 }; \
+        UINTN ParamNum = 0; \
+        UINT64 Value = 0; \
+        (VOID)Value; \
+        if (NumParams) { \
+            *NumParams = 0; \
+        } \
+        if (!Config || (Argc && !Argv)) { \
+            return SHELL_INVALID_PARAMETER; \
+        } \
+        Name##_CONFIG Local = *Config; \
+        for (UINTN ArgNum = 1; ArgNum < Argc; ArgNum++) { \
+            CONST CHAR16 *Arg = Argv[ArgNum]; \
+            if ((Arg[0] == L'-') || (Arg[0] == L'/')) { \
+                UINTN Len = StrLen(Arg); \
+                (VOID)Len; \
+                SwList(CMDLINE_GEN_SW_PARSE) \
+                goto Fallback; \
+            } \
+            switch (ParamNum++) { \
+            ParamList(CMDLINE_GEN_PARAM_PARSE) \
+            default: \
+                goto Fallback; \
+            } \
+        } \
+        if (ParamNum < (ManParamCount)) { \
+            goto Fallback; \
+        } \
+        ShellSetPageBreakMode(FALSE); \
+        *Config = Local; \
+        if (NumParams) { \
+            *NumParams = ParamNum; \
+        } \
+        return SHELL_SUCCESS; \
+    Fallback: \
+        { \
+            SHELL_STATUS ShellStatus = SHELL_SUCCESS; \
+            if (!Name##_Parser) { \
+                ShellStatus = CmdLineCompile(ParamTable, ManParamCount, SwTable, ProgHelpStr, 0, &Name##_Parser); \
+            } \
+            if (ShellStatus == SHELL_SUCCESS) { \
+                Local = *Config; \
+                ShellStatus = CmdLineParseArgvConfig(Name##_Parser, Argc, Argv, &Local, NumParams); \
+                if (ShellStatus == SHELL_SUCCESS) { \
+                    *Config = Local; \
+                } \
+            } \
+            return ShellStatus; \
+        } \
+    }
+
+// per entry expansions of CMDLINE_DEFINE_PARSER()
+#define CMDLINE_GEN_SW_FIELD(Kind, Type, SwStr1, SwStr2, Field, HelpStr)    Type Field;
+#define CMDLINE_GEN_PARAM_FIELD(Kind, Type, Field, HelpStr)                 Type Field;
+#define CMDLINE_GEN_SW_ID(Kind, Type, SwStr1, SwStr2, Field, HelpStr)       CmdLineGenSw_##Field,
+#define CMDLINE_GEN_PARAM_ID(Kind, Type, Field, HelpStr)                    CmdLineGenParam_##Field,
+#define CMDLINE_GEN_SW_ENTRY(Kind, Type, SwStr1, SwStr2, Field, HelpStr) \
+    {CMDLINE_GEN_NAME(SwStr1), CMDLINE_GEN_NAME(SwStr2), OPT_SW, CMDLINE_GEN_VALTYPE_##Kind, CMDLINE_GEN_DATA_##Kind(Type), NULL, {.pVoid=CMDLINE_FIELD(CMDLINE_GEN_CONFIG, Field)}, HelpStr},
+#define CMDLINE_GEN_PARAM_ENTRY(Kind, Type, Field, HelpStr) \
+    {CMDLINE_GEN_VALTYPE_##Kind, CMDLINE_GEN_DATA_##Kind(Type), {.pVoid=CMDLINE_FIELD(CMDLINE_GEN_CONFIG, Field)}, HelpStr},
+#define CMDLINE_GEN_SW_PARSE(Kind, Type, SwStr1, SwStr2, Field, HelpStr) \
+    if (CMDLINE_GEN_MATCH(Arg, Len, SwStr1) || CMDLINE_GEN_MATCH(Arg, Len, SwStr2)) { \
+        if (Present[CmdLineGenSw_##Field]) { \
+            goto Fallback; \
+        } \
+        Present[CmdLineGenSw_##Field] = TRUE; \
+        if (CMDLINE_GEN_HAS_VALUE_##Kind) { \
+            if ((ArgNum + 1 == Argc) || (Argv[ArgNum + 1][0] == L'-') || (Argv[ArgNum + 1][0] == L'/')) { \
+                goto Fallback; \
+            } \
+            ArgNum++; \
+        } \
+        if (!CMDLINE_GEN_STORE_##Kind(Type, &Local.Field, Argv[ArgNum])) { \
+            goto Fallback; \
+        } \
+        continue; \
+    }
+#define CMDLINE_GEN_PARAM_PARSE(Kind, Type, Field, HelpStr) \
+    case CmdLineGenParam_##Field: \
+        if (!CMDLINE_GEN_STORE_##Kind(Type, &Local.Field, Arg)) { \
+            goto Fallback; \
+        } \
+        continue;
+
+// switch name match, the length and first char after the '-' are compared before the name;
+// an L"" name never matches as an argument has at least its '-'
+#define CMDLINE_GEN_MATCH(Arg, Len, SwStr) \
+    (((Len) == sizeof(SwStr) / sizeof(CHAR16) - 1) && \
+     (CharToUpper((Arg)[1]) == CharToUpper((SwStr)[(sizeof(SwStr) > 2 * sizeof(CHAR16)) ? 1 : 0])) && \
+     CmdLineGenMatch((Arg), (SwStr), (Len)))
+
+// switch name for the tables, NULL if L""
+#define CMDLINE_GEN_NAME(SwStr) \
+    ((sizeof(SwStr) > sizeof(CHAR16)) ? (SwStr) : NULL)
+
+// size of a number type
+#define CMDLINE_GEN_SIZE(Type) \
+    ((sizeof(Type) == 1) ? SIZE8 : (sizeof(Type) == 2) ? SIZE16 : (sizeof(Type) == 4) ? SIZE32 : SIZE64)
+
+// value type, table data, whether a value follows a switch, and conversion of each kind
+#define CMDLINE_GEN_VALTYPE_FLAG        VALTYPE_NONE
+#define CMDLINE_GEN_VALTYPE_STRREF      VALTYPE_STRREF
+#define CMDLINE_GEN_VALTYPE_DEC         VALTYPE_DECIMAL
+#define CMDLINE_GEN_VALTYPE_HEX         VALTYPE_HEXIDECIMAL
+#define CMDLINE_GEN_VALTYPE_INT         VALTYPE_INTEGER
+#define CMDLINE_GEN_VALTYPE_SINT        VALTYPE_SIGNED
+#define CMDLINE_GEN_DATA_FLAG(Type)     {0}
+#define CMDLINE_GEN_DATA_STRREF(Type)   {0}
+#define CMDLINE_GEN_DATA_DEC(Type)      {.ValSize=CMDLINE_GEN_SIZE(Type)}
+#define CMDLINE_GEN_DATA_HEX(Type)      {.ValSize=CMDLINE_GEN_SIZE(Type)}
+#define CMDLINE_GEN_DATA_INT(Type)      {.ValSize=CMDLINE_GEN_SIZE(Type)}
+#define CMDLINE_GEN_DATA_SINT(Type)     {.ValSize=CMDLINE_GEN_SIZE(Type)}
+#define CMDLINE_GEN_HAS_VALUE_FLAG      0
+#define CMDLINE_GEN_HAS_VALUE_STRREF    1
+#define CMDLINE_GEN_HAS_VALUE_DEC       1
+#define CMDLINE_GEN_HAS_VALUE_HEX       1
+#define CMDLINE_GEN_HAS_VALUE_INT       1
+#define CMDLINE_GEN_HAS_VALUE_SINT      1
+#define CMDLINE_GEN_STORE_FLAG(Type, Ptr, ValStr) \
+    (*(Ptr) = TRUE, TRUE)
+#define CMDLINE_GEN_STORE_STRREF(Type, Ptr, ValStr) \
+    ((Ptr)->Str = (ValStr), (Ptr)->Len = StrLen(ValStr), TRUE)
+#define CMDLINE_GEN_STORE_NUMBER(ValueType, Type, Ptr, ValStr) \
+    (CmdLineGenInteger((ValStr), (ValueType), CMDLINE_GEN_SIZE(Type), &Value) ? (*(Ptr) = (Type)Value, TRUE) : FALSE)
+#define CMDLINE_GEN_STORE_DEC(Type, Ptr, ValStr)    CMDLINE_GEN_STORE_NUMBER(VALTYPE_DECIMAL, Type, Ptr, ValStr)
+#define CMDLINE_GEN_STORE_HEX(Type, Ptr, ValStr)    CMDLINE_GEN_STORE_NUMBER(VALTYPE_HEXIDECIMAL, Type, Ptr, ValStr)
+#define CMDLINE_GEN_STORE_INT(Type, Ptr, ValStr)    CMDLINE_GEN_STORE_NUMBER(VALTYPE_INTEGER, Type, Ptr, ValStr)
+#define CMDLINE_GEN_STORE_SINT(Type, Ptr, ValStr)   CMDLINE_GEN_STORE_NUMBER(VALTYPE_SIGNED, Type, Ptr, ValStr)
+
 //-------------------------------------
 // Enum to String Table Macros
 //-------------------------------------
@@ -390,6 +1171,9 @@ extern "C" {
 #define NO_OPT          0x0000
 #define NO_HELP         0x0001
 #define NO_BREAK        0x0002
+#define SW_PREFIX       0x0004
+#define LAZY_VALUES     0x0008
+#define PASS_THROUGH    0x0010
 
 // WaitKeyPress function options
 #define KEY_NOOPT       0x0000
@@ -414,10 +1198,17 @@ extern "C" {
                     NO_OPT          no option, used on its own
                     NO_HELP         no command line help
                     NO_BREAK        no break option
+                    SW_PREFIX       allow switches to be abbreviated to any unique prefix
+                    LAZY_VALUES     switch values are converted when read with CmdLineGetUintn(),
+                                    CmdLineGetEnum() or CmdLineGetStr(); CmdLineCompile() only
+                    PASS_THROUGH    '--' ends the command line, the arguments after it are left
+                                    unparsed for CmdLineGetPassThrough(); CmdLineCompile() only,
+                                    as ParseCmdLine() keeps no parser to hold them
   NumParams     Ptr to return the number of parameter entered; set to NULL if not required
   
   Returns       SHELL_SUCCESS           if all parameters/switches are valid
-                SHELL_INVALID_PARAMETER if problem encountered with parameter/switches passed on cmd line
+                SHELL_INVALID_PARAMETER if problem encountered with parameter/switches passed on cmd line,
+                                        or PASS_THROUGH given
                 SHELL_OUT_OF_RESOURCES  if internal memory error
                 SHELL_ABORTED           if help displayed
 **/
@@ -431,6 +1222,660 @@ SHELL_STATUS ParseCmdLine(
   );
 
 
+/**
+  ParseArgv - Parses a supplied argument vector rather than the shell command line;
+              does not modify any global state, other than holding list values until
+              CmdLineFree(NULL), so may be used for synthetic argument vectors
+
+  Argc          Number of entries in Argv
+  Argv          Ptr to argument vector; Argv[0] is the program name and is not parsed
+  ParamTable    Ptr to PARAMETER_TABLE defining the expected parameters
+                If no parameters required set this to NULL
+  ManParmCount  Number of manatory parameters required; set to zero if no parameters
+  SwTable       Ptr to SWITCH_TABLE defining the expected switches
+                If no switches required set this to NULL
+  ProgHelpStr   Ptr to help string for program; set to NULL if not required
+  FuncOpt       Functional options, as for ParseCmdLine()
+  NumParams     Ptr to return the number of parameter entered; set to NULL if not required
+  
+  Returns       As ParseCmdLine()
+**/
+SHELL_STATUS ParseArgv(
+  IN UINTN              Argc,
+  IN CHAR16             **Argv,
+  IN PARAMETER_TABLE    *ParamTable OPTIONAL,
+  IN UINTN              ManParmCount,
+  IN SWITCH_TABLE       *SwTable OPTIONAL,
+  IN CHAR16             *ProgHelpStr OPTIONAL,
+  IN UINT16             FuncOpt,
+  OUT UINTN             *NumParams OPTIONAL
+  );
+
+
+/**
+  ParseArgvAscii - Parses a supplied ASCII or UTF-8 argument vector, such as lines read from a
+                   file or serial port, as for ParseArgv(); the arguments are read as UTF-8 and
+                   only STRREF and STR list values are converted to CHAR16, held with the list
+                   values until CmdLineFree(NULL)
+
+  Argc          Number of entries in Argv
+  Argv          Ptr to CHAR8 argument vector; Argv[0] is the program name and is not parsed
+  ParamTable    Ptr to PARAMETER_TABLE defining the expected parameters
+                If no parameters required set this to NULL
+  ManParmCount  Number of manatory parameters required; set to zero if no parameters
+  SwTable       Ptr to SWITCH_TABLE defining the expected switches
+                If no switches required set this to NULL
+  ProgHelpStr   Ptr to help string for program; set to NULL if not required
+  FuncOpt       Functional options, as for ParseCmdLine()
+  NumParams     Ptr to return the number of parameter entered; set to NULL if not required
+  
+  Returns       As ParseCmdLine()
+**/
+SHELL_STATUS ParseArgvAscii(
+  IN UINTN              Argc,
+  IN CHAR8              **Argv,
+  IN PARAMETER_TABLE    *ParamTable OPTIONAL,
+  IN UINTN              ManParmCount,
+  IN SWITCH_TABLE       *SwTable OPTIONAL,
+  IN CHAR16             *ProgHelpStr OPTIONAL,
+  IN UINT16             FuncOpt,
+  OUT UINTN             *NumParams OPTIONAL
+  );
+
+
+/**
+  CmdLineValidateTables - Checks every entry of the parameter and switch tables, reporting each
+                          problem found; CmdLineCompile() calls this, so a compiled parser is
+                          used without checking its tables again
+
+  Checks for null return ptrs, list parameters that are not last, switch names that are missing,
+  do not start with '-' or '/', or are used more than once (including the built-in switches),
+  zero string sizes and bitmap sizes, invalid value sizes, enum arrays that are null, empty,
+  have duplicate strings or no {0, NULL} end entry, enum set arrays with the string 'all' or
+  'none', and switch constraints that come before a switch or name an unknown switch. A mandatory parameter count greater than the number of
+  parameters is reported, but is not an error, it is taken as all of the parameters.
+
+  A table that passes is marked in its end entry and not checked again, so tables must not be
+  changed once in use.
+
+  ParamTable    Ptr to PARAMETER_TABLE defining the expected parameters
+                If no parameters required set this to NULL
+  ManParmCount  Number of manatory parameters required; set to zero if no parameters
+  SwTable       Ptr to SWITCH_TABLE defining the expected switches
+                If no switches required set this to NULL
+  FuncOpt       Functional options, as for ParseCmdLine()
+
+  Returns       SHELL_SUCCESS           if tables are valid
+                SHELL_INVALID_PARAMETER if problem encountered with the tables
+                SHELL_OUT_OF_RESOURCES  if internal memory error
+**/
+SHELL_STATUS CmdLineValidateTables(
+  IN PARAMETER_TABLE    *ParamTable OPTIONAL,
+  IN UINTN              ManParmCount,
+  IN SWITCH_TABLE       *SwTable OPTIONAL,
+  IN UINT16             FuncOpt
+  );
+
+
+/**
+  CmdLineCompile - Validates and preprocesses parameter and switch tables once so that
+                   the command line can be parsed many times with CmdLineParse()
+
+  ParamTable    Ptr to PARAMETER_TABLE defining the expected parameters
+                If no parameters required set this to NULL
+  ManParmCount  Number of manatory parameters required; set to zero if no parameters
+  SwTable       Ptr to SWITCH_TABLE defining the expected switches
+                If no switches required set this to NULL
+  ProgHelpStr   Ptr to help string for program; set to NULL if not required
+  FuncOpt       Functional options, as for ParseCmdLine()
+  Parser        Ptr to return the compiled parser; free with CmdLineFreeParser()
+
+  The tables are validated first with CmdLineValidateTables(), which only checks a table the
+  first time. ParseCmdLine(), ParseArgv() and DispatchCmdLine() compile their tables on every
+  call; compile once and reuse the parser where the tables are parsed many times.
+
+  Returns       SHELL_SUCCESS           if parser created
+                SHELL_INVALID_PARAMETER if problem encountered with the tables
+                SHELL_OUT_OF_RESOURCES  if internal memory error
+**/
+SHELL_STATUS CmdLineCompile(
+  IN PARAMETER_TABLE    *ParamTable OPTIONAL,
+  IN UINTN              ManParmCount,
+  IN SWITCH_TABLE       *SwTable OPTIONAL,
+  IN CHAR16             *ProgHelpStr OPTIONAL,
+  IN UINT16             FuncOpt,
+  OUT CMDLINE_PARSER    **Parser
+  );
+
+
+/**
+  CmdLineParse - Parses the command line using a compiled parser
+
+  Parser        Ptr to parser returned by CmdLineCompile()
+  NumParams     Ptr to return the number of parameter entered; set to NULL if not required
+
+  Returns       As ParseCmdLine()
+**/
+SHELL_STATUS CmdLineParse(
+  IN CMDLINE_PARSER     *Parser,
+  OUT UINTN             *NumParams OPTIONAL
+  );
+
+
+/**
+  CmdLineParseArgv - Parses a supplied argument vector using a compiled parser
+
+  Parser        Ptr to parser returned by CmdLineCompile()
+  Argc          Number of entries in Argv
+  Argv          Ptr to argument vector; Argv[0] is the program name and is not parsed
+  NumParams     Ptr to return the number of parameter entered; set to NULL if not required
+
+  Returns       As ParseCmdLine()
+**/
+SHELL_STATUS CmdLineParseArgv(
+  IN CMDLINE_PARSER     *Parser,
+  IN UINTN              Argc,
+  IN CHAR16             **Argv,
+  OUT UINTN             *NumParams OPTIONAL
+  );
+
+
+/**
+  CmdLineParseArgvAscii - Parses a supplied ASCII or UTF-8 argument vector using a compiled parser;
+                          the arguments are read as UTF-8 and only STRREF, STR list, lazy and
+                          pass through values are converted to CHAR16, held with the list values
+                          until CmdLineFree(Parser)
+
+  Parser        Ptr to parser returned by CmdLineCompile()
+  Argc          Number of entries in Argv
+  Argv          Ptr to CHAR8 argument vector; Argv[0] is the program name and is not parsed
+  NumParams     Ptr to return the number of parameter entered; set to NULL if not required
+
+  Returns       As ParseCmdLine()
+**/
+SHELL_STATUS CmdLineParseArgvAscii(
+  IN CMDLINE_PARSER     *Parser,
+  IN UINTN              Argc,
+  IN CHAR8              **Argv,
+  OUT UINTN             *NumParams OPTIONAL
+  );
+
+
+/**
+  CmdLineTokenize - Splits a command line, such as one read from a file or serial port, into an
+                    argument vector in place; quotes and escapes are removed and each argument is
+                    terminated within the line, with no allocation
+
+  Arguments are separated by spaces or tabs. Double quotes group chars, including spaces, into one
+  argument ("" gives an empty argument), and as in the shell, ^ takes the next char as is (e.g. ^"
+  or ^^). Backslashes are not escapes, so paths are kept as entered.
+
+  Line          Ptr to command line, overwritten with the arguments; Argv[0] is the program name
+  Argv          Ptr to array to return ptrs to the arguments, which point into Line
+  MaxArgs       Number of entries in Argv
+  Argc          Ptr to return number of arguments
+
+  Returns       SHELL_SUCCESS           if line split
+                SHELL_BUFFER_TOO_SMALL  if more than MaxArgs arguments, Argv holds the first MaxArgs
+                SHELL_INVALID_PARAMETER if a quote is not closed or NULL ptr supplied
+**/
+SHELL_STATUS CmdLineTokenize(
+  IN OUT CHAR16         *Line,
+  OUT CHAR16            **Argv,
+  IN UINTN              MaxArgs,
+  OUT UINTN             *Argc
+  );
+
+
+/**
+  ParseCmdLineString - Splits a command line with CmdLineTokenize() and parses it as for ParseArgv()
+
+  Line          Ptr to command line, overwritten with the arguments; the first is the program name
+  Argv          Ptr to array to hold the argument vector
+  MaxArgs       Number of entries in Argv
+  ParamTable    Ptr to PARAMETER_TABLE defining the expected parameters
+                If no parameters required set this to NULL
+  ManParmCount  Number of manatory parameters required; set to zero if no parameters
+  SwTable       Ptr to SWITCH_TABLE defining the expected switches
+                If no switches required set this to NULL
+  ProgHelpStr   Ptr to help string for program; set to NULL if not required
+  FuncOpt       Functional options, as for ParseCmdLine()
+  NumParams     Ptr to return the number of parameter entered; set to NULL if not required
+
+  Returns       As ParseCmdLine(), or CmdLineTokenize() if the line could not be split
+                (error displayed)
+**/
+SHELL_STATUS ParseCmdLineString(
+  IN OUT CHAR16         *Line,
+  OUT CHAR16            **Argv,
+  IN UINTN              MaxArgs,
+  IN PARAMETER_TABLE    *ParamTable OPTIONAL,
+  IN UINTN              ManParmCount,
+  IN SWITCH_TABLE       *SwTable OPTIONAL,
+  IN CHAR16             *ProgHelpStr OPTIONAL,
+  IN UINT16             FuncOpt,
+  OUT UINTN             *NumParams OPTIONAL
+  );
+
+
+/**
+  CmdLineParseString - Splits a command line with CmdLineTokenize() and parses it using a compiled
+                       parser, with no allocation other than for list values
+
+  Parser        Ptr to parser returned by CmdLineCompile()
+  Line          Ptr to command line, overwritten with the arguments; the first is the program name
+  Argv          Ptr to array to hold the argument vector
+  MaxArgs       Number of entries in Argv
+  NumParams     Ptr to return the number of parameter entered; set to NULL if not required
+
+  Returns       As ParseCmdLine(), or CmdLineTokenize() if the line could not be split
+                (error displayed)
+**/
+SHELL_STATUS CmdLineParseString(
+  IN CMDLINE_PARSER     *Parser,
+  IN OUT CHAR16         *Line,
+  OUT CHAR16            **Argv,
+  IN UINTN              MaxArgs,
+  OUT UINTN             *NumParams OPTIONAL
+  );
+
+
+/**
+  CmdLineParseConfig - Parses the command line into a config struct using a compiled parser
+                       whose tables were defined with CMDLINE_FIELD()
+
+  Parser        Ptr to parser returned by CmdLineCompile()
+  Config        Ptr to config struct to hold values entered
+  NumParams     Ptr to return the number of parameter entered; set to NULL if not required
+
+  Returns       As ParseCmdLine()
+**/
+SHELL_STATUS CmdLineParseConfig(
+  IN CMDLINE_PARSER     *Parser,
+  OUT VOID              *Config,
+  OUT UINTN             *NumParams OPTIONAL
+  );
+
+
+/**
+  CmdLineParseArgvConfig - Parses a supplied argument vector into a config struct using a
+                           compiled parser whose tables were defined with CMDLINE_FIELD()
+
+  Parser        Ptr to parser returned by CmdLineCompile()
+  Argc          Number of entries in Argv
+  Argv          Ptr to argument vector; Argv[0] is the program name and is not parsed
+  Config        Ptr to config struct to hold values entered
+  NumParams     Ptr to return the number of parameter entered; set to NULL if not required
+
+  Returns       As ParseCmdLine()
+**/
+SHELL_STATUS CmdLineParseArgvConfig(
+  IN CMDLINE_PARSER     *Parser,
+  IN UINTN              Argc,
+  IN CHAR16             **Argv,
+  OUT VOID              *Config,
+  OUT UINTN             *NumParams OPTIONAL
+  );
+
+
+/**
+  CmdLineGetUintn - Gets the value of a DEC, HEX, INT, SINT, SIZE, TIME or FREQ switch from a
+                    parser compiled with LAZY_VALUES; the value is converted and stored through
+                    the table return ptr on first access, and the argument vector parsed must
+                    still be valid
+
+  Parser        Ptr to parser returned by CmdLineCompile()
+  Name          Switch name (e.g. L"-count")
+  Value         Ptr to return value, SINT values are sign extended
+
+  Returns       SHELL_SUCCESS           if value returned
+                SHELL_NOT_FOUND         if switch not entered or not in the table
+                SHELL_INVALID_PARAMETER if value invalid (error displayed), switch of another type,
+                                        or parser not compiled with LAZY_VALUES
+**/
+SHELL_STATUS CmdLineGetUintn(
+  IN CMDLINE_PARSER     *Parser,
+  IN CONST CHAR16       *Name,
+  OUT UINTN             *Value
+  );
+
+
+/**
+  CmdLineGetEnum - Gets the value of an ENUM switch from a parser compiled with LAZY_VALUES
+
+  Parser        Ptr to parser returned by CmdLineCompile()
+  Name          Switch name (e.g. L"-mode")
+  Value         Ptr to return enum value
+
+  Returns       As CmdLineGetUintn()
+**/
+SHELL_STATUS CmdLineGetEnum(
+  IN CMDLINE_PARSER     *Parser,
+  IN CONST CHAR16       *Name,
+  OUT UINTN             *Value
+  );
+
+
+/**
+  CmdLineGetStr - Gets the value of a STR, STR8 or STRREF switch from a parser compiled with
+                  LAZY_VALUES
+
+  Parser        Ptr to parser returned by CmdLineCompile()
+  Name          Switch name (e.g. L"-file")
+  Str           Ptr to return the value string from the argument vector, not truncated
+
+  Returns       As CmdLineGetUintn()
+**/
+SHELL_STATUS CmdLineGetStr(
+  IN CMDLINE_PARSER     *Parser,
+  IN CONST CHAR16       *Name,
+  OUT CONST CHAR16      **Str
+  );
+
+
+/**
+  DispatchCmdLine - Runs the subcommand named by the first argument of the command line;
+                    '-h' or '-help' in place of a subcommand lists the subcommands, and
+                    'command subcommand -h' gives the help of a subcommand
+
+                    Global switches must come before the subcommand, anything after it is
+                    parsed with the tables of the subcommand. '-b' before the subcommand is
+                    passed on to it, so 'command -b subcommand' is as 'command subcommand -b'
+
+  SubCmdTable   Ptr to SUBCMD_TABLE defining the subcommands
+  ProgHelpStr   Ptr to help string for program; set to NULL if not required
+  FuncOpt       Functional options, as for ParseCmdLine(), used for every subcommand
+
+  Returns       Status returned by subcommand handler, or as ParseCmdLine() if the
+                subcommand's command line is not valid
+**/
+SHELL_STATUS DispatchCmdLine(
+  IN SUBCMD_TABLE       *SubCmdTable,
+  IN CHAR16             *ProgHelpStr OPTIONAL,
+  IN UINT16             FuncOpt
+  );
+
+
+/**
+  CmdLineSubCmdCompile - Validates a subcommand table and indexes the subcommand names, the
+                         tables of a subcommand are compiled when it is dispatched
+
+  SubCmdTable   Ptr to SUBCMD_TABLE defining the subcommands
+  ProgHelpStr   Ptr to help string for program; set to NULL if not required
+  FuncOpt       Functional options, as for ParseCmdLine(), used for every subcommand
+  SubCmds       Ptr to return the compiled subcommands; free with CmdLineSubCmdFree()
+
+  Returns       As CmdLineCompile()
+**/
+SHELL_STATUS CmdLineSubCmdCompile(
+  IN SUBCMD_TABLE       *SubCmdTable,
+  IN CHAR16             *ProgHelpStr OPTIONAL,
+  IN UINT16             FuncOpt,
+  OUT CMDLINE_SUBCMDS   **SubCmds
+  );
+
+
+/**
+  CmdLineSubCmdDispatch - Runs the subcommand named by the first argument of the command line
+
+  SubCmds       Ptr to subcommands returned by CmdLineSubCmdCompile()
+
+  Returns       As DispatchCmdLine()
+**/
+SHELL_STATUS CmdLineSubCmdDispatch(
+  IN CMDLINE_SUBCMDS    *SubCmds
+  );
+
+
+/**
+  CmdLineSubCmdDispatchArgv - Runs the subcommand named by Argv[1] of a supplied argument vector
+
+  SubCmds       Ptr to subcommands returned by CmdLineSubCmdCompile()
+  Argc          Number of entries in Argv
+  Argv          Ptr to argument vector; Argv[0] is the program name
+
+  Returns       As DispatchCmdLine()
+**/
+SHELL_STATUS CmdLineSubCmdDispatchArgv(
+  IN CMDLINE_SUBCMDS    *SubCmds,
+  IN UINTN              Argc,
+  IN CHAR16             **Argv
+  );
+
+
+/**
+  CmdLineSubCmdFree - Frees subcommands returned by CmdLineSubCmdCompile()
+
+  SubCmds       Ptr to subcommands; may be NULL
+
+  Returns       NA
+**/
+VOID CmdLineSubCmdFree(
+  IN CMDLINE_SUBCMDS    *SubCmds OPTIONAL
+  );
+
+
+/**
+  CmdLineBitmapNext - Finds the next value in a bitmap from a BITMAP parameter or switch, e.g.
+                      for (UINTN Cpu = 0; CmdLineBitmapNext(CpuSet, 256, &Cpu); Cpu++) {...}
+
+  Bitmap        Ptr to bitmap
+  BitCount      Number of bits in bitmap
+  Value         Ptr to value to search from; returns the first value in the bitmap at or after it
+
+  Returns       TRUE if value found
+**/
+BOOLEAN CmdLineBitmapNext(
+  IN CONST UINTN        *Bitmap,
+  IN UINTN              BitCount,
+  IN OUT UINTN          *Value
+  );
+
+
+/**
+  CmdLineRangeNext - Finds the next value in a range list from a RANGES parameter or switch,
+                     e.g. for (UINT64 Addr = 0; CmdLineRangeNext(&Ranges, &Addr); Addr += Step) {...}
+                     the loop must also stop if Addr wraps; the Ranges array may also be walked directly
+
+  RangeList     Ptr to range list
+  Value         Ptr to value to search from; returns the first value in the list at or after it
+
+  Returns       TRUE if value found
+**/
+BOOLEAN CmdLineRangeNext(
+  IN CONST CMDLINE_RANGE_LIST   *RangeList,
+  IN OUT UINT64                 *Value
+  );
+
+
+/**
+  CmdLineFreeParser - Frees a parser returned by CmdLineCompile(), along with its list values
+
+  Parser        Ptr to parser; may be NULL
+
+  Returns       NA
+**/
+VOID CmdLineFreeParser(
+  IN CMDLINE_PARSER     *Parser OPTIONAL
+  );
+
+
+/**
+  CmdLineFree - Frees list values; parameters and switches that are lists are emptied when
+                next parsed
+
+  Parser        Ptr to parser whose list values are to be freed; NULL for the values from
+                ParseCmdLine() and ParseArgv()
+
+  Returns       NA
+**/
+VOID CmdLineFree(
+  IN CMDLINE_PARSER     *Parser OPTIONAL
+  );
+
+
+/**
+  CmdLineGetPassThrough - Gets the arguments after '--' from the parser's last parse with the
+                          PASS_THROUGH option; they are not copied, so remain part of the argument
+                          vector parsed (converted and held until CmdLineFree() for ASCII arguments)
+
+  Parser        Ptr to parser returned by CmdLineCompile(); ParseCmdLine() and ParseArgv() keep
+                no parser, so reject PASS_THROUGH
+  Argc          Ptr to return the number of arguments after '--'; set to NULL if not required
+  Argv          Ptr to return ptr to the first argument after '--'; set to NULL if not required
+
+  Returns       TRUE if '--' was entered; FALSE, with no arguments, if Parser is NULL
+**/
+BOOLEAN CmdLineGetPassThrough(
+  IN CMDLINE_PARSER     *Parser,
+  OUT UINTN             *Argc OPTIONAL,
+  OUT CHAR16            ***Argv OPTIONAL
+  );
+
+
+/**
+  CmdLineExecute - Runs a command given as an argument vector, such as the arguments after '--',
+                   through the shell and times it with the performance counter; arguments are
+                   quoted and escaped so that the command receives them unchanged
+
+  ParentImageHandle Image handle of the calling tool, normally the one passed to its entry point
+  Argc          Number of entries in Argv; Argv[0] is the command
+  Argv          Ptr to argument vector
+  ExitStatus    Ptr to return the exit status of the command; set to NULL if not required
+  ElapsedNs     Ptr to return the time taken in nanoseconds; set to NULL if not required
+
+  Returns       EFI_SUCCESS             if command run
+                EFI_INVALID_PARAMETER   if no command supplied
+                EFI_OUT_OF_RESOURCES    if internal memory error
+                otherwise the error from the shell, e.g. EFI_NOT_FOUND if no such command
+**/
+EFI_STATUS CmdLineExecute(
+  IN EFI_HANDLE         ParentImageHandle,
+  IN UINTN              Argc,
+  IN CHAR16             **Argv,
+  OUT EFI_STATUS        *ExitStatus OPTIONAL,
+  OUT UINT64            *ElapsedNs OPTIONAL
+  );
+
+
+/**
+  CmdLineEnumIndexCreate - Indexes an enum to string array for fast lookup by string and by value;
+                           CmdLineCompile() does this itself for enum parameters and switches
+
+  EnumStrArray  Ptr to enum to string array, must remain valid while the index is in use
+  EnumIndex     Ptr to return the index; free with CmdLineEnumIndexFree()
+
+  Returns       SHELL_SUCCESS           if index created
+                SHELL_INVALID_PARAMETER if NULL ptr supplied
+                SHELL_OUT_OF_RESOURCES  if internal memory error
+**/
+SHELL_STATUS CmdLineEnumIndexCreate(
+  IN ENUM_STR_ARRAY         *EnumStrArray,
+  OUT CMDLINE_ENUM_INDEX    **EnumIndex
+  );
+
+
+/**
+  CmdLineEnumIndexFind - Finds value of enum string (case insensitive)
+
+  EnumIndex     Ptr to index returned by CmdLineEnumIndexCreate()
+  Str           Enum string
+  Value         Ptr to return associated value; set to NULL if not required
+
+  Returns       TRUE if string found
+**/
+BOOLEAN CmdLineEnumIndexFind(
+  IN CONST CMDLINE_ENUM_INDEX   *EnumIndex,
+  IN CONST CHAR16               *Str,
+  OUT UINTN                     *Value OPTIONAL
+  );
+
+
+/**
+  CmdLineEnumIndexName - Finds string of enum value, the first in the array if several share the value
+
+  EnumIndex     Ptr to index returned by CmdLineEnumIndexCreate()
+  Value         Enum value
+
+  Returns       Ptr to string; NULL if value not in array
+**/
+CONST CHAR16* CmdLineEnumIndexName(
+  IN CONST CMDLINE_ENUM_INDEX   *EnumIndex,
+  IN UINTN                      Value
+  );
+
+
+/**
+  CmdLineEnumIndexFree - Frees an index returned by CmdLineEnumIndexCreate()
+
+  EnumIndex     Ptr to index; may be NULL
+
+  Returns       NA
+**/
+VOID CmdLineEnumIndexFree(
+  IN CMDLINE_ENUM_INDEX *EnumIndex OPTIONAL
+  );
+
+
+/**
+  CmdLineGenMatch - Compares an argument with a switch name ignoring case, for parsers
+                    generated by CMDLINE_DEFINE_PARSER()
+
+  Arg           Ptr to argument
+  SwStr         Ptr to switch name
+  Len           Length of both strings
+
+  Returns       TRUE if equal
+**/
+BOOLEAN CmdLineGenMatch(
+  IN CONST CHAR16   *Arg,
+  IN CONST CHAR16   *SwStr,
+  IN UINTN          Len
+  );
+
+
+/**
+  CmdLineGenInteger - Converts a number of known type and size, for parsers generated by
+                      CMDLINE_DEFINE_PARSER(); accepts exactly what the table parser accepts
+
+  String        Ptr to value string
+  ValueType     VALTYPE_DECIMAL, VALTYPE_HEXIDECIMAL, VALTYPE_INTEGER or VALTYPE_SIGNED
+  ValSize       Size of value, SIZE8 to SIZE64
+  Value         Ptr to return value, SINT values are sign extended
+
+  Returns       TRUE if valid and within range for size
+**/
+BOOLEAN CmdLineGenInteger(
+  IN CONST CHAR16   *String,
+  IN VALUE_TYPE     ValueType,
+  IN VALUE_SIZE     ValSize,
+  OUT UINT64        *Value
+  );
+
+
+/**
+  CmdLineNarrowStr - Validates, measures and converts a CHAR16 string to ASCII, four chars
+                     at a time where possible
+
+  Source        Ptr to string to convert
+  Dest          Ptr to buffer for ASCII string; may be NULL if DestSize is zero to only measure
+  DestSize      Size of Dest buffer including terminator; as much as fits is always converted
+                and terminated
+  Len           Ptr to return length of Source, or index of first non-ASCII char;
+                set to NULL if not required
+
+  Returns       EFI_SUCCESS             if converted
+                EFI_BUFFER_TOO_SMALL    if Source truncated to fit Dest
+                EFI_INVALID_PARAMETER   if Source has a non-ASCII char or NULL ptr supplied
+**/
+EFI_STATUS CmdLineNarrowStr(
+  IN CONST CHAR16   *Source,
+  OUT CHAR8         *Dest OPTIONAL,
+  IN UINTN          DestSize,
+  OUT UINTN         *Len OPTIONAL
+  );
+
+
 /**
   SetProgName - Shell appication name is taken from cmd line parameters, this function allows it to be overriden
 
@@ -14,11 +14,14 @@ extern "C" {
 #endif
 
 #include <Uefi.h>
+#include <Library/ShellLib.h>
 
 // Types
-typedef enum { NO_SW, OPT_SW, MAN_SW, HELP_SW } SWITCH_NECESSITY;
-typedef enum { VALTYPE_NONE, VALTYPE_STRING, VALTYPE_ASCII_STRING, VALTYPE_DECIMAL, VALTYPE_HEXIDECIMAL, VALTYPE_INTEGER, VALTYPE_ENUM } VALUE_TYPE;
-typedef enum { SIZEN, SIZE8, SIZE16, SIZE32} VALUE_SIZE;
+typedef enum { NO_SW, OPT_SW, MAN_SW, HELP_SW, REQUIRES_SW, CONFLICTS_SW, ONE_OF_SW } SWITCH_NECESSITY;
+typedef enum { VALTYPE_NONE, VALTYPE_STRING, VALTYPE_ASCII_STRING, VALTYPE_DECIMAL, VALTYPE_HEXIDECIMAL, VALTYPE_INTEGER, VALTYPE_ENUM, VALTYPE_SIGNED, VALTYPE_STRREF,
+               VALTYPE_SIZE, VALTYPE_TIME, VALTYPE_FREQ, VALTYPE_BITMAP, VALTYPE_RANGES, VALTYPE_DEC_LIST, VALTYPE_HEX_LIST, VALTYPE_INT_LIST, VALTYPE_STR_LIST,
+               VALTYPE_ENUM_SET } VALUE_TYPE;
+typedef enum { SIZEN, SIZE8, SIZE16, SIZE32, SIZE64 } VALUE_SIZE;
 typedef enum { NO_VALUE, OPT_VALUE, MAN_VALUE } VALUE_NECESSITY;
 
 // Struct to hold mapping of enum value to string for use with enum parameters and switches
@@ -27,12 +30,45 @@ typedef struct {
     UINT16 *Str;
 } ENUM_STR_ARRAY;
 
+// Borrowed string value, points into the argument vector rather than being copied
+typedef struct {
+    CONST CHAR16 *Str;
+    UINTN Len;
+} CMDLINE_STRREF;
+
+// List of values collected by list parameters and switches, items are held until CmdLineFree()
+typedef struct {
+    UINTN Count;
+    union {
+        UINTN *Uintn;           // DEC/HEX/INT lists
+        CONST CHAR16 **Str;     // STR lists, ptrs into the argument vector
+        VOID *Ptr;
+    } Items;
+    UINTN Capacity;
+} CMDLINE_LIST;
+
+// Inclusive range of values
+typedef struct {
+    UINT64 First;
+    UINT64 Last;
+} CMDLINE_RANGE;
+
+// Sorted list of ranges, overlapping or adjacent ranges are merged; held until CmdLineFree()
+typedef struct {
+    UINTN Count;
+    CMDLINE_RANGE *Ranges;
+} CMDLINE_RANGE_LIST;
+
+// Number of UINTN words in a bitmap of values 0 to Bits-1
+#define CMDLINE_BITMAP_WORDS(Bits)  (((Bits) + sizeof(UINTN) * 8 - 1) / (sizeof(UINTN) * 8))
+
 // Misc data used for both parameters and switches
 typedef union {
     ENUM_STR_ARRAY *EnumStrArray;
     UINTN MaxStrSize;
     UINTN FlagValue;
     VALUE_SIZE ValSize;
+    UINTN BitCount;
 } DATA;
 
 // Ptr to return value
@@ -42,10 +78,19 @@ typedef union {
     UINT8* pUint8;
     UINT16* pUint16;
     UINT32* pUint32;
-    UINT16* pUint64;
+    UINT64* pUint64;
+    INTN *pIntn;
+    INT8* pInt8;
+    INT16* pInt16;
+    INT32* pInt32;
+    INT64* pInt64;
     CHAR16 *pChar16;
     CHAR8 *pChar8;
     unsigned int *pEnum;
+    CMDLINE_STRREF *pStrRef;
+    CMDLINE_LIST *pList;
+    UINTN *pBitmap;
+    CMDLINE_RANGE_LIST *pRangeList;
     VOID *pVoid;
 } VALUE_RET_PTR;
 
@@ -67,8 +112,6 @@ typedef struct {
 //---------------------------
 // Switch table
 //---------------------------
-#define MAX_SWITCH_ENTRIES  30
-
 typedef struct {
     CHAR16 *SwStr1; // short switch
     CHAR16 *SwStr2; // long switch
@@ -86,6 +129,37 @@ typedef struct {
         { SwStr1, SwStr2, SwitchNeccessity, ValueType, EnumArray, PresentPtr, {.pVoid=ValueRetPtr}, HelpStr },
 
 
+//---------------------------
+// Compiled parser
+//---------------------------
+typedef struct _CMDLINE_PARSER CMDLINE_PARSER;
+
+//---------------------------
+// Enum index
+//---------------------------
+typedef struct _CMDLINE_ENUM_INDEX CMDLINE_ENUM_INDEX;
+
+
+//---------------------------
+// Subcommand table
+//---------------------------
+
+// handler called once the subcommand's command line has been parsed, Argv[0] is the subcommand
+typedef SHELL_STATUS (EFIAPI *SUBCMD_HANDLER)(IN CMDLINE_PARSER *Parser, IN UINTN Argc, IN CHAR16 **Argv, IN UINTN NumParams);
+
+typedef struct {
+    CHAR16 *Name;
+    PARAMETER_TABLE *ParamTable;
+    UINTN ManParamCount;
+    SWITCH_TABLE *SwTable;
+    SUBCMD_HANDLER Handler;
+    CHAR16 *HelpStr;
+} SUBCMD_TABLE;
+
+// compiled subcommand table
+typedef struct _CMDLINE_SUBCMDS CMDLINE_SUBCMDS;
+
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,60 @@
+/***********************************************************************
+
+ CompareBench.c
+
+ Times the case insensitive compares: StriCmp() folding a char at a
+ time against StrniEqual() folding four chars at a time with
+ FoldChar16x4(), on equal strings that differ only in case
+
+***********************************************************************/
+
+#include "../CmdLine.c"
+#include "TestCommon.h"
+
+#define BENCH_LOOPS     2000000
+
+// volatile so the compares are not hoisted out of the loops
+STATIC volatile UINTN           mSink;
+STATIC CONST CHAR16 * volatile  mOther;
+
+STATIC VOID BenchLength(UINTN Len)
+{
+    CHAR16 First[64];
+    CHAR16 Second[64];
+    UINT64 Start;
+    UINT64 StriCmpNs;
+    UINT64 StrniEqualNs;
+
+    for (UINTN i = 0; i < Len; i++) {
+        First[i] = (CHAR16)(L'a' + (i % 26));
+        Second[i] = (i & 1) ? (CHAR16)(L'A' + (i % 26)) : First[i];
+    }
+    First[Len] = Second[Len] = L'\0';
+    mOther = Second;
+
+    Start = GetPerformanceCounter();
+    for (UINTN i = 0; i < BENCH_LOOPS; i++) {
+        mSink += (StriCmp(First, mOther) == 0);
+    }
+    StriCmpNs = GetTimeInNanoSecond(GetPerformanceCounter() - Start);
+
+    Start = GetPerformanceCounter();
+    for (UINTN i = 0; i < BENCH_LOOPS; i++) {
+        mSink += StrniEqual(First, mOther, Len);
+    }
+    StrniEqualNs = GetTimeInNanoSecond(GetPerformanceCounter() - Start);
+
+    printf("  %3u chars: StriCmp %6.2f ns  StrniEqual %6.2f ns\n", (unsigned)Len,
+        (double)StriCmpNs / BENCH_LOOPS, (double)StrniEqualNs / BENCH_LOOPS);
+}
+
+int main(void)
+{
+    printf("CompareBench: ns per compare, strings differing in case only\n");
+    BenchLength(4);
+    BenchLength(8);
+    BenchLength(16);
+    BenchLength(32);
+    BenchLength(60);
+    return 0;
+}
@@ -0,0 +1,162 @@
+/***********************************************************************
+
+ ConstraintTest.c
+
+ Host tests of the requires, conflicts and one-of switch constraints
+
+***********************************************************************/
+
+#include "../CmdLine.c"
+#include "TestCommon.h"
+#include <stdlib.h>
+
+STATIC BOOLEAN  mRead;
+STATIC BOOLEAN  mWrite;
+STATIC BOOLEAN  mVerify;
+STATIC BOOLEAN  mQuiet;
+STATIC BOOLEAN  mVerbose;
+STATIC UINTN    mAddress;
+STATIC UINTN    mCount;
+
+SWTABLE_START(mSwTable)
+SWTABLE_OPT_FLAG(L"-r", L"-read", &mRead, L"read")
+SWTABLE_OPT_FLAG(L"-w", L"-write", &mWrite, L"write")
+SWTABLE_OPT_FLAG(L"-y", L"-verify", &mVerify, L"verify after write")
+SWTABLE_OPT_FLAG(L"-q", L"-quiet", &mQuiet, L"quiet")
+SWTABLE_OPT_FLAG(L"-v", L"-verbose", &mVerbose, L"verbose")
+SWTABLE_OPT_HEX(L"-a", L"-address", &mAddress, L"[addr]address")
+SWTABLE_OPT_DEC(L"-c", L"-count", &mCount, L"[n]count")
+SWTABLE_ONE_OF(L"-r -write")
+SWTABLE_REQUIRES(L"-r -w", L"-address -c")
+SWTABLE_REQUIRES(L"-verify", L"-w")
+SWTABLE_CONFLICTS(L"-q", L"-v")
+SWTABLE_END
+
+SWTABLE_START(mUnknown)
+SWTABLE_OPT_FLAG(L"-q", NULL, &mQuiet, L"quiet")
+SWTABLE_CONFLICTS(L"-q", L"-x")
+SWTABLE_END
+
+SWTABLE_START(mSwitchAfter)
+SWTABLE_OPT_FLAG(L"-q", NULL, &mQuiet, L"quiet")
+SWTABLE_CONFLICTS(L"-q", L"-v")
+SWTABLE_OPT_FLAG(L"-v", NULL, &mVerbose, L"verbose")
+SWTABLE_END
+
+STATIC SHELL_STATUS Parse(CONST CHAR8 *Line)
+{
+    SetArgs(Line);
+    return ParseCmdLine(NULL, 0, mSwTable, NULL, NO_OPT, NULL);
+}
+
+STATIC VOID TestConstraints(VOID)
+{
+    CHECK(Parse("p -r -a 100 -c 4") == SHELL_SUCCESS);
+    CHECK(Parse("p -write -y -address 100 -count 4 -q") == SHELL_SUCCESS);
+
+    // one of
+    CHECK(Parse("p -a 100 -c 4") == SHELL_INVALID_PARAMETER);
+    CHECK(Output("One of '-r -write' required"));
+    CHECK(Parse("p -r -w -a 100 -c 4") == SHELL_INVALID_PARAMETER);
+    CHECK(Output("Only one of '-r -write' allowed"));
+
+    // requires, named by the first trigger and first missing switch entered
+    CHECK(Parse("p -w -a 100") == SHELL_INVALID_PARAMETER);
+    CHECK(Output("Switch '-w' requires '-c'"));
+    CHECK(Parse("p -r") == SHELL_INVALID_PARAMETER);
+    CHECK(Output("Switch '-r' requires '-a'"));
+    CHECK(Parse("p -r -y -a 1 -c 1") == SHELL_INVALID_PARAMETER);
+    CHECK(Output("Switch '-y' requires '-w'"));
+
+    // conflicts
+    CHECK(Parse("p -r -a 1 -c 1 -verbose -quiet") == SHELL_INVALID_PARAMETER);
+    CHECK(Output("Switch '-q' cannot be used with '-v'"));
+
+    // help and argument errors are reported before constraints
+    CHECK(Parse("p -q -v -h") == SHELL_ABORTED);
+    CHECK(Output("Switch rules:") && Output("exactly one of -r -write") && Output("-q cannot be used with -v"));
+    CHECK(!Output("cannot be used with '"));
+    CHECK(Parse("p -q -v -z") == SHELL_INVALID_PARAMETER);
+    CHECK(Output("Unrecognised switch") && !Output("cannot be used"));
+}
+
+// constraints between switches in different words of the switch bitsets
+STATIC VOID TestManySwitches(VOID)
+{
+    #define MANY_SWITCHES   150
+    SWITCH_TABLE *SwTable = calloc(MANY_SWITCHES + 4, sizeof(SWITCH_TABLE));
+    CHAR16 (*Names)[8] = calloc(MANY_SWITCHES, sizeof(*Names));
+    BOOLEAN *Flags = calloc(MANY_SWITCHES, sizeof(BOOLEAN));
+    CMDLINE_PARSER *Parser;
+    CHAR8 Name[8];
+
+    for (UINTN i = 0; i < MANY_SWITCHES; i++) {
+        snprintf(Name, sizeof(Name), "-s%u", (unsigned)i);
+        Widen(Names[i], Name);
+        SwTable[i].SwStr1 = Names[i];
+        SwTable[i].SwitchNecessity = OPT_SW;
+        SwTable[i].ValueType = VALTYPE_NONE;
+        SwTable[i].ValueRetPtr.pBoolean = &Flags[i];
+        SwTable[i].HelpStr = L"switch";
+    }
+    SwTable[MANY_SWITCHES].SwStr1 = L"-s1";
+    SwTable[MANY_SWITCHES].SwStr2 = L"-s70 -s140";
+    SwTable[MANY_SWITCHES].SwitchNecessity = REQUIRES_SW;
+    SwTable[MANY_SWITCHES + 1].SwStr1 = L"-s130";
+    SwTable[MANY_SWITCHES + 1].SwStr2 = L"-s2 -s65";
+    SwTable[MANY_SWITCHES + 1].SwitchNecessity = CONFLICTS_SW;
+    SwTable[MANY_SWITCHES + 2].SwStr2 = L"-s3 -s5 -s66 -s129";
+    SwTable[MANY_SWITCHES + 2].SwitchNecessity = ONE_OF_SW;
+
+    CHECK(CmdLineCompile(NULL, 0, SwTable, NULL, NO_OPT, &Parser) == SHELL_SUCCESS);
+    CHECK(Parser->ConstraintCount == 3);
+
+    SetArgs("p -s129");
+    CHECK(CmdLineParseArgv(Parser, mTestParams.Argc, mTestArgv, NULL) == SHELL_SUCCESS);
+    SetArgs("p -s1 -s70 -s140 -s66");
+    CHECK(CmdLineParseArgv(Parser, mTestParams.Argc, mTestArgv, NULL) == SHELL_SUCCESS);
+    SetArgs("p -s1 -s70 -s3");
+    CHECK(CmdLineParseArgv(Parser, mTestParams.Argc, mTestArgv, NULL) == SHELL_INVALID_PARAMETER);
+    CHECK(Output("Switch '-s1' requires '-s140'"));
+    SetArgs("p -s130 -s65 -s3");
+    CHECK(CmdLineParseArgv(Parser, mTestParams.Argc, mTestArgv, NULL) == SHELL_INVALID_PARAMETER);
+    CHECK(Output("Switch '-s130' cannot be used with '-s65'"));
+    SetArgs("p -s6");
+    CHECK(CmdLineParseArgv(Parser, mTestParams.Argc, mTestArgv, NULL) == SHELL_INVALID_PARAMETER);
+    CHECK(Output("One of '-s3 -s5 -s66 -s129' required"));
+    // two listed switches in one word, and one in each of two words
+    SetArgs("p -s3 -s5");
+    CHECK(CmdLineParseArgv(Parser, mTestParams.Argc, mTestArgv, NULL) == SHELL_INVALID_PARAMETER);
+    CHECK(Output("Only one of"));
+    SetArgs("p -s66 -s129");
+    CHECK(CmdLineParseArgv(Parser, mTestParams.Argc, mTestArgv, NULL) == SHELL_INVALID_PARAMETER);
+    CHECK(Output("Only one of"));
+
+    CmdLineFreeParser(Parser);
+    free(Flags);
+    free(Names);
+    free(SwTable);
+}
+
+STATIC VOID TestValidation(VOID)
+{
+    CMDLINE_PARSER *Parser;
+
+    StubClearOutput();
+    CHECK(CmdLineValidateTables(NULL, 0, mSwTable, NO_OPT) == SHELL_SUCCESS);
+    CHECK(CmdLineValidateTables(NULL, 0, mUnknown, NO_OPT) == SHELL_INVALID_PARAMETER);
+    CHECK(Output("Unknown constraint switch"));
+    StubClearOutput();
+    CHECK(CmdLineValidateTables(NULL, 0, mSwitchAfter, NO_OPT) == SHELL_INVALID_PARAMETER);
+    CHECK(Output("Switch after constraint"));
+    CHECK(CmdLineCompile(NULL, 0, mUnknown, NULL, NO_OPT, &Parser) == SHELL_INVALID_PARAMETER);
+}
+
+int main(void)
+{
+    TestConstraints();
+    TestManySwitches();
+    TestValidation();
+
+    return TestSummary("ConstraintTest");
+}
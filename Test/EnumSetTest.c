@@ -0,0 +1,175 @@
+/***********************************************************************
+
+ EnumSetTest.c
+
+ Host tests of ENUM_SET values, scanned and indexed, from CHAR16 and
+ CHAR8 argument vectors
+
+***********************************************************************/
+
+#include "../CmdLine.c"
+#include "TestCommon.h"
+
+// below ENUM_INDEX_MIN_ENTRIES, scanned
+ENUMSTR_START(mLevels)
+ENUMSTR_ENTRY(0x1, L"err")
+ENUMSTR_ENTRY(0x2, L"warn")
+ENUMSTR_ENTRY(0x4, L"warning")
+ENUMSTR_ENTRY(0x8, L"info")
+ENUMSTR_END
+
+// indexed
+ENUMSTR_START(mFeatures)
+ENUMSTR_ENTRY(1ULL << 0,  L"sse")
+ENUMSTR_ENTRY(1ULL << 1,  L"sse2")
+ENUMSTR_ENTRY(1ULL << 2,  L"sse3")
+ENUMSTR_ENTRY(1ULL << 3,  L"avx")
+ENUMSTR_ENTRY(1ULL << 4,  L"avx2")
+ENUMSTR_ENTRY(1ULL << 5,  L"aes")
+ENUMSTR_ENTRY(1ULL << 6,  L"rdrand")
+ENUMSTR_ENTRY(1ULL << 7,  L"sha")
+ENUMSTR_ENTRY(1ULL << 40, L"debug")
+ENUMSTR_END
+
+#define ALL_FEATURES    (0xFFULL | (1ULL << 40))
+
+STATIC UINT64   mLevel;
+STATIC UINT64   mFeature;
+STATIC BOOLEAN  mFeaturePresent;
+
+// members that would be hidden by the keywords
+ENUMSTR_START(mHasAll)
+ENUMSTR_ENTRY(0x1, L"one")
+ENUMSTR_ENTRY(0x2, L"All")
+ENUMSTR_END
+
+ENUMSTR_START(mHasNone)
+ENUMSTR_ENTRY(0x1, L"NONE")
+ENUMSTR_ENTRY(0x2, L"nonempty")
+ENUMSTR_END
+
+SWTABLE_START(mSwTable)
+SWTABLE_OPT_ENUM_SET(L"-l", L"-level", &mLevel, mLevels, L"[levels]message levels")
+SWTABLE_OPT_ENUM_SET_FLGD(L"-f", L"-features", &mFeaturePresent, &mFeature, mFeatures, L"[list]features")
+SWTABLE_END
+
+STATIC SHELL_STATUS Parse(CONST CHAR8 *Line)
+{
+    mLevel = 0;
+    mFeature = 0;
+    mFeaturePresent = FALSE;
+    SetArgs(Line);
+    return ParseCmdLine(NULL, 0, mSwTable, NULL, NO_OPT, NULL);
+}
+
+// the same line as a CHAR8 vector
+STATIC SHELL_STATUS ParseAscii(CONST CHAR8 *Line)
+{
+    CHAR8 Tmp[256];
+    CHAR8 *Argv[16];
+    UINTN Argc = 0;
+
+    snprintf(Tmp, sizeof(Tmp), "%s", Line);
+    for (CHAR8 *Tok = strtok(Tmp, " "); Tok && (Argc < 16); Tok = strtok(NULL, " ")) {
+        Argv[Argc++] = Tok;
+    }
+    mLevel = 0;
+    mFeature = 0;
+    mFeaturePresent = FALSE;
+    StubClearOutput();
+    return ParseArgvAscii(Argc, Argv, NULL, 0, mSwTable, NULL, NO_OPT, NULL);
+}
+
+STATIC VOID TestScanned(VOID)
+{
+    CHECK(Parse("p -l err,info") == SHELL_SUCCESS);
+    CHECK(mLevel == 0x9);
+
+    // matched by length, not prefix, and case insensitive
+    CHECK(Parse("p -l WARN") == SHELL_SUCCESS);
+    CHECK(mLevel == 0x2);
+    CHECK(Parse("p -l Warning") == SHELL_SUCCESS);
+    CHECK(mLevel == 0x4);
+    CHECK(Parse("p -l all,^warning") == SHELL_SUCCESS);
+    CHECK(mLevel == 0xB);
+
+    CHECK(Parse("p -l wa") == SHELL_INVALID_PARAMETER);
+    CHECK(Output("has invalid option"));
+}
+
+STATIC VOID TestIndexed(VOID)
+{
+    CHECK(Parse("p -f sse,avx2,debug") == SHELL_SUCCESS);
+    CHECK(mFeaturePresent && (mFeature == ((1ULL << 0) | (1ULL << 4) | (1ULL << 40))));
+
+    // read from left to right
+    CHECK(Parse("p -f all") == SHELL_SUCCESS);
+    CHECK(mFeature == ALL_FEATURES);
+    CHECK(Parse("p -f all,^debug,^sse") == SHELL_SUCCESS);
+    CHECK(mFeature == (ALL_FEATURES & ~((1ULL << 40) | 1ULL)));
+    CHECK(Parse("p -f ^aes,aes") == SHELL_SUCCESS);
+    CHECK(mFeature == (1ULL << 5));
+    CHECK(Parse("p -f aes,none,sha") == SHELL_SUCCESS);
+    CHECK(mFeature == (1ULL << 7));
+    CHECK(Parse("p -f NONE") == SHELL_SUCCESS);
+    CHECK(mFeaturePresent && (mFeature == 0));
+    // removing none leaves the set as it was
+    CHECK(Parse("p -f sha,^none") == SHELL_SUCCESS);
+    CHECK(mFeature == (1ULL << 7));
+
+    // unknown and empty elements
+    CHECK(Parse("p -f sse,avx512") == SHELL_INVALID_PARAMETER);
+    CHECK(Output("has invalid option"));
+    CHECK(Parse("p -f sse,,avx") == SHELL_INVALID_PARAMETER);
+    CHECK(Parse("p -f sse,") == SHELL_INVALID_PARAMETER);
+    CHECK(Parse("p -f ^") == SHELL_INVALID_PARAMETER);
+    CHECK(Parse("p -f ss") == SHELL_INVALID_PARAMETER);
+}
+
+STATIC VOID TestNarrow(VOID)
+{
+    CHECK(ParseAscii("p -l info,err -f all,^rdrand") == SHELL_SUCCESS);
+    CHECK((mLevel == 0x9) && (mFeature == (ALL_FEATURES & ~(1ULL << 6))));
+    CHECK(ParseAscii("p -f SHA,debug") == SHELL_SUCCESS);
+    CHECK(mFeature == ((1ULL << 7) | (1ULL << 40)));
+    CHECK(ParseAscii("p -l warn,bogus") == SHELL_INVALID_PARAMETER);
+    CHECK(Output("has invalid option") && Output("warn,bogus"));
+    CHECK(ParseAscii("p -f sse3,") == SHELL_INVALID_PARAMETER);
+}
+
+STATIC VOID TestKeywordMembers(VOID)
+{
+    SWTABLE_START(HasAll)
+    SWTABLE_OPT_ENUM_SET(L"-s", NULL, &mLevel, mHasAll, L"set")
+    SWTABLE_END
+    SWTABLE_START(HasNone)
+    SWTABLE_OPT_ENUM_SET(L"-s", NULL, &mLevel, mHasNone, L"set")
+    SWTABLE_END
+    PARAMTABLE_START(ParamHasAll)
+    PARAMTABLE_ENUM_SET(&mLevel, mHasAll, L"set")
+    PARAMTABLE_END
+    // a plain enum may use the names
+    SWTABLE_START(EnumHasAll)
+    SWTABLE_OPT_ENUM(L"-e", NULL, &mLevel, mHasAll, L"enum")
+    SWTABLE_END
+
+    StubClearOutput();
+    CHECK(CmdLineValidateTables(NULL, 0, HasAll, NO_OPT) == SHELL_INVALID_PARAMETER);
+    CHECK(Output("Keyword 'all' or 'none'"));
+    CHECK(CmdLineValidateTables(NULL, 0, HasNone, NO_OPT) == SHELL_INVALID_PARAMETER);
+    CHECK(CmdLineValidateTables(ParamHasAll, 1, NULL, NO_OPT) == SHELL_INVALID_PARAMETER);
+    CHECK(CmdLineValidateTables(NULL, 0, EnumHasAll, NO_OPT) == SHELL_SUCCESS);
+    SetArgs("p -s one");
+    CHECK(ParseCmdLine(NULL, 0, HasAll, NULL, NO_OPT, NULL) == SHELL_INVALID_PARAMETER);
+}
+
+int main(void)
+{
+    TestScanned();
+    TestIndexed();
+    TestNarrow();
+    TestKeywordMembers();
+    CmdLineFree(NULL);
+
+    return TestSummary("EnumSetTest");
+}
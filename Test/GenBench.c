@@ -0,0 +1,106 @@
+/***********************************************************************
+
+ GenBench.c
+
+ Times a parser generated by CMDLINE_DEFINE_PARSER() against
+ CmdLineParseArgvConfig() on a compiled parser of the same tables,
+ and against its own fallback to that parser, for the same command
+ line; the config structs filled must match
+
+***********************************************************************/
+
+#include "../CmdLine.c"
+#include "TestCommon.h"
+
+#define BENCH_PARSES    200000
+
+#define BENCH_SWITCHES(X) \
+    X(FLAG, BOOLEAN, L"-v", L"-verbose", Verbose, L"verbose output") \
+    X(FLAG, BOOLEAN, L"-q", L"-quiet",   Quiet,   L"quiet output") \
+    X(DEC,  UINT32,  L"-n", L"-count",   Count,   L"[num]repeat count") \
+    X(HEX,  UINT64,  L"-a", L"-address", Address, L"[addr]base address") \
+    X(INT,  UINT16,  L"-w", L"-width",   Width,   L"[num]access width") \
+    X(SINT, INT32,   L"-o", L"-offset",  Offset,  L"[num]offset") \
+    X(STRREF, CMDLINE_STRREF, L"-f", L"-file", File, L"[file]output file")
+#define BENCH_PARAMS(X) \
+    X(STRREF, CMDLINE_STRREF, Device, L"[dev]device name") \
+    X(INT,    UINT32,         Lba,    L"[lba]start block")
+
+CMDLINE_DEFINE_PARSER(Bench, BENCH_SWITCHES, BENCH_PARAMS, 1, L"Generated parser benchmark")
+
+// the same tables for the table API
+SWTABLE_START(mSwTable)
+SWTABLE_OPT_FLAG(L"-v", L"-verbose", CMDLINE_FIELD(Bench_CONFIG, Verbose), L"verbose output")
+SWTABLE_OPT_FLAG(L"-q", L"-quiet", CMDLINE_FIELD(Bench_CONFIG, Quiet), L"quiet output")
+SWTABLE_OPT_DEC32(L"-n", L"-count", CMDLINE_FIELD(Bench_CONFIG, Count), L"[num]repeat count")
+SWTABLE_OPT_HEX64(L"-a", L"-address", CMDLINE_FIELD(Bench_CONFIG, Address), L"[addr]base address")
+SWTABLE_OPT_INT16(L"-w", L"-width", CMDLINE_FIELD(Bench_CONFIG, Width), L"[num]access width")
+SWTABLE_OPT_SINT32(L"-o", L"-offset", CMDLINE_FIELD(Bench_CONFIG, Offset), L"[num]offset")
+SWTABLE_OPT_STRREF(L"-f", L"-file", CMDLINE_FIELD(Bench_CONFIG, File), L"[file]output file")
+SWTABLE_END
+
+PARAMTABLE_START(mParamTable)
+PARAMTABLE_STRREF(CMDLINE_FIELD(Bench_CONFIG, Device), L"[dev]device name")
+PARAMTABLE_INT32(CMDLINE_FIELD(Bench_CONFIG, Lba), L"[lba]start block")
+PARAMTABLE_END
+
+STATIC CHAR16 *mArgv[] = { L"bench", L"-v", L"-n", L"10", L"-a", L"FFE00000", L"-width", L"0x20",
+                           L"-o", L"300", L"-f", L"out.bin", L"blk0", L"0x800" };
+// a negative value is left to the table parser
+STATIC CHAR16 *mFallbackArgv[] = { L"bench", L"-v", L"-n", L"10", L"-a", L"FFE00000", L"-width", L"0x20",
+                                   L"-o", L"-300", L"-f", L"out.bin", L"blk0", L"0x800" };
+
+#define BENCH_ARGC  (sizeof(mArgv) / sizeof(mArgv[0]))
+
+STATIC BOOLEAN SameConfig(CONST Bench_CONFIG *A, CONST Bench_CONFIG *B)
+{
+    return (A->Verbose == B->Verbose) && (A->Quiet == B->Quiet) && (A->Count == B->Count) &&
+           (A->Address == B->Address) && (A->Width == B->Width) && (A->Offset == B->Offset) &&
+           (A->File.Str == B->File.Str) && (A->File.Len == B->File.Len) &&
+           (A->Device.Str == B->Device.Str) && (A->Device.Len == B->Device.Len) && (A->Lba == B->Lba);
+}
+
+int main(void)
+{
+    Bench_CONFIG Gen = { 0 };
+    Bench_CONFIG Table = { 0 };
+    CMDLINE_PARSER *Parser;
+    UINT64 Start;
+    UINT64 GenNs, TableNs, FallbackNs;
+
+    CHECK(CmdLineCompile(mParamTable, 1, mSwTable, NULL, NO_OPT, &Parser) == SHELL_SUCCESS);
+
+    // both fill the same config
+    CHECK(Bench_Parse(BENCH_ARGC, mArgv, &Gen, NULL) == SHELL_SUCCESS);
+    CHECK(CmdLineParseArgvConfig(Parser, BENCH_ARGC, mArgv, &Table, NULL) == SHELL_SUCCESS);
+    CHECK(SameConfig(&Gen, &Table) && (Gen.Offset == 300) && (Gen.Width == 0x20));
+    CHECK(Bench_Parse(BENCH_ARGC, mFallbackArgv, &Gen, NULL) == SHELL_SUCCESS);
+    CHECK(Gen.Offset == -300);
+
+    Start = GetPerformanceCounter();
+    for (UINTN n = 0; n < BENCH_PARSES; n++) {
+        Bench_Parse(BENCH_ARGC, mArgv, &Gen, NULL);
+    }
+    GenNs = GetTimeInNanoSecond(GetPerformanceCounter() - Start);
+
+    Start = GetPerformanceCounter();
+    for (UINTN n = 0; n < BENCH_PARSES; n++) {
+        CmdLineParseArgvConfig(Parser, BENCH_ARGC, mArgv, &Table, NULL);
+    }
+    TableNs = GetTimeInNanoSecond(GetPerformanceCounter() - Start);
+
+    Start = GetPerformanceCounter();
+    for (UINTN n = 0; n < BENCH_PARSES; n++) {
+        Bench_Parse(BENCH_ARGC, mFallbackArgv, &Gen, NULL);
+    }
+    FallbackNs = GetTimeInNanoSecond(GetPerformanceCounter() - Start);
+
+    CmdLineFreeParser(Parser);
+    Bench_Free();
+
+    printf("GenBench: ns per parse, %u arguments\n", (unsigned)BENCH_ARGC - 1);
+    printf("  generated parser      %8.1f ns\n", (double)GenNs / BENCH_PARSES);
+    printf("  compiled table parser %8.1f ns\n", (double)TableNs / BENCH_PARSES);
+    printf("  generated, fallback   %8.1f ns\n", (double)FallbackNs / BENCH_PARSES);
+    return TestSummary("GenBench");
+}
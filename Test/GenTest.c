@@ -0,0 +1,91 @@
+/***********************************************************************
+
+ GenTest.c
+
+ Host tests of parsers generated by CMDLINE_DEFINE_PARSER()
+
+***********************************************************************/
+
+#include "../CmdLine.c"
+#include "TestCommon.h"
+
+#define TOOL_SWITCHES(X) \
+    X(FLAG, BOOLEAN, L"-v", L"-verbose", Verbose, L"verbose output") \
+    X(DEC,  UINT8,   L"-n", L"-count",   Count,   L"[num]repeat count") \
+    X(SINT, INT16,   L"-o", L"",         Offset,  L"[num]offset")
+#define TOOL_PARAMS(X) \
+    X(STRREF, CMDLINE_STRREF, Device, L"[dev]device name") \
+    X(HEX,    UINT32,         Lba,    L"[lba]start block")
+
+CMDLINE_DEFINE_PARSER(Tool, TOOL_SWITCHES, TOOL_PARAMS, 1, L"Device tool")
+
+STATIC Tool_CONFIG mConfig;
+
+STATIC SHELL_STATUS Parse(CONST CHAR8 *Line, UINTN *NumParams)
+{
+    UINTN Argc = SetArgs(Line);
+    return Tool_Parse(Argc, mTestArgv, &mConfig, NumParams);
+}
+
+// config filled with values no parse below enters
+STATIC VOID ResetConfig(VOID)
+{
+    ZeroMem(&mConfig, sizeof(mConfig));
+    mConfig.Count = 99;
+    mConfig.Offset = 99;
+    mConfig.Lba = 99;
+}
+
+STATIC BOOLEAN Unchanged(VOID)
+{
+    return !mConfig.Verbose && (mConfig.Count == 99) && (mConfig.Offset == 99) && (mConfig.Lba == 99) && !mConfig.Device.Str;
+}
+
+int main(void)
+{
+    UINTN NumParams;
+
+    // generated path
+    ResetConfig();
+    CHECK(Parse("tool -v -count 12 blk0 1F", &NumParams) == SHELL_SUCCESS);
+    CHECK(mConfig.Verbose && (mConfig.Count == 12) && (mConfig.Lba == 0x1F) && (NumParams == 2));
+    CHECK((mConfig.Device.Len == 4) && (StrCmp(mConfig.Device.Str, L"blk0") == 0));
+    CHECK(mConfig.Offset == 99);
+
+    // negative values and abbreviations go to the table parser
+    ResetConfig();
+    CHECK(Parse("tool -o -5 blk0", &NumParams) == SHELL_SUCCESS);
+    CHECK((mConfig.Offset == -5) && (NumParams == 1) && (mConfig.Count == 99));
+
+    // a failed parse leaves the config as it was, whichever path finds the error
+    ResetConfig();
+    CHECK(Parse("tool -v -n 12 blk0 1F 2", &NumParams) == SHELL_INVALID_PARAMETER);
+    CHECK(Output("Too many parameters"));
+    CHECK(Unchanged());
+    ResetConfig();
+    CHECK(Parse("tool -v -n 300 blk0", NULL) == SHELL_INVALID_PARAMETER);
+    CHECK(Unchanged());
+    ResetConfig();
+    CHECK(Parse("tool -v -o -5 -x blk0", NULL) == SHELL_INVALID_PARAMETER);
+    CHECK(Output("Unrecognised switch"));
+    CHECK(Unchanged());
+    ResetConfig();
+    CHECK(Parse("tool -v", NULL) == SHELL_INVALID_PARAMETER);
+    CHECK(Output("Too few parameters"));
+    CHECK(Unchanged());
+    ResetConfig();
+    CHECK(Parse("tool -v blk0 -h", NULL) == SHELL_ABORTED);
+    CHECK(Output("Device tool"));
+    CHECK(Unchanged());
+
+    // the table parser is compiled once and kept
+    CHECK(Tool_Parser != NULL);
+    CMDLINE_PARSER *Kept = Tool_Parser;
+    CHECK(Parse("tool -o -1 blk0", NULL) == SHELL_SUCCESS);
+    CHECK(Tool_Parser == Kept);
+    Tool_Free();
+    CHECK(Tool_Parser == NULL);
+    Tool_Free();
+
+    return TestSummary("GenTest");
+}
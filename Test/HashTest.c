@@ -0,0 +1,135 @@
+/***********************************************************************
+
+ HashTest.c
+
+ Host tests of the case-folded string hash index and the enum index
+
+***********************************************************************/
+
+#include "../CmdLine.c"
+#include "TestCommon.h"
+
+// K0590E7 and K01B05F have the same hash and length, so only the string compare tells them apart
+STATIC CONST CHAR16 *mCollide1 = L"K0590E7";
+STATIC CONST CHAR16 *mCollide2 = L"K01B05F";
+
+STATIC VOID TestHashFoldStr(VOID)
+{
+    UINTN Len1, Len2;
+
+    CHECK(HashFoldStr(L"-Verbose", FALSE, L'\0', &Len1) == HashFoldStr(L"-VERBOSE", FALSE, L'\0', &Len2));
+    CHECK((Len1 == 8) && (Len2 == 8));
+    CHECK(HashFoldStr(L"abc,def", FALSE, L',', &Len1) == HashFoldStr(L"ABC", FALSE, L'\0', &Len2));
+    CHECK((Len1 == 3) && (Len2 == 3));
+    CHECK(HashFoldStr(L"", FALSE, L'\0', &Len1) == 0x811C9DC5);
+    CHECK(Len1 == 0);
+    CHECK(HashFoldStr(mCollide1, FALSE, L'\0', &Len1) == HashFoldStr(mCollide2, FALSE, L'\0', &Len2));
+    // only 'a' to 'z' are folded
+    CHECK(HashFoldStr(L"\x00E9", FALSE, L'\0', &Len1) != HashFoldStr(L"\x00C9", FALSE, L'\0', &Len2));
+}
+
+STATIC VOID TestStrniEqual(VOID)
+{
+    CHECK(StrniEqual(L"abcdefghij", L"ABCDEFGHIJ", 10));
+    CHECK(StrniEqual(L"-Zz@[`{", L"-zZ@[`{", 7));
+    CHECK(!StrniEqual(L"@", L"`", 1));
+    CHECK(!StrniEqual(L"abcdX", L"abcdY", 5));
+    CHECK(!StrniEqual(L"[abc", L"{abc", 4));
+    CHECK(!StrniEqual(L"\x00E9xyz", L"\x00C9xyz", 4));
+    CHECK(FoldChar16x4(0x007A0061005B0040ULL) == 0x005A0041005B0040ULL);
+}
+
+STATIC VOID TestStrIndex(VOID)
+{
+    STR_INDEX Index;
+    CONST STR_INDEX_KEY *Key;
+
+    CHECK(StrIndexInit(&Index, 4) == EFI_SUCCESS);
+    CHECK(StrIndexAdd(&Index, mCollide1, 1));
+    CHECK(StrIndexAdd(&Index, mCollide2, 2));
+    CHECK(StrIndexAdd(&Index, L"-help", 3));
+    // first string added wins
+    CHECK(!StrIndexAdd(&Index, L"-HELP", 4));
+    Key = StrIndexFind(&Index, L"k0590e7", FALSE, L'\0');
+    CHECK(Key && (Key->Id == 1));
+    Key = StrIndexFind(&Index, L"k01b05f", FALSE, L'\0');
+    CHECK(Key && (Key->Id == 2));
+    Key = StrIndexFind(&Index, L"-Help", FALSE, L'\0');
+    CHECK(Key && (Key->Id == 3));
+    Key = StrIndexFind(&Index, L"-help,x", FALSE, L',');
+    CHECK(Key && (Key->Id == 3));
+    CHECK(StrIndexFind(&Index, L"-hel", FALSE, L'\0') == NULL);
+    CHECK(StrIndexFind(&Index, L"-helpx", FALSE, L'\0') == NULL);
+    CHECK(StrIndexFind(&Index, L"", FALSE, L'\0') == NULL);
+    StrIndexFree(&Index);
+    CHECK(StrIndexFind(&Index, L"-help", FALSE, L'\0') == NULL);
+
+    // fill to the load limit so probes wrap around the slot array
+    CHAR16 Names[64][8];
+    CHECK(StrIndexInit(&Index, 64) == EFI_SUCCESS);
+    for (UINTN i = 0; i < 64; i++) {
+        CHAR8 Name[8];
+        snprintf(Name, sizeof(Name), "-s%u", (unsigned)i);
+        Widen(Names[i], Name);
+        CHECK(StrIndexAdd(&Index, Names[i], i));
+    }
+    for (UINTN i = 0; i < 64; i++) {
+        Key = StrIndexFind(&Index, Names[i], FALSE, L'\0');
+        CHECK(Key && (Key->Id == i));
+    }
+    CHECK(StrIndexFind(&Index, L"-s64", FALSE, L'\0') == NULL);
+    StrIndexFree(&Index);
+
+    CHECK(StrIndexInit(&Index, STR_INDEX_MAX_KEYS + 1) == EFI_OUT_OF_RESOURCES);
+}
+
+// values close together, looked up in a dense table
+ENUMSTR_START(mDense)
+ENUMSTR_ENTRY(12, L"twelve")
+ENUMSTR_ENTRY(10, L"ten")
+ENUMSTR_ENTRY(11, L"eleven")
+ENUMSTR_ENTRY(10, L"dix")
+ENUMSTR_END
+
+// values far apart, looked up in the sorted table
+ENUMSTR_START(mSparse)
+ENUMSTR_ENTRY(0x80000000, L"high")
+ENUMSTR_ENTRY(7, L"seven")
+ENUMSTR_ENTRY(0x1000, L"page")
+ENUMSTR_ENTRY(7, L"sept")
+ENUMSTR_ENTRY(0, L"zero")
+ENUMSTR_END
+
+STATIC VOID TestEnumIndex(VOID)
+{
+    CMDLINE_ENUM_INDEX *EnumIndex;
+    UINTN Value;
+
+    CHECK(CmdLineEnumIndexCreate(mDense, &EnumIndex) == SHELL_SUCCESS);
+    CHECK(EnumIndex->DenseSize == 3);
+    CHECK(CmdLineEnumIndexFind(EnumIndex, L"ELEVEN", &Value) && (Value == 11));
+    CHECK(StrCmp(CmdLineEnumIndexName(EnumIndex, 12), L"twelve") == 0);
+    // the first entry wins for a value entered twice
+    CHECK(StrCmp(CmdLineEnumIndexName(EnumIndex, 10), L"ten") == 0);
+    CHECK(CmdLineEnumIndexName(EnumIndex, 13) == NULL);
+    CmdLineEnumIndexFree(EnumIndex);
+
+    CHECK(CmdLineEnumIndexCreate(mSparse, &EnumIndex) == SHELL_SUCCESS);
+    CHECK(EnumIndex->DenseSize == 0);
+    CHECK(CmdLineEnumIndexFind(EnumIndex, L"page", &Value) && (Value == 0x1000));
+    CHECK(StrCmp(CmdLineEnumIndexName(EnumIndex, 0x80000000), L"high") == 0);
+    CHECK(StrCmp(CmdLineEnumIndexName(EnumIndex, 0), L"zero") == 0);
+    CHECK(StrCmp(CmdLineEnumIndexName(EnumIndex, 7), L"seven") == 0);
+    CHECK(CmdLineEnumIndexName(EnumIndex, 8) == NULL);
+    CHECK(!CmdLineEnumIndexFind(EnumIndex, L"pag", NULL));
+    CmdLineEnumIndexFree(EnumIndex);
+}
+
+int main(void)
+{
+    TestHashFoldStr();
+    TestStrniEqual();
+    TestStrIndex();
+    TestEnumIndex();
+    return TestSummary("HashTest");
+}
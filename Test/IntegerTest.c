@@ -0,0 +1,117 @@
+/***********************************************************************
+
+ IntegerTest.c
+
+ Host tests of the single pass integer parser
+
+***********************************************************************/
+
+#include "../CmdLine.c"
+#include "TestCommon.h"
+
+STATIC UINT64 mValue;
+
+// checks status and, when VAL_OK, the value
+#define CHECK_INT(Str, Type, Size, Status, Expected) \
+    do { \
+        mValue = 0xDEADBEEF; \
+        CHECK(ParseInteger(Str, FALSE, Type, Size, &mValue) == (Status)); \
+        if ((Status) == VAL_OK) { \
+            CHECK(mValue == (UINT64)(Expected)); \
+        } \
+    } while (0)
+
+STATIC VOID TestDecimal(VOID)
+{
+    CHECK_INT(L"0", VALTYPE_DECIMAL, SIZE32, VAL_OK, 0);
+    CHECK_INT(L"  \t0042", VALTYPE_DECIMAL, SIZE32, VAL_OK, 42);
+    CHECK_INT(L"", VALTYPE_DECIMAL, SIZE32, VAL_DEC_INVALID, 0);
+    CHECK_INT(L" ", VALTYPE_DECIMAL, SIZE32, VAL_DEC_INVALID, 0);
+    CHECK_INT(L"12a", VALTYPE_DECIMAL, SIZE32, VAL_DEC_INVALID, 0);
+    CHECK_INT(L"0x10", VALTYPE_DECIMAL, SIZE32, VAL_DEC_INVALID, 0);
+    CHECK_INT(L"-1", VALTYPE_DECIMAL, SIZE32, VAL_DEC_INVALID, 0);
+    CHECK_INT(L"+1", VALTYPE_DECIMAL, SIZE32, VAL_DEC_INVALID, 0);
+
+    // bounds of each size
+    CHECK_INT(L"255", VALTYPE_DECIMAL, SIZE8, VAL_OK, 255);
+    CHECK_INT(L"256", VALTYPE_DECIMAL, SIZE8, VAL_UINT8_TOO_BIG, 0);
+    CHECK_INT(L"65535", VALTYPE_DECIMAL, SIZE16, VAL_OK, 65535);
+    CHECK_INT(L"65536", VALTYPE_DECIMAL, SIZE16, VAL_UINT16_TOO_BIG, 0);
+    CHECK_INT(L"4294967295", VALTYPE_DECIMAL, SIZE32, VAL_OK, MAX_UINT32);
+    CHECK_INT(L"4294967296", VALTYPE_DECIMAL, SIZE32, VAL_UINT32_TOO_BIG, 0);
+    CHECK_INT(L"18446744073709551615", VALTYPE_DECIMAL, SIZE64, VAL_OK, MAX_UINT64);
+    CHECK_INT(L"18446744073709551616", VALTYPE_DECIMAL, SIZE64, VAL_UINT64_TOO_BIG, 0);
+    CHECK_INT(L"18446744073709551620", VALTYPE_DECIMAL, SIZE64, VAL_UINT64_TOO_BIG, 0);
+    CHECK_INT(L"99999999999999999999999", VALTYPE_DECIMAL, SIZE64, VAL_UINT64_TOO_BIG, 0);
+    CHECK_INT(L"000000000000000000000000001", VALTYPE_DECIMAL, SIZE8, VAL_OK, 1);
+
+    // too big, but still validated to the end
+    CHECK_INT(L"99999999999999999999999z", VALTYPE_DECIMAL, SIZE64, VAL_DEC_INVALID, 0);
+}
+
+STATIC VOID TestHex(VOID)
+{
+    CHECK_INT(L"ff", VALTYPE_HEXIDECIMAL, SIZE8, VAL_OK, 0xFF);
+    CHECK_INT(L"0xFf", VALTYPE_HEXIDECIMAL, SIZE8, VAL_OK, 0xFF);
+    CHECK_INT(L"0X1b", VALTYPE_HEXIDECIMAL, SIZE8, VAL_OK, 0x1B);
+    CHECK_INT(L"100", VALTYPE_HEXIDECIMAL, SIZE8, VAL_UINT8_TOO_BIG, 0);
+    CHECK_INT(L"0x", VALTYPE_HEXIDECIMAL, SIZE8, VAL_HEX_INVALID, 0);
+    CHECK_INT(L"x1", VALTYPE_HEXIDECIMAL, SIZE8, VAL_HEX_INVALID, 0);
+    CHECK_INT(L"0xg", VALTYPE_HEXIDECIMAL, SIZE8, VAL_HEX_INVALID, 0);
+    CHECK_INT(L"FFFFFFFFFFFFFFFF", VALTYPE_HEXIDECIMAL, SIZE64, VAL_OK, MAX_UINT64);
+    CHECK_INT(L"0x00000000FFFFFFFFFFFFFFFF", VALTYPE_HEXIDECIMAL, SIZE64, VAL_OK, MAX_UINT64);
+    CHECK_INT(L"10000000000000000", VALTYPE_HEXIDECIMAL, SIZE64, VAL_UINT64_TOO_BIG, 0);
+    CHECK_INT(L"FFFFFFFF", VALTYPE_HEXIDECIMAL, SIZE32, VAL_OK, MAX_UINT32);
+    CHECK_INT(L"100000000", VALTYPE_HEXIDECIMAL, SIZE32, VAL_UINT32_TOO_BIG, 0);
+}
+
+STATIC VOID TestInteger(VOID)
+{
+    CHECK_INT(L"10", VALTYPE_INTEGER, SIZE32, VAL_OK, 10);
+    CHECK_INT(L"0x10", VALTYPE_INTEGER, SIZE32, VAL_OK, 16);
+    CHECK_INT(L"10h", VALTYPE_INTEGER, SIZE32, VAL_INT_INVALID, 0);
+    CHECK_INT(L"ff", VALTYPE_INTEGER, SIZE32, VAL_INT_INVALID, 0);
+    CHECK_INT(L"0xFFFF", VALTYPE_INTEGER, SIZE16, VAL_OK, 0xFFFF);
+    CHECK_INT(L"0x10000", VALTYPE_INTEGER, SIZE16, VAL_UINT16_TOO_BIG, 0);
+}
+
+STATIC VOID TestSigned(VOID)
+{
+    CHECK_INT(L"-128", VALTYPE_SIGNED, SIZE8, VAL_OK, (UINT64)-128);
+    CHECK_INT(L"-129", VALTYPE_SIGNED, SIZE8, VAL_INT8_OUT_OF_RANGE, 0);
+    CHECK_INT(L"+127", VALTYPE_SIGNED, SIZE8, VAL_OK, 127);
+    CHECK_INT(L"128", VALTYPE_SIGNED, SIZE8, VAL_INT8_OUT_OF_RANGE, 0);
+    CHECK_INT(L"-32768", VALTYPE_SIGNED, SIZE16, VAL_OK, (UINT64)-32768);
+    CHECK_INT(L"32768", VALTYPE_SIGNED, SIZE16, VAL_INT16_OUT_OF_RANGE, 0);
+    CHECK_INT(L"-2147483648", VALTYPE_SIGNED, SIZE32, VAL_OK, (UINT64)(-2147483647LL - 1));
+    CHECK_INT(L"2147483648", VALTYPE_SIGNED, SIZE32, VAL_INT32_OUT_OF_RANGE, 0);
+    CHECK_INT(L"-9223372036854775808", VALTYPE_SIGNED, SIZE64, VAL_OK, 0x8000000000000000ULL);
+    CHECK_INT(L"-9223372036854775809", VALTYPE_SIGNED, SIZE64, VAL_INT64_OUT_OF_RANGE, 0);
+    CHECK_INT(L"9223372036854775807", VALTYPE_SIGNED, SIZE64, VAL_OK, MAX_INT64);
+    CHECK_INT(L"9223372036854775808", VALTYPE_SIGNED, SIZE64, VAL_INT64_OUT_OF_RANGE, 0);
+    CHECK_INT(L"-0x80", VALTYPE_SIGNED, SIZE8, VAL_OK, (UINT64)-128);
+    CHECK_INT(L"0x80", VALTYPE_SIGNED, SIZE8, VAL_INT8_OUT_OF_RANGE, 0);
+    CHECK_INT(L"-0", VALTYPE_SIGNED, SIZE8, VAL_OK, 0);
+    CHECK_INT(L"-", VALTYPE_SIGNED, SIZE8, VAL_SINT_INVALID, 0);
+    CHECK_INT(L"--1", VALTYPE_SIGNED, SIZE8, VAL_SINT_INVALID, 0);
+    CHECK_INT(L"- 1", VALTYPE_SIGNED, SIZE8, VAL_SINT_INVALID, 0);
+}
+
+STATIC VOID TestUnsupported(VOID)
+{
+    CHECK_INT(L"1", VALTYPE_STRING, SIZE32, VAL_UNSUPPORTED_TYPE, 0);
+    CHECK_INT(L"1", VALTYPE_DECIMAL, (VALUE_SIZE)99, VAL_UNSUPPORTED_SIZE, 0);
+    // failed parses leave the value as is
+    CHECK_INT(L"256", VALTYPE_DECIMAL, SIZE8, VAL_UINT8_TOO_BIG, 0);
+    CHECK(mValue == 0xDEADBEEF);
+}
+
+int main(void)
+{
+    TestDecimal();
+    TestHex();
+    TestInteger();
+    TestSigned();
+    TestUnsupported();
+    return TestSummary("IntegerTest");
+}
@@ -0,0 +1,81 @@
+/***********************************************************************
+
+ NarrowTest.c
+
+ Host tests of the CHAR16 to ASCII narrowing
+
+***********************************************************************/
+
+#include "../CmdLine.c"
+#include "TestCommon.h"
+#include <stdlib.h>
+
+// copies Str to the end of an exactly sized heap block, so reads past the terminator are caught
+STATIC CHAR16 *ExactCopy(CONST CHAR16 *Str)
+{
+    UINTN Size = (StrLen(Str) + 1) * sizeof(CHAR16);
+    CHAR16 *Copy = malloc(Size);
+    memcpy(Copy, Str, Size);
+    return Copy;
+}
+
+STATIC VOID TestNarrow(CONST CHAR16 *Str, UINTN DestSize, EFI_STATUS Status, CONST CHAR8 *Expected, UINTN ExpectedLen)
+{
+    CHAR16 *Source = ExactCopy(Str);
+    CHAR8 *Dest = DestSize ? malloc(DestSize) : NULL;
+    UINTN Len = 0;
+
+    CHECK(CmdLineNarrowStr(Source, Dest, DestSize, &Len) == Status);
+    CHECK(Len == ExpectedLen);
+    if (Dest && Expected) {
+        CHECK(strcmp(Dest, Expected) == 0);
+    }
+    free(Dest);
+    free(Source);
+}
+
+int main(void)
+{
+    CHAR16 Long[48];
+    CHAR8 LongAscii[48];
+
+    TestNarrow(L"", 1, EFI_SUCCESS, "", 0);
+    TestNarrow(L"a", 2, EFI_SUCCESS, "a", 1);
+    TestNarrow(L"abc", 4, EFI_SUCCESS, "abc", 3);
+    TestNarrow(L"abcd", 5, EFI_SUCCESS, "abcd", 4);
+    TestNarrow(L"abcdefghi", 10, EFI_SUCCESS, "abcdefghi", 9);
+    TestNarrow(L"~\x7F !", 5, EFI_SUCCESS, "~\x7F !", 4);
+
+    // truncated to fit, still measured
+    TestNarrow(L"abcdefghi", 5, EFI_BUFFER_TOO_SMALL, "abcd", 9);
+    TestNarrow(L"abcdefghi", 1, EFI_BUFFER_TOO_SMALL, "", 9);
+    TestNarrow(L"abcdefghi", 0, EFI_BUFFER_TOO_SMALL, NULL, 9);
+    TestNarrow(L"", 0, EFI_SUCCESS, NULL, 0);
+
+    // non-ASCII in the word loop, the tail and past the end of the destination
+    TestNarrow(L"ab\x0080" L"defgh", 20, EFI_INVALID_PARAMETER, NULL, 2);
+    TestNarrow(L"abcdefg\x00E9", 20, EFI_INVALID_PARAMETER, NULL, 7);
+    TestNarrow(L"abcdefg\x0100", 3, EFI_INVALID_PARAMETER, NULL, 7);
+    TestNarrow(L"\x2603", 4, EFI_INVALID_PARAMETER, NULL, 0);
+
+    // every length and alignment around the word size
+    for (UINTN i = 0; i < 48; i++) {
+        Long[i] = (CHAR16)(L'A' + i);
+        LongAscii[i] = (CHAR8)('A' + i);
+    }
+    for (UINTN Start = 0; Start < 4; Start++) {
+        for (UINTN Len = 0; Len < 40; Len++) {
+            Long[Start + Len] = L'\0';
+            LongAscii[Start + Len] = '\0';
+            TestNarrow(&Long[Start], 64, EFI_SUCCESS, &LongAscii[Start], Len);
+            TestNarrow(&Long[Start], Len / 2 + 1, (Len > Len / 2) ? EFI_BUFFER_TOO_SMALL : EFI_SUCCESS, NULL, Len);
+            Long[Start + Len] = (CHAR16)(L'A' + Start + Len);
+            LongAscii[Start + Len] = (CHAR8)('A' + Start + Len);
+        }
+    }
+
+    CHECK(CmdLineNarrowStr(NULL, NULL, 0, NULL) == EFI_INVALID_PARAMETER);
+    CHECK(CmdLineNarrowStr(L"a", NULL, 4, NULL) == EFI_INVALID_PARAMETER);
+
+    return TestSummary("NarrowTest");
+}
@@ -0,0 +1,104 @@
+/***********************************************************************
+
+ PassThroughTest.c
+
+ Host tests of the arguments after '--' and running them with
+ CmdLineExecute()
+
+***********************************************************************/
+
+#include "../CmdLine.c"
+#include "TestCommon.h"
+
+#define TEST_IMAGE_HANDLE   ((EFI_HANDLE)(UINTN)0x1234)
+
+STATIC UINTN    mCount;
+STATIC BOOLEAN  mVerbose;
+
+SWTABLE_START(mSwTable)
+SWTABLE_OPT_DEC(L"-n", L"-count", &mCount, L"[n]repeat count")
+SWTABLE_OPT_FLAG(L"-v", L"-verbose", &mVerbose, L"verbose")
+SWTABLE_END
+
+STATIC VOID TestGetPassThrough(VOID)
+{
+    CMDLINE_PARSER *Parser;
+    UINTN Argc;
+    CHAR16 **Argv;
+
+    CHECK(CmdLineCompile(NULL, 0, mSwTable, NULL, PASS_THROUGH, &Parser) == SHELL_SUCCESS);
+
+    // arguments after '--' are left in the vector parsed, switches included
+    SetArgs("repeat -n 10 -- memtest -v -size 16M");
+    CHECK(CmdLineParseArgv(Parser, mTestParams.Argc, mTestArgv, NULL) == SHELL_SUCCESS);
+    CHECK((mCount == 10) && !mVerbose);
+    CHECK(CmdLineGetPassThrough(Parser, &Argc, &Argv));
+    CHECK((Argc == 4) && (Argv == &mTestArgv[4]) && (StrCmp(Argv[0], L"memtest") == 0));
+
+    // '--' with nothing after it
+    SetArgs("repeat -v --");
+    CHECK(CmdLineParseArgv(Parser, mTestParams.Argc, mTestArgv, NULL) == SHELL_SUCCESS);
+    CHECK(CmdLineGetPassThrough(Parser, &Argc, NULL) && (Argc == 0));
+
+    // each parse replaces the last
+    SetArgs("repeat -v");
+    CHECK(CmdLineParseArgv(Parser, mTestParams.Argc, mTestArgv, NULL) == SHELL_SUCCESS);
+    CHECK(!CmdLineGetPassThrough(Parser, &Argc, &Argv) && (Argc == 0) && (Argv == NULL));
+    CmdLineFreeParser(Parser);
+
+    // without PASS_THROUGH '--' is an argument like any other
+    CHECK(CmdLineCompile(NULL, 0, mSwTable, NULL, NO_OPT, &Parser) == SHELL_SUCCESS);
+    SetArgs("repeat -- memtest");
+    CHECK(CmdLineParseArgv(Parser, mTestParams.Argc, mTestArgv, NULL) == SHELL_INVALID_PARAMETER);
+    CHECK(!CmdLineGetPassThrough(Parser, NULL, NULL));
+    CmdLineFreeParser(Parser);
+
+    // the table API keeps no parser to hold the arguments, so rejects the option
+    SetArgs("repeat -n 3 -- memtest -x");
+    mCount = 0;
+    CHECK(ParseCmdLine(NULL, 0, mSwTable, NULL, PASS_THROUGH, NULL) == SHELL_INVALID_PARAMETER);
+    CHECK(Output("PASS_THROUGH needs a parser from CmdLineCompile()") && (mCount == 0));
+    CHAR8 *AsciiArgv[] = { "repeat", "--", "memtest" };
+    StubClearOutput();
+    CHECK(ParseArgvAscii(3, AsciiArgv, NULL, 0, mSwTable, NULL, PASS_THROUGH, NULL) == SHELL_INVALID_PARAMETER);
+    CHECK(Output("PASS_THROUGH needs a parser"));
+    Argc = 1;
+    Argv = mTestArgv;
+    CHECK(!CmdLineGetPassThrough(NULL, &Argc, &Argv) && (Argc == 0) && (Argv == NULL));
+}
+
+STATIC VOID TestExecute(VOID)
+{
+    CHAR16 *Argv[] = { L"memtest", L"-size", L"16M", L"two words", L"", L"a^b|c>\"d\"" };
+    EFI_STATUS ExitStatus = EFI_ABORTED;
+    UINT64 ElapsedNs;
+
+    // arguments are quoted and escaped for the shell, run as a child of the image given
+    StubClearOutput();
+    gStubParentHandle = NULL;
+    CHECK(CmdLineExecute(TEST_IMAGE_HANDLE, 6, Argv, &ExitStatus, &ElapsedNs) == EFI_SUCCESS);
+    CHECK(Output("[memtest -size 16M \"two words\" \"\" a^^b^|c^>^\"d^\"]"));
+    CHECK(gStubParentHandle == TEST_IMAGE_HANDLE);
+    CHECK(ExitStatus == EFI_SUCCESS);
+
+    StubClearOutput();
+    CHECK(CmdLineExecute(gImageHandle, 1, Argv, NULL, NULL) == EFI_SUCCESS);
+    CHECK(Output("[memtest]"));
+    CHECK(gStubParentHandle == gImageHandle);
+
+    // nothing to run
+    StubClearOutput();
+    ExitStatus = EFI_ABORTED;
+    ElapsedNs = 1;
+    CHECK(CmdLineExecute(TEST_IMAGE_HANDLE, 0, Argv, &ExitStatus, &ElapsedNs) == EFI_INVALID_PARAMETER);
+    CHECK((ExitStatus == EFI_SUCCESS) && (ElapsedNs == 0) && !Output("["));
+    CHECK(CmdLineExecute(TEST_IMAGE_HANDLE, 1, NULL, NULL, NULL) == EFI_INVALID_PARAMETER);
+}
+
+int main(void)
+{
+    TestGetPassThrough();
+    TestExecute();
+
+    return TestSummary("PassThroughTest");
+}
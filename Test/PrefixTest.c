@@ -0,0 +1,62 @@
+/***********************************************************************
+
+ PrefixTest.c
+
+ Host tests of unique-prefix switch matching (SW_PREFIX)
+
+***********************************************************************/
+
+#include "../CmdLine.c"
+#include "TestCommon.h"
+
+STATIC BOOLEAN  mVerbose;
+STATIC BOOLEAN  mVersion;
+STATIC UINTN    mCount;
+
+SWTABLE_START(mSwTable)
+SWTABLE_OPT_FLAG(L"-v", L"-verbose", &mVerbose, L"verbose")
+SWTABLE_OPT_FLAG(NULL, L"-version", &mVersion, L"version")
+SWTABLE_OPT_DEC(L"-c", L"-count", &mCount, L"[n]count")
+SWTABLE_END
+
+STATIC SHELL_STATUS Parse(CONST CHAR8 *Line, UINT16 FuncOpt)
+{
+    SetArgs(Line);
+    mVerbose = mVersion = FALSE;
+    mCount = 0;
+    return ParseCmdLine(NULL, 0, mSwTable, NULL, FuncOpt, NULL);
+}
+
+int main(void)
+{
+    // unique prefixes, any case
+    CHECK(Parse("p -verb -cou 5", SW_PREFIX) == SHELL_SUCCESS);
+    CHECK(mVerbose && !mVersion && (mCount == 5));
+    CHECK(Parse("p -VERSI", SW_PREFIX) == SHELL_SUCCESS);
+    CHECK(mVersion && !mVerbose);
+
+    // a full name wins over longer names it is a prefix of
+    CHECK(Parse("p -v", SW_PREFIX) == SHELL_SUCCESS);
+    CHECK(mVerbose && !mVersion);
+    // and a longer prefix resolves past it
+    CHECK(Parse("p -co 3", SW_PREFIX) == SHELL_SUCCESS);
+    CHECK(mCount == 3);
+
+    // ambiguous prefixes list the candidates
+    CHECK(Parse("p -ver", SW_PREFIX) == SHELL_INVALID_PARAMETER);
+    CHECK(Output("Ambiguous switch"));
+    CHECK(Output("-verbose") && Output("-version"));
+    CHECK(Parse("p -", SW_PREFIX) == SHELL_INVALID_PARAMETER);
+
+    // prefixes of built-in switches
+    CHECK(Parse("p -he", SW_PREFIX) == SHELL_ABORTED);
+
+    // a switch given twice is still an error when abbreviated
+    CHECK(Parse("p -verbose -verb", SW_PREFIX) == SHELL_INVALID_PARAMETER);
+    CHECK(!Output("Ambiguous"));
+
+    // prefixes are only accepted with SW_PREFIX
+    CHECK(Parse("p -verb", NO_OPT) == SHELL_INVALID_PARAMETER);
+
+    return TestSummary("PrefixTest");
+}
@@ -0,0 +1,138 @@
+/***********************************************************************
+
+ RangeTest.c
+
+ Host tests of the range list and bitmap value parsers
+
+***********************************************************************/
+
+#include "../CmdLine.c"
+#include "TestCommon.h"
+
+STATIC ARENA                mArena = { NULL, NULL };
+STATIC CMDLINE_RANGE_LIST   mList;
+
+// parses a range string and checks the status and, when VAL_OK, the number of merged ranges
+STATIC BOOLEAN Ranges(CONST CHAR16 *String, VALUE_STATUS Status, UINTN Count)
+{
+    ZeroMem(&mList, sizeof(mList));
+    if (ReturnRangeValue(&mArena, String, FALSE, &mList) != Status) {
+        return FALSE;
+    }
+    return (Status != VAL_OK) || (mList.Count == Count);
+}
+
+STATIC BOOLEAN RangeIs(UINTN Index, UINT64 First, UINT64 Last)
+{
+    return (mList.Ranges[Index].First == First) && (mList.Ranges[Index].Last == Last);
+}
+
+STATIC VOID TestRangeItems(VOID)
+{
+    CHECK(Ranges(L"5", VAL_OK, 1) && RangeIs(0, 5, 5));
+    CHECK(Ranges(L"5-9", VAL_OK, 1) && RangeIs(0, 5, 9));
+    CHECK(Ranges(L"5:9", VAL_OK, 1) && RangeIs(0, 5, 8));
+    CHECK(Ranges(L"5+9", VAL_OK, 1) && RangeIs(0, 5, 13));
+    CHECK(Ranges(L"0x1000:0x2000", VAL_OK, 1) && RangeIs(0, 0x1000, 0x1FFF));
+    CHECK(Ranges(L"0X10+0x10", VAL_OK, 1) && RangeIs(0, 0x10, 0x1F));
+    CHECK(Ranges(L"5-5", VAL_OK, 1) && RangeIs(0, 5, 5));
+
+    CHECK(Ranges(L"", VAL_RANGE_INVALID, 0));
+    CHECK(Ranges(L"9-5", VAL_RANGE_INVALID, 0));
+    CHECK(Ranges(L"5:5", VAL_RANGE_INVALID, 0));
+    CHECK(Ranges(L"5+0", VAL_RANGE_INVALID, 0));
+    CHECK(Ranges(L"5-", VAL_RANGE_INVALID, 0));
+    CHECK(Ranges(L"-5", VAL_RANGE_INVALID, 0));
+    CHECK(Ranges(L"1,", VAL_RANGE_INVALID, 0));
+    CHECK(Ranges(L"1,,2", VAL_RANGE_INVALID, 0));
+    CHECK(Ranges(L"1 2", VAL_RANGE_INVALID, 0));
+    CHECK(Ranges(L"0x", VAL_RANGE_INVALID, 0));
+    CHECK(Ranges(L"1-2-3", VAL_RANGE_INVALID, 0));
+}
+
+STATIC VOID TestRangeBounds(VOID)
+{
+    CHECK(Ranges(L"0xFFFFFFFFFFFFFFFF", VAL_OK, 1) && RangeIs(0, MAX_UINT64, MAX_UINT64));
+    CHECK(Ranges(L"0xFFFFFFFFFFFFFFFF+1", VAL_OK, 1) && RangeIs(0, MAX_UINT64, MAX_UINT64));
+    CHECK(Ranges(L"0xFFFFFFFFFFFFFFFF+2", VAL_RANGE_OUT_OF_BOUNDS, 0));
+    CHECK(Ranges(L"0+0xFFFFFFFFFFFFFFFF", VAL_OK, 1) && RangeIs(0, 0, MAX_UINT64 - 1));
+    CHECK(Ranges(L"18446744073709551615", VAL_OK, 1) && RangeIs(0, MAX_UINT64, MAX_UINT64));
+    CHECK(Ranges(L"18446744073709551616", VAL_UINT64_TOO_BIG, 0));
+    CHECK(Ranges(L"0x10000000000000000", VAL_UINT64_TOO_BIG, 0));
+    CHECK(Ranges(L"0:0xFFFFFFFFFFFFFFFF", VAL_OK, 1) && RangeIs(0, 0, MAX_UINT64 - 1));
+}
+
+STATIC VOID TestRangeMerge(VOID)
+{
+    // sorted, with overlapping and adjacent ranges merged
+    CHECK(Ranges(L"0x8000+0x100,0x1000:0x2000,0x2000-0x2FFF,5,0x7000:0x8000", VAL_OK, 3));
+    CHECK(RangeIs(0, 5, 5) && RangeIs(1, 0x1000, 0x2FFF) && RangeIs(2, 0x7000, 0x80FF));
+    CHECK(Ranges(L"1,2,3,4", VAL_OK, 1) && RangeIs(0, 1, 4));
+    CHECK(Ranges(L"4,3,2,1", VAL_OK, 1) && RangeIs(0, 1, 4));
+    CHECK(Ranges(L"1,3,5", VAL_OK, 3) && RangeIs(0, 1, 1) && RangeIs(1, 3, 3) && RangeIs(2, 5, 5));
+    CHECK(Ranges(L"10-20,12-15", VAL_OK, 1) && RangeIs(0, 10, 20));
+    CHECK(Ranges(L"10-20,5-30,1", VAL_OK, 2) && RangeIs(0, 1, 1) && RangeIs(1, 5, 30));
+    CHECK(Ranges(L"7,7,7", VAL_OK, 1) && RangeIs(0, 7, 7));
+
+    // merging up to the top of the range must not wrap
+    CHECK(Ranges(L"0xFFFFFFFFFFFFFFFF,0-0xFFFFFFFFFFFFFFFE", VAL_OK, 1) && RangeIs(0, 0, MAX_UINT64));
+    CHECK(Ranges(L"0xFFFFFFFFFFFFFFF0-0xFFFFFFFFFFFFFFFF,0xFFFFFFFFFFFFFFFF", VAL_OK, 1));
+    CHECK(RangeIs(0, 0xFFFFFFFFFFFFFFF0ULL, MAX_UINT64));
+    CHECK(Ranges(L"0xFFFFFFFFFFFFFFFF,1", VAL_OK, 2) && RangeIs(0, 1, 1) && RangeIs(1, MAX_UINT64, MAX_UINT64));
+
+    // grows past the first allocation
+    CHAR16 Long[400];
+    CHAR8 Item[16];
+    Long[0] = L'\0';
+    for (UINTN i = 0; i < 40; i++) {
+        snprintf(Item, sizeof(Item), i ? ",%u" : "%u", (unsigned)(i * 3));
+        Widen(&Long[StrLen(Long)], Item);
+    }
+    CHECK(Ranges(Long, VAL_OK, 40) && RangeIs(39, 117, 117));
+}
+
+STATIC VOID TestBitmap(VOID)
+{
+    UINTN Bitmap[CMDLINE_BITMAP_WORDS(200)];
+    UINTN Count = 0;
+
+    CHECK(ReturnBitmapValue(L"1,3,5-9,64+70,199", FALSE, 200, Bitmap) == VAL_OK);
+    for (UINTN i = 0; i < 200; i++) {
+        Count += BITSET_TEST(Bitmap, i) ? 1 : 0;
+    }
+    CHECK(Count == 1 + 1 + 5 + 70 + 1);
+    CHECK(BITSET_TEST(Bitmap, 64) && BITSET_TEST(Bitmap, 133) && !BITSET_TEST(Bitmap, 134));
+    CHECK(!BITSET_TEST(Bitmap, 0) && !BITSET_TEST(Bitmap, 198));
+
+    CHECK(ReturnBitmapValue(L"0-199", FALSE, 200, Bitmap) == VAL_OK);
+    CHECK(BITSET_TEST(Bitmap, 0) && BITSET_TEST(Bitmap, 199));
+    CHECK(ReturnBitmapValue(L"200", FALSE, 200, Bitmap) == VAL_RANGE_OUT_OF_BOUNDS);
+    CHECK(ReturnBitmapValue(L"0:201", FALSE, 200, Bitmap) == VAL_RANGE_OUT_OF_BOUNDS);
+    CHECK(ReturnBitmapValue(L"5-3", FALSE, 200, Bitmap) == VAL_RANGE_INVALID);
+    CHECK(ReturnBitmapValue(L"1,999", FALSE, 200, Bitmap) == VAL_RANGE_OUT_OF_BOUNDS);
+    CHECK(ReturnBitmapValue(L"1,x", FALSE, 200, Bitmap) != VAL_OK);
+
+    // a failed value leaves the bitmap as it was
+    Count = 0;
+    for (UINTN i = 0; i < 200; i++) {
+        Count += BITSET_TEST(Bitmap, i) ? 1 : 0;
+    }
+    CHECK(Count == 200);
+
+    // too large for the stack, built in an allocated buffer
+    UINTN Large[CMDLINE_BITMAP_WORDS(2000)];
+    CHECK(ReturnBitmapValue(L"3,1999", FALSE, 2000, Large) == VAL_OK);
+    CHECK(BITSET_TEST(Large, 3) && BITSET_TEST(Large, 1999) && !BITSET_TEST(Large, 1000));
+    CHECK(ReturnBitmapValue(L"1000,2000", FALSE, 2000, Large) == VAL_RANGE_OUT_OF_BOUNDS);
+    CHECK(BITSET_TEST(Large, 3) && !BITSET_TEST(Large, 1000));
+}
+
+int main(void)
+{
+    TestRangeItems();
+    TestRangeBounds();
+    TestRangeMerge();
+    TestBitmap();
+    ArenaFree(&mArena);
+    return TestSummary("RangeTest");
+}
@@ -0,0 +1,358 @@
+/***********************************************************************
+
+ HostStub.c
+
+ Host implementations of the EDK2 library functions used by CmdLine.c,
+ so that it can be built and tested without the EDK2 build
+
+***********************************************************************/
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UefiLib.h>
+#include <Library/ShellLib.h>
+#include <Library/TimerLib.h>
+#include "Protocol/EfiShellInterface.h"
+#include "HostStub.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+EFI_SHELL_PARAMETERS_PROTOCOL   *gEfiShellParametersProtocol = NULL;
+EFI_SHELL_INTERFACE             *mEfiShellInterface = NULL;
+EFI_SYSTEM_TABLE                *gST = NULL;
+EFI_BOOT_SERVICES               *gBS = NULL;
+EFI_HANDLE                      gImageHandle = NULL;
+
+CHAR8   gStubOutput[STUB_OUTPUT_SIZE];
+UINTN   gStubOutputLen = 0;
+INTN    gStubAllocations = 0;
+BOOLEAN gStubPageBreak = FALSE;
+EFI_HANDLE gStubParentHandle = NULL;
+
+//---------------------------
+// BaseLib
+//---------------------------
+
+UINTN StrLen(CONST CHAR16 *String)
+{
+    UINTN Len = 0;
+    while (String[Len]) {
+        Len++;
+    }
+    return Len;
+}
+
+UINTN AsciiStrLen(CONST CHAR8 *String)
+{
+    return strlen(String);
+}
+
+CHAR16 CharToUpper(CHAR16 Char)
+{
+    return ((Char >= L'a') && (Char <= L'z')) ? (CHAR16)(Char - (L'a' - L'A')) : Char;
+}
+
+INTN StrCmp(CONST CHAR16 *FirstString, CONST CHAR16 *SecondString)
+{
+    while (*FirstString && (*FirstString == *SecondString)) {
+        FirstString++;
+        SecondString++;
+    }
+    return *FirstString - *SecondString;
+}
+
+RETURN_STATUS StrnCpyS(CHAR16 *Destination, UINTN DestMax, CONST CHAR16 *Source, UINTN Length)
+{
+    UINTN i;
+    for (i = 0; (i < Length) && Source[i] && (i < DestMax - 1); i++) {
+        Destination[i] = Source[i];
+    }
+    Destination[i] = L'\0';
+    return RETURN_SUCCESS;
+}
+
+RETURN_STATUS StrCpyS(CHAR16 *Destination, UINTN DestMax, CONST CHAR16 *Source)
+{
+    return StrnCpyS(Destination, DestMax, Source, StrLen(Source));
+}
+
+RETURN_STATUS StrnCatS(CHAR16 *Destination, UINTN DestMax, CONST CHAR16 *Source, UINTN Length)
+{
+    UINTN Len = StrLen(Destination);
+    return StrnCpyS(Destination + Len, DestMax - Len, Source, Length);
+}
+
+RETURN_STATUS StrCatS(CHAR16 *Destination, UINTN DestMax, CONST CHAR16 *Source)
+{
+    return StrnCatS(Destination, DestMax, Source, StrLen(Source));
+}
+
+UINT64 ReadUnaligned64(CONST UINT64 *Buffer)
+{
+    UINT64 Value;
+    memcpy(&Value, Buffer, sizeof(Value));
+    return Value;
+}
+
+UINT32 WriteUnaligned32(UINT32 *Buffer, UINT32 Value)
+{
+    memcpy(Buffer, &Value, sizeof(Value));
+    return Value;
+}
+
+INTN LowBitSet64(UINT64 Operand)
+{
+    return Operand ? __builtin_ctzll(Operand) : -1;
+}
+
+UINT64 LShiftU64(UINT64 Operand, UINTN Count)
+{
+    return Operand << Count;
+}
+
+UINT64 RShiftU64(UINT64 Operand, UINTN Count)
+{
+    return Operand >> Count;
+}
+
+UINT64 MultU64x32(UINT64 Multiplicand, UINT32 Multiplier)
+{
+    return Multiplicand * Multiplier;
+}
+
+UINT64 MultU64x64(UINT64 Multiplicand, UINT64 Multiplier)
+{
+    return Multiplicand * Multiplier;
+}
+
+UINT64 DivU64x32Remainder(UINT64 Dividend, UINT32 Divisor, UINT32 *Remainder)
+{
+    if (Remainder) {
+        *Remainder = (UINT32)(Dividend % Divisor);
+    }
+    return Dividend / Divisor;
+}
+
+UINT64 DivU64x64Remainder(UINT64 Dividend, UINT64 Divisor, UINT64 *Remainder)
+{
+    if (Remainder) {
+        *Remainder = Dividend % Divisor;
+    }
+    return Dividend / Divisor;
+}
+
+STATIC BASE_SORT_COMPARE mSortCompare;
+
+STATIC int SortCompare(CONST VOID *Buffer1, CONST VOID *Buffer2)
+{
+    INTN Result = mSortCompare(Buffer1, Buffer2);
+    return (Result < 0) ? -1 : (Result > 0);
+}
+
+VOID QuickSort(VOID *BufferToSort, UINTN Count, UINTN ElementSize, BASE_SORT_COMPARE CompareFunction, VOID *BufferOneElement)
+{
+    (VOID)BufferOneElement;
+    mSortCompare = CompareFunction;
+    qsort(BufferToSort, Count, ElementSize, SortCompare);
+}
+
+//---------------------------
+// BaseMemoryLib
+//---------------------------
+
+VOID *CopyMem(VOID *Destination, CONST VOID *Source, UINTN Length)
+{
+    return memmove(Destination, Source, Length);
+}
+
+VOID *ZeroMem(VOID *Buffer, UINTN Length)
+{
+    return memset(Buffer, 0, Length);
+}
+
+//---------------------------
+// MemoryAllocationLib
+//---------------------------
+
+VOID *AllocatePool(UINTN AllocationSize)
+{
+    gStubAllocations++;
+    return malloc(AllocationSize ? AllocationSize : 1);
+}
+
+VOID *AllocateZeroPool(UINTN AllocationSize)
+{
+    gStubAllocations++;
+    return calloc(1, AllocationSize ? AllocationSize : 1);
+}
+
+VOID FreePool(VOID *Buffer)
+{
+    if (Buffer) {
+        gStubAllocations--;
+    }
+    free(Buffer);
+}
+
+//---------------------------
+// TimerLib
+//---------------------------
+
+UINT64 GetPerformanceCounter(VOID)
+{
+    struct timespec Now;
+    clock_gettime(CLOCK_MONOTONIC, &Now);
+    return (UINT64)Now.tv_sec * 1000000000ULL + (UINT64)Now.tv_nsec;
+}
+
+UINT64 GetPerformanceCounterProperties(UINT64 *StartValue, UINT64 *EndValue)
+{
+    if (StartValue) {
+        *StartValue = 0;
+    }
+    if (EndValue) {
+        *EndValue = MAX_UINT64;
+    }
+    return 1000000000ULL;
+}
+
+UINT64 GetTimeInNanoSecond(UINT64 Ticks)
+{
+    return Ticks;
+}
+
+//---------------------------
+// Output
+//---------------------------
+
+STATIC VOID OutputChar(CHAR8 Char)
+{
+    if (gStubOutputLen < STUB_OUTPUT_SIZE - 1) {
+        gStubOutput[gStubOutputLen++] = Char;
+        gStubOutput[gStubOutputLen] = '\0';
+    }
+}
+
+STATIC VOID OutputAscii(CONST CHAR8 *String)
+{
+    while (*String) {
+        OutputChar(*String++);
+    }
+}
+
+// formats the subset of the PrintLib format used by CmdLine.c, widths are ignored
+STATIC VOID OutputFormat(CONST CHAR16 *Format, va_list Args)
+{
+    CHAR8 Number[32];
+
+    for (; *Format; Format++) {
+        if (*Format != L'%') {
+            OutputChar((CHAR8)*Format);
+            continue;
+        }
+        Format++;
+        while ((*Format == L'-') || ((*Format >= L'0') && (*Format <= L'9'))) {
+            Format++;
+        }
+        BOOLEAN Long = (*Format == L'l');
+        if (Long) {
+            Format++;
+        }
+        switch (*Format) {
+        case L'H': case L'N': case L'E': case L'B': case L'V':
+            break;
+        case L's': {
+            CONST CHAR16 *String = va_arg(Args, CONST CHAR16 *);
+            if (!String) {
+                OutputAscii("<null>");
+                break;
+            }
+            while (*String) {
+                OutputChar((CHAR8)*String++);
+            }
+            break;
+        }
+        case L'a':
+            OutputAscii(va_arg(Args, CONST CHAR8 *));
+            break;
+        case L'c':
+            OutputChar((CHAR8)va_arg(Args, int));
+            break;
+        case L'u':
+        case L'd':
+        case L'x':
+        case L'X':
+            if (Long) {
+                UINT64 Value = va_arg(Args, UINT64);
+                snprintf(Number, sizeof(Number), (*Format == L'u') ? "%llu" : (*Format == L'd') ? "%lld" : "%llx", (unsigned long long)Value);
+            } else {
+                UINT32 Value = va_arg(Args, UINT32);
+                snprintf(Number, sizeof(Number), (*Format == L'u') ? "%u" : (*Format == L'd') ? "%d" : "%x", Value);
+            }
+            OutputAscii(Number);
+            break;
+        case L'r':
+            snprintf(Number, sizeof(Number), "status %llx", (unsigned long long)va_arg(Args, UINTN));
+            OutputAscii(Number);
+            break;
+        case L'%':
+            OutputChar('%');
+            break;
+        default:
+            OutputChar('?');
+            break;
+        }
+    }
+}
+
+UINTN Print(CONST CHAR16 *Format, ...)
+{
+    va_list Args;
+    va_start(Args, Format);
+    OutputFormat(Format, Args);
+    va_end(Args);
+    return 0;
+}
+
+EFI_STATUS ShellPrintEx(INT32 Col, INT32 Row, CONST CHAR16 *Format, ...)
+{
+    va_list Args;
+    (VOID)Col;
+    (VOID)Row;
+    va_start(Args, Format);
+    OutputFormat(Format, Args);
+    va_end(Args);
+    return EFI_SUCCESS;
+}
+
+VOID ShellSetPageBreakMode(BOOLEAN CurrentState)
+{
+    gStubPageBreak = CurrentState;
+}
+
+EFI_STATUS ShellExecute(EFI_HANDLE *ParentHandle, CHAR16 *CommandLine, BOOLEAN Output, CHAR16 **EnvironmentVariables, EFI_STATUS *Status)
+{
+    gStubParentHandle = ParentHandle ? *ParentHandle : NULL;
+    (VOID)Output;
+    (VOID)EnvironmentVariables;
+    OutputChar('[');
+    while (*CommandLine) {
+        OutputChar((CHAR8)*CommandLine++);
+    }
+    OutputChar(']');
+    if (Status) {
+        *Status = EFI_SUCCESS;
+    }
+    return EFI_SUCCESS;
+}
+
+VOID StubClearOutput(VOID)
+{
+    gStubOutputLen = 0;
+    gStubOutput[0] = '\0';
+}
@@ -0,0 +1,15 @@
+// Host stub state shared with the tests
+#ifndef STUB_HOST_STUB_H
+#define STUB_HOST_STUB_H
+
+#define STUB_OUTPUT_SIZE    65536
+
+extern CHAR8      gStubOutput[STUB_OUTPUT_SIZE];    // everything printed via Print/ShellPrintEx
+extern UINTN      gStubOutputLen;
+extern INTN       gStubAllocations;                 // pool allocations not yet freed
+extern BOOLEAN    gStubPageBreak;
+extern EFI_HANDLE gStubParentHandle;                // parent image handle of the last ShellExecute
+
+VOID StubClearOutput(VOID);
+
+#endif // STUB_HOST_STUB_H
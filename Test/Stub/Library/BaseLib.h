@@ -0,0 +1,26 @@
+// Host stub of the BaseLib functions used by CmdLine.c
+#ifndef STUB_BASE_LIB_H
+#define STUB_BASE_LIB_H
+
+UINTN StrLen(CONST CHAR16 *String);
+UINTN AsciiStrLen(CONST CHAR8 *String);
+CHAR16 CharToUpper(CHAR16 Char);
+INTN StrCmp(CONST CHAR16 *FirstString, CONST CHAR16 *SecondString);
+RETURN_STATUS StrCpyS(CHAR16 *Destination, UINTN DestMax, CONST CHAR16 *Source);
+RETURN_STATUS StrnCpyS(CHAR16 *Destination, UINTN DestMax, CONST CHAR16 *Source, UINTN Length);
+RETURN_STATUS StrCatS(CHAR16 *Destination, UINTN DestMax, CONST CHAR16 *Source);
+RETURN_STATUS StrnCatS(CHAR16 *Destination, UINTN DestMax, CONST CHAR16 *Source, UINTN Length);
+UINT64 ReadUnaligned64(CONST UINT64 *Buffer);
+UINT32 WriteUnaligned32(UINT32 *Buffer, UINT32 Value);
+INTN LowBitSet64(UINT64 Operand);
+UINT64 LShiftU64(UINT64 Operand, UINTN Count);
+UINT64 RShiftU64(UINT64 Operand, UINTN Count);
+UINT64 MultU64x32(UINT64 Multiplicand, UINT32 Multiplier);
+UINT64 MultU64x64(UINT64 Multiplicand, UINT64 Multiplier);
+UINT64 DivU64x32Remainder(UINT64 Dividend, UINT32 Divisor, UINT32 *Remainder);
+UINT64 DivU64x64Remainder(UINT64 Dividend, UINT64 Divisor, UINT64 *Remainder);
+
+typedef INTN (EFIAPI *BASE_SORT_COMPARE)(CONST VOID *Buffer1, CONST VOID *Buffer2);
+VOID QuickSort(VOID *BufferToSort, UINTN Count, UINTN ElementSize, BASE_SORT_COMPARE CompareFunction, VOID *BufferOneElement);
+
+#endif // STUB_BASE_LIB_H
@@ -0,0 +1,8 @@
+// Host stub of the BaseMemoryLib functions used by CmdLine.c
+#ifndef STUB_BASE_MEMORY_LIB_H
+#define STUB_BASE_MEMORY_LIB_H
+
+VOID *CopyMem(VOID *Destination, CONST VOID *Source, UINTN Length);
+VOID *ZeroMem(VOID *Buffer, UINTN Length);
+
+#endif // STUB_BASE_MEMORY_LIB_H
@@ -0,0 +1,8 @@
+// Host stub of DebugLib
+#ifndef STUB_DEBUG_LIB_H
+#define STUB_DEBUG_LIB_H
+
+#define ASSERT(Expression)  do { if (!(Expression)) __builtin_trap(); } while (0)
+#define DEBUG(Expression)
+
+#endif // STUB_DEBUG_LIB_H
@@ -0,0 +1,9 @@
+// Host stub of the MemoryAllocationLib functions used by CmdLine.c; allocations are counted
+#ifndef STUB_MEMORY_ALLOCATION_LIB_H
+#define STUB_MEMORY_ALLOCATION_LIB_H
+
+VOID *AllocatePool(UINTN AllocationSize);
+VOID *AllocateZeroPool(UINTN AllocationSize);
+VOID FreePool(VOID *Buffer);
+
+#endif // STUB_MEMORY_ALLOCATION_LIB_H
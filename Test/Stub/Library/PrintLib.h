@@ -0,0 +1 @@
+// Host stub of PrintLib, not used by CmdLine.c
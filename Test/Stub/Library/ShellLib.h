@@ -0,0 +1,27 @@
+// Host stub of the ShellLib functions and shell protocols used by CmdLine.c
+#ifndef STUB_SHELL_LIB_H
+#define STUB_SHELL_LIB_H
+
+typedef UINTN SHELL_STATUS;
+#define SHELL_SUCCESS               0
+#define SHELL_INVALID_PARAMETER     2
+#define SHELL_UNSUPPORTED           3
+#define SHELL_BUFFER_TOO_SMALL      5
+#define SHELL_OUT_OF_RESOURCES      9
+#define SHELL_NOT_FOUND             14
+#define SHELL_ABORTED               21
+
+typedef struct {
+    CHAR16  **Argv;
+    UINTN   Argc;
+} EFI_SHELL_PARAMETERS_PROTOCOL;
+
+extern EFI_SHELL_PARAMETERS_PROTOCOL *gEfiShellParametersProtocol;
+
+// output is collected in gStubOutput, with the colour attributes (%H, %N etc) dropped
+EFI_STATUS ShellPrintEx(INT32 Col, INT32 Row, CONST CHAR16 *Format, ...);
+VOID ShellSetPageBreakMode(BOOLEAN CurrentState);
+// the command line is appended to gStubOutput in brackets rather than run
+EFI_STATUS ShellExecute(EFI_HANDLE *ParentHandle, CHAR16 *CommandLine, BOOLEAN Output, CHAR16 **EnvironmentVariables, EFI_STATUS *Status);
+
+#endif // STUB_SHELL_LIB_H
@@ -0,0 +1,9 @@
+// Host stub of TimerLib, the performance counter counts nanoseconds
+#ifndef STUB_TIMER_LIB_H
+#define STUB_TIMER_LIB_H
+
+UINT64 GetPerformanceCounter(VOID);
+UINT64 GetPerformanceCounterProperties(UINT64 *StartValue, UINT64 *EndValue);
+UINT64 GetTimeInNanoSecond(UINT64 Ticks);
+
+#endif // STUB_TIMER_LIB_H
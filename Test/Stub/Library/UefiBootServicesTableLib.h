@@ -0,0 +1 @@
+// Host stub of UefiBootServicesTableLib, gST, gBS and gImageHandle are declared in Uefi.h
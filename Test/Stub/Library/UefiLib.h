@@ -0,0 +1,7 @@
+// Host stub of the UefiLib functions used by CmdLine.c
+#ifndef STUB_UEFI_LIB_H
+#define STUB_UEFI_LIB_H
+
+UINTN Print(CONST CHAR16 *Format, ...);
+
+#endif // STUB_UEFI_LIB_H
@@ -0,0 +1,10 @@
+// Host stub of the EFI 1.1 shell interface
+#ifndef STUB_EFI_SHELL_INTERFACE_H
+#define STUB_EFI_SHELL_INTERFACE_H
+
+typedef struct {
+    CHAR16  **Argv;
+    UINTN   Argc;
+} EFI_SHELL_INTERFACE;
+
+#endif // STUB_EFI_SHELL_INTERFACE_H
@@ -0,0 +1,111 @@
+/***********************************************************************
+
+ Uefi.h
+
+ Host stub of the EDK2 base types, just enough to build CmdLine.c into
+ the host tests
+
+***********************************************************************/
+
+#ifndef STUB_UEFI_H
+#define STUB_UEFI_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef uint64_t    UINT64;
+typedef int64_t     INT64;
+typedef uint32_t    UINT32;
+typedef int32_t     INT32;
+typedef uint16_t    UINT16;
+typedef int16_t     INT16;
+typedef uint8_t     UINT8;
+typedef int8_t      INT8;
+typedef uintptr_t   UINTN;
+typedef intptr_t    INTN;
+typedef uint8_t     BOOLEAN;
+typedef uint16_t    CHAR16;     // L"" strings need -fshort-wchar
+typedef char        CHAR8;
+typedef void        VOID;
+typedef UINTN       EFI_STATUS;
+typedef UINTN       RETURN_STATUS;
+typedef VOID        *EFI_HANDLE;
+typedef VOID        *EFI_EVENT;
+
+#define IN
+#define OUT
+#define OPTIONAL
+#define CONST       const
+#define STATIC      static
+#define EFIAPI
+#define TRUE        ((BOOLEAN)1)
+#define FALSE       ((BOOLEAN)0)
+
+#define MAX_UINT8   ((UINT8)0xFF)
+#define MAX_UINT16  ((UINT16)0xFFFF)
+#define MAX_UINT32  ((UINT32)0xFFFFFFFF)
+#define MAX_UINT64  ((UINT64)0xFFFFFFFFFFFFFFFFULL)
+#define MAX_INT8    ((INT8)0x7F)
+#define MAX_INT16   ((INT16)0x7FFF)
+#define MAX_INT32   ((INT32)0x7FFFFFFF)
+#define MAX_INT64   ((INT64)0x7FFFFFFFFFFFFFFFLL)
+#define MAX_UINTN   ((UINTN)-1)
+#define MAX_INTN    ((INTN)(MAX_UINTN >> 1))
+#define MIN_INTN    (((INTN)-MAX_INTN) - 1)
+
+#define MIN(a, b)   (((a) < (b)) ? (a) : (b))
+#define MAX(a, b)   (((a) > (b)) ? (a) : (b))
+#define OFFSET_OF(TYPE, Field)  ((UINTN)offsetof(TYPE, Field))
+
+#define ENCODE_ERROR(Code)      ((UINTN)1 << (sizeof(UINTN) * 8 - 1) | (Code))
+#define EFI_ERROR(Status)       (((INTN)(Status)) < 0)
+#define EFI_SUCCESS             0
+#define EFI_INVALID_PARAMETER   ENCODE_ERROR(2)
+#define EFI_UNSUPPORTED         ENCODE_ERROR(3)
+#define EFI_BAD_BUFFER_SIZE     ENCODE_ERROR(4)
+#define EFI_BUFFER_TOO_SMALL    ENCODE_ERROR(5)
+#define EFI_NOT_READY           ENCODE_ERROR(6)
+#define EFI_OUT_OF_RESOURCES    ENCODE_ERROR(9)
+#define EFI_NOT_FOUND           ENCODE_ERROR(14)
+#define EFI_ABORTED             ENCODE_ERROR(21)
+#define RETURN_SUCCESS          0
+
+#define SCAN_ESC    0x17
+
+typedef struct {
+    UINT16  ScanCode;
+    CHAR16  UnicodeChar;
+} EFI_INPUT_KEY;
+
+typedef struct _EFI_SIMPLE_TEXT_INPUT_PROTOCOL {
+    EFI_STATUS  (*ReadKeyStroke)(struct _EFI_SIMPLE_TEXT_INPUT_PROTOCOL *This, EFI_INPUT_KEY *Key);
+    EFI_EVENT   WaitForKey;
+} EFI_SIMPLE_TEXT_INPUT_PROTOCOL;
+
+typedef struct {
+    INT32   Mode;
+    INT32   CursorColumn;
+    INT32   CursorRow;
+} SIMPLE_TEXT_OUTPUT_MODE;
+
+typedef struct _EFI_SIMPLE_TEXT_OUTPUT_PROTOCOL {
+    EFI_STATUS  (*QueryMode)(struct _EFI_SIMPLE_TEXT_OUTPUT_PROTOCOL *This, UINTN ModeNumber, UINTN *Columns, UINTN *Rows);
+    EFI_STATUS  (*SetCursorPosition)(struct _EFI_SIMPLE_TEXT_OUTPUT_PROTOCOL *This, UINTN Column, UINTN Row);
+    SIMPLE_TEXT_OUTPUT_MODE *Mode;
+} EFI_SIMPLE_TEXT_OUTPUT_PROTOCOL;
+
+typedef struct {
+    EFI_STATUS  (*WaitForEvent)(UINTN NumberOfEvents, EFI_EVENT *Event, UINTN *Index);
+} EFI_BOOT_SERVICES;
+
+typedef struct {
+    EFI_SIMPLE_TEXT_INPUT_PROTOCOL  *ConIn;
+    EFI_SIMPLE_TEXT_OUTPUT_PROTOCOL *ConOut;
+    EFI_BOOT_SERVICES               *BootServices;
+} EFI_SYSTEM_TABLE;
+
+extern EFI_SYSTEM_TABLE     *gST;
+extern EFI_BOOT_SERVICES    *gBS;
+extern EFI_HANDLE           gImageHandle;
+
+#endif // STUB_UEFI_H
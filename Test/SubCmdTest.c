@@ -0,0 +1,108 @@
+/***********************************************************************
+
+ SubCmdTest.c
+
+ Host tests of subcommand dispatch
+
+***********************************************************************/
+
+#include "../CmdLine.c"
+#include "TestCommon.h"
+
+STATIC UINTN    mCount;
+STATIC BOOLEAN  mVerbose;
+STATIC CHAR16   mDevice[16];
+STATIC UINTN    mCalled;
+STATIC UINTN    mGotArgc;
+STATIC UINTN    mGotParams;
+
+STATIC PARAMTABLE_START(mReadParams)
+PARAMTABLE_STR(mDevice, 16, L"dev:device name")
+PARAMTABLE_END
+
+STATIC SWTABLE_START(mReadSwitches)
+SWTABLE_OPT_DEC(L"-n", L"-count", &mCount, L"count")
+SWTABLE_END
+
+STATIC SWTABLE_START(mListSwitches)
+SWTABLE_OPT_FLAG(L"-v", NULL, &mVerbose, L"verbose")
+SWTABLE_END
+
+STATIC SHELL_STATUS EFIAPI DoRead(CMDLINE_PARSER *Parser, UINTN Argc, CHAR16 **Argv, UINTN NumParams)
+{
+    mCalled = 1;
+    mGotArgc = Argc;
+    mGotParams = NumParams;
+    CHECK(StrCmp(Argv[0], L"read") == 0);
+    return SHELL_SUCCESS;
+}
+
+STATIC SHELL_STATUS EFIAPI DoList(CMDLINE_PARSER *Parser, UINTN Argc, CHAR16 **Argv, UINTN NumParams)
+{
+    mCalled = 2;
+    return SHELL_NOT_FOUND;
+}
+
+STATIC SUBCMDTABLE_START(mCommands)
+SUBCMDTABLE_ENTRY(L"read", mReadParams, 1, mReadSwitches, DoRead, L"read from a device")
+SUBCMDTABLE_ENTRY(L"list", NULL, 0, mListSwitches, DoList, L"list devices")
+SUBCMDTABLE_END
+
+STATIC SUBCMDTABLE_START(mDuplicates)
+SUBCMDTABLE_ENTRY(L"a", NULL, 0, NULL, DoList, L"x")
+SUBCMDTABLE_ENTRY(L"A", NULL, 0, NULL, DoList, L"y")
+SUBCMDTABLE_END
+
+STATIC SHELL_STATUS Dispatch(CONST CHAR8 *Line)
+{
+    SetArgs(Line);
+    mCalled = 0;
+    mCount = 0;
+    mVerbose = FALSE;
+    gStubPageBreak = FALSE;
+    return DispatchCmdLine(mCommands, L"Device tool", NO_OPT);
+}
+
+int main(void)
+{
+    CMDLINE_SUBCMDS *SubCmds;
+
+    CHECK(Dispatch("tool read disk0 -n 5") == SHELL_SUCCESS);
+    CHECK((mCalled == 1) && (mGotArgc == 4) && (mGotParams == 1) && (mCount == 5));
+    CHECK(StrCmp(mDevice, L"disk0") == 0);
+    CHECK(Dispatch("tool LIST -v") == SHELL_NOT_FOUND);
+    CHECK((mCalled == 2) && mVerbose);
+
+    // errors are given as 'prog subcmd'
+    CHECK(Dispatch("tool read") == SHELL_INVALID_PARAMETER);
+    CHECK(!mCalled && Output("tool read"));
+    CHECK(Dispatch("tool bogus") == SHELL_INVALID_PARAMETER);
+    CHECK(Output("Unrecognised command"));
+    CHECK(Dispatch("tool") == SHELL_INVALID_PARAMETER);
+    CHECK(Output("Missing command"));
+
+    // help before and after the subcommand
+    CHECK(Dispatch("tool -h") == SHELL_ABORTED);
+    CHECK(Output("Commands:") && Output("list devices"));
+    CHECK(Dispatch("tool read -HELP") == SHELL_ABORTED);
+    CHECK(!mCalled && Output("tool read") && !Output("Commands:"));
+
+    // break before the subcommand is passed on to it
+    CHECK(Dispatch("tool -b read disk0") == SHELL_SUCCESS);
+    CHECK((mCalled == 1) && (mGotArgc == 3) && (mGotParams == 1) && gStubPageBreak);
+    CHECK(Dispatch("tool read disk0 -b") == SHELL_SUCCESS);
+    CHECK((mCalled == 1) && gStubPageBreak);
+    CHECK(Dispatch("tool read disk0") == SHELL_SUCCESS);
+    CHECK(!gStubPageBreak);
+    CHECK(Dispatch("tool -break -h") == SHELL_ABORTED);
+    CHECK(Output("Commands:"));
+    CHECK(Dispatch("tool -b") == SHELL_INVALID_PARAMETER);
+    CHECK(Output("Missing command"));
+    CHECK(Dispatch("tool -v list") == SHELL_INVALID_PARAMETER);
+    CHECK(!mCalled && Output("Unrecognised command"));
+
+    CHECK(CmdLineSubCmdCompile(mDuplicates, NULL, NO_OPT, &SubCmds) == SHELL_INVALID_PARAMETER);
+    CHECK(SubCmds == NULL);
+
+    return TestSummary("SubCmdTest");
+}
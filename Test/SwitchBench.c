@@ -0,0 +1,81 @@
+/***********************************************************************
+
+ SwitchBench.c
+
+ Times CmdLineParseArgv() on compiled parsers of 30, 300 and 3000
+ switches, with every third switch a flag with a presence flag and
+ the rest decimal switches; each parse enters 16 switches spread
+ over the table
+
+***********************************************************************/
+
+#include "../CmdLine.c"
+#include "TestCommon.h"
+#include <stdlib.h>
+
+#define BENCH_ARGS      16
+#define BENCH_PARSES    200000
+
+STATIC VOID BenchSwitches(UINTN Count)
+{
+    SWITCH_TABLE *SwTable = calloc(Count + 1, sizeof(SWITCH_TABLE));
+    CHAR16 (*Names)[8] = calloc(Count, sizeof(*Names));
+    UINTN *Values = calloc(Count, sizeof(UINTN));
+    BOOLEAN *Present = calloc(Count, sizeof(BOOLEAN));
+    CHAR16 *Argv[1 + BENCH_ARGS * 2];
+    UINTN Argc = 1;
+    CMDLINE_PARSER *Parser;
+    CHAR8 Name[8];
+
+    for (UINTN i = 0; i < Count; i++) {
+        snprintf(Name, sizeof(Name), "-s%u", (unsigned)i);
+        Widen(Names[i], Name);
+        SwTable[i].SwStr1 = Names[i];
+        SwTable[i].SwitchNecessity = OPT_SW;
+        SwTable[i].HelpStr = L"[n]switch";
+        if (i % 3 == 0) {
+            SwTable[i].ValueType = VALTYPE_NONE;
+            SwTable[i].PresentPtr = &Present[i];
+            SwTable[i].ValueRetPtr.pBoolean = &Present[i];
+        } else {
+            SwTable[i].ValueType = VALTYPE_DECIMAL;
+            SwTable[i].Data.ValSize = SIZEN;
+            SwTable[i].ValueRetPtr.pUintn = &Values[i];
+        }
+    }
+
+    Argv[0] = L"bench";
+    for (UINTN a = 0; a < BENCH_ARGS; a++) {
+        UINTN i = (a * Count) / BENCH_ARGS + 1;
+        Argv[Argc++] = Names[i];
+        if (SwTable[i].ValueType != VALTYPE_NONE) {
+            Argv[Argc++] = L"12345";
+        }
+    }
+
+    CHECK(CmdLineCompile(NULL, 0, SwTable, NULL, NO_OPT, &Parser) == SHELL_SUCCESS);
+    CHECK(CmdLineParseArgv(Parser, Argc, Argv, NULL) == SHELL_SUCCESS);
+    UINT64 Start = GetPerformanceCounter();
+    for (UINTN n = 0; n < BENCH_PARSES; n++) {
+        CmdLineParseArgv(Parser, Argc, Argv, NULL);
+    }
+    UINT64 Ns = GetTimeInNanoSecond(GetPerformanceCounter() - Start);
+    CmdLineFreeParser(Parser);
+
+    printf("  %4u switches: %8.1f ns per parse, %6.1f ns per switch entered\n", (unsigned)Count,
+        (double)Ns / BENCH_PARSES, (double)Ns / BENCH_PARSES / BENCH_ARGS);
+
+    free(Present);
+    free(Values);
+    free(Names);
+    free(SwTable);
+}
+
+int main(void)
+{
+    printf("SwitchBench: compiled parser, %u switches entered\n", BENCH_ARGS);
+    BenchSwitches(30);
+    BenchSwitches(300);
+    BenchSwitches(3000);
+    return TestSummary("SwitchBench");
+}
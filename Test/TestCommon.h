@@ -0,0 +1,95 @@
+/***********************************************************************
+
+ TestCommon.h
+
+ Helpers shared by the host tests
+
+***********************************************************************/
+
+#ifndef TEST_COMMON_H
+#define TEST_COMMON_H
+
+#include <Uefi.h>
+#include <Library/ShellLib.h>
+#include "HostStub.h"
+#include <stdio.h>
+#include <string.h>
+
+#define TEST_MAX_ARGS   64
+#define TEST_MAX_ARG    256
+
+STATIC UINTN                            mTestFailures;
+STATIC CHAR16                           mTestArgBuf[TEST_MAX_ARGS][TEST_MAX_ARG];
+STATIC CHAR16                           *mTestArgv[TEST_MAX_ARGS];
+STATIC EFI_SHELL_PARAMETERS_PROTOCOL    mTestParams;
+
+#define CHECK(Cond) \
+    do { \
+        if (!(Cond)) { \
+            printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #Cond); \
+            mTestFailures++; \
+        } \
+    } while (0)
+
+/**
+ * Function: Widen
+ *
+ * Copies an ASCII string into a CHAR16 buffer
+ **/
+STATIC inline CHAR16 *Widen(CHAR16 *Dest, CONST CHAR8 *Src)
+{
+    CHAR16 *Ret = Dest;
+    while ((*Dest++ = (UINT8)*Src++) != L'\0') {
+    }
+    return Ret;
+}
+
+/**
+ * Function: SetArgs
+ *
+ * Splits a space separated line into the shell parameters protocol
+ * Argv and clears the captured output
+ * Returns Argc
+ **/
+STATIC inline UINTN SetArgs(CONST CHAR8 *Line)
+{
+    CHAR8 Tmp[4096];
+    CHAR8 *Tok;
+    UINTN Argc = 0;
+
+    snprintf(Tmp, sizeof(Tmp), "%s", Line);
+    for (Tok = strtok(Tmp, " "); Tok != NULL; Tok = strtok(NULL, " ")) {
+        mTestArgv[Argc] = Widen(mTestArgBuf[Argc], Tok);
+        Argc++;
+    }
+    mTestParams.Argc = Argc;
+    mTestParams.Argv = mTestArgv;
+    gEfiShellParametersProtocol = &mTestParams;
+    StubClearOutput();
+    return Argc;
+}
+
+/**
+ * Function: Output
+ *
+ * Returns TRUE if the captured output contains Text
+ **/
+STATIC inline BOOLEAN Output(CONST CHAR8 *Text)
+{
+    return strstr(gStubOutput, Text) != NULL;
+}
+
+/**
+ * Function: TestSummary
+ *
+ * Reports the failures and leaked allocations
+ * Returns process exit code
+ **/
+STATIC inline int TestSummary(CONST CHAR8 *Name)
+{
+    CHECK(gStubAllocations == 0);
+    printf("%s: %s (%lu failures)\n", Name, mTestFailures ? "FAILED" : "passed", (unsigned long)mTestFailures);
+    return mTestFailures ? 1 : 0;
+}
+
+#endif // TEST_COMMON_H
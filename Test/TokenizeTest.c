@@ -0,0 +1,171 @@
+/***********************************************************************
+
+ TokenizeTest.c
+
+ Host tests of the in-place command line tokenizer and the string
+ parse entry points
+
+***********************************************************************/
+
+#include "../CmdLine.c"
+#include "TestCommon.h"
+#include <stdarg.h>
+
+#define MAX_ARGS    8
+
+STATIC CHAR16   mLine[TEST_MAX_ARG];
+STATIC CHAR16   *mArgv[MAX_ARGS];
+STATIC UINTN    mArgc;
+
+STATIC BOOLEAN  mVerbose;
+STATIC CHAR16   mName[16];
+
+SWTABLE_START(mSwTable)
+SWTABLE_OPT_FLAG(L"-v", L"-verbose", &mVerbose, L"verbose")
+SWTABLE_OPT_STR(L"-n", L"-name", mName, sizeof(mName) / sizeof(CHAR16), L"[str]name")
+SWTABLE_END
+
+// tokenizes Line, with MaxArgs entries of the vector available
+STATIC SHELL_STATUS Tokenize(CONST CHAR8 *Line, UINTN MaxArgs)
+{
+    Widen(mLine, Line);
+    ZeroMem(mArgv, sizeof(mArgv));
+    return CmdLineTokenize(mLine, mArgv, MaxArgs, &mArgc);
+}
+
+// checks the vector against a NULL terminated list of arguments
+STATIC BOOLEAN ArgsAre(CONST CHAR8 *First, ...)
+{
+    CHAR16 Expected[TEST_MAX_ARG];
+    va_list Args;
+    UINTN i = 0;
+
+    va_start(Args, First);
+    for (CONST CHAR8 *Arg = First; Arg; Arg = va_arg(Args, CONST CHAR8 *), i++) {
+        if ((i >= mArgc) || (StrCmp(mArgv[i], Widen(Expected, Arg)) != 0)) {
+            va_end(Args);
+            return FALSE;
+        }
+    }
+    va_end(Args);
+    return i == mArgc;
+}
+
+STATIC VOID TestSplit(VOID)
+{
+    CHECK(Tokenize("prog -v file", MAX_ARGS) == SHELL_SUCCESS);
+    CHECK(ArgsAre("prog", "-v", "file", NULL));
+
+    // runs of spaces and tabs, leading and trailing
+    CHECK(Tokenize("  \tprog\t\t-v   file \t", MAX_ARGS) == SHELL_SUCCESS);
+    CHECK(ArgsAre("prog", "-v", "file", NULL));
+
+    // arguments point into the line
+    CHECK((mArgv[0] >= mLine) && (mArgv[2] < mLine + TEST_MAX_ARG));
+
+    CHECK(Tokenize("", MAX_ARGS) == SHELL_SUCCESS);
+    CHECK(mArgc == 0);
+    CHECK(Tokenize(" \t ", MAX_ARGS) == SHELL_SUCCESS);
+    CHECK(mArgc == 0);
+}
+
+STATIC VOID TestQuotes(VOID)
+{
+    CHECK(Tokenize("prog \"a b\" c", MAX_ARGS) == SHELL_SUCCESS);
+    CHECK(ArgsAre("prog", "a b", "c", NULL));
+
+    // quotes may start or end part way through an argument, and are removed
+    CHECK(Tokenize("prog -n=\"x y\"z \"p\"q", MAX_ARGS) == SHELL_SUCCESS);
+    CHECK(ArgsAre("prog", "-n=x yz", "pq", NULL));
+
+    // empty quotes give an empty argument
+    CHECK(Tokenize("prog \"\" x \"\"", MAX_ARGS) == SHELL_SUCCESS);
+    CHECK(ArgsAre("prog", "", "x", "", NULL));
+
+    // tabs are kept inside quotes
+    CHECK(Tokenize("prog \"a\tb\"", MAX_ARGS) == SHELL_SUCCESS);
+    CHECK(ArgsAre("prog", "a\tb", NULL));
+
+    // a quote left open is an error
+    CHECK(Tokenize("prog \"a b", MAX_ARGS) == SHELL_INVALID_PARAMETER);
+    CHECK((mArgc == 2) && (StrCmp(mArgv[1], L"a b") == 0));
+}
+
+STATIC VOID TestEscapes(VOID)
+{
+    // ^ takes the next char as is
+    CHECK(Tokenize("prog ^\"a b^\"", MAX_ARGS) == SHELL_SUCCESS);
+    CHECK(ArgsAre("prog", "\"a", "b\"", NULL));
+    CHECK(Tokenize("prog a^ b", MAX_ARGS) == SHELL_SUCCESS);
+    CHECK(ArgsAre("prog", "a b", NULL));
+    CHECK(Tokenize("prog ^^ \"^\"\" ^x", MAX_ARGS) == SHELL_SUCCESS);
+    CHECK(ArgsAre("prog", "^", "\"", "x", NULL));
+
+    // a trailing ^ is kept
+    CHECK(Tokenize("prog a^", MAX_ARGS) == SHELL_SUCCESS);
+    CHECK(ArgsAre("prog", "a^", NULL));
+
+    // backslashes are not escapes
+    CHECK(Tokenize("prog fs0:\\efi\\a\\\"b c\"", MAX_ARGS) == SHELL_SUCCESS);
+    CHECK(ArgsAre("prog", "fs0:\\efi\\a\\b c", NULL));
+}
+
+STATIC VOID TestLimits(VOID)
+{
+    // exactly MaxArgs fits, one more fills the vector and fails
+    CHECK(Tokenize("a b c", 3) == SHELL_SUCCESS);
+    CHECK(ArgsAre("a", "b", "c", NULL));
+    CHECK(Tokenize("a b c d", 3) == SHELL_BUFFER_TOO_SMALL);
+    CHECK((mArgc == 3) && (mArgv[3] == NULL));
+    CHECK(Tokenize("a", 0) == SHELL_BUFFER_TOO_SMALL);
+    CHECK(Tokenize("", 0) == SHELL_SUCCESS);
+
+    CHECK(CmdLineTokenize(NULL, mArgv, MAX_ARGS, &mArgc) == SHELL_INVALID_PARAMETER);
+    CHECK(CmdLineTokenize(mLine, NULL, MAX_ARGS, &mArgc) == SHELL_INVALID_PARAMETER);
+    CHECK(CmdLineTokenize(mLine, mArgv, MAX_ARGS, NULL) == SHELL_INVALID_PARAMETER);
+}
+
+STATIC VOID TestParseString(VOID)
+{
+    CMDLINE_PARSER *Parser;
+
+    Widen(mLine, "fs0:\\tool.efi -v -name \"a b\"");
+    mVerbose = FALSE;
+    StubClearOutput();
+    CHECK(ParseCmdLineString(mLine, mArgv, MAX_ARGS, NULL, 0, mSwTable, NULL, NO_OPT, NULL) == SHELL_SUCCESS);
+    CHECK(mVerbose && (StrCmp(mName, L"a b") == 0));
+    CmdLineFree(NULL);
+
+    // tokenize errors are reported under the program name
+    Widen(mLine, "fs0:\\tool.efi -name \"a b");
+    StubClearOutput();
+    CHECK(ParseCmdLineString(mLine, mArgv, MAX_ARGS, NULL, 0, mSwTable, NULL, NO_OPT, NULL) == SHELL_INVALID_PARAMETER);
+    CHECK(Output("tool.efi: Missing closing quote - 'a b'"));
+    Widen(mLine, "tool a b c d e f g h i");
+    StubClearOutput();
+    CHECK(ParseCmdLineString(mLine, mArgv, MAX_ARGS, NULL, 0, mSwTable, NULL, NO_OPT, NULL) == SHELL_BUFFER_TOO_SMALL);
+    CHECK(Output("tool: Too many arguments, only 8 allowed"));
+
+    CHECK(CmdLineCompile(NULL, 0, mSwTable, NULL, NO_OPT, &Parser) == SHELL_SUCCESS);
+    Widen(mLine, "tool -n ^\"q^\"");
+    StubClearOutput();
+    CHECK(CmdLineParseString(Parser, mLine, mArgv, MAX_ARGS, NULL) == SHELL_SUCCESS);
+    CHECK(StrCmp(mName, L"\"q\"") == 0);
+    Widen(mLine, "tool -x");
+    StubClearOutput();
+    CHECK(CmdLineParseString(Parser, mLine, mArgv, MAX_ARGS, NULL) == SHELL_INVALID_PARAMETER);
+    CHECK(Output("tool: Unrecognised switch - '-x'"));
+    CmdLineFree(Parser);
+    CmdLineFreeParser(Parser);
+}
+
+int main(void)
+{
+    TestSplit();
+    TestQuotes();
+    TestEscapes();
+    TestLimits();
+    TestParseString();
+
+    return TestSummary("TokenizeTest");
+}
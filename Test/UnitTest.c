@@ -0,0 +1,104 @@
+/***********************************************************************
+
+ UnitTest.c
+
+ Host tests of the size, time and frequency value parser
+
+***********************************************************************/
+
+#include "../CmdLine.c"
+#include "TestCommon.h"
+
+STATIC UINT64 mValue;
+
+// checks status and, when VAL_OK, the value
+#define CHECK_UNIT(Str, Type, Size, Status, Expected) \
+    do { \
+        mValue = 0xDEADBEEF; \
+        CHECK(ParseUnitValue(Str, FALSE, Type, Size, &mValue) == (Status)); \
+        if ((Status) == VAL_OK) { \
+            CHECK(mValue == (UINT64)(Expected)); \
+        } \
+    } while (0)
+
+STATIC VOID TestSize(VOID)
+{
+    CHECK_UNIT(L"512", VALTYPE_SIZE, SIZE64, VAL_OK, 512);
+    CHECK_UNIT(L"512B", VALTYPE_SIZE, SIZE64, VAL_OK, 512);
+    CHECK_UNIT(L"4K", VALTYPE_SIZE, SIZE64, VAL_OK, 4096);
+    CHECK_UNIT(L"4k", VALTYPE_SIZE, SIZE64, VAL_OK, 4096);
+    CHECK_UNIT(L"4KB", VALTYPE_SIZE, SIZE64, VAL_OK, 4096);
+    CHECK_UNIT(L"4kib", VALTYPE_SIZE, SIZE64, VAL_OK, 4096);
+    CHECK_UNIT(L"1.5G", VALTYPE_SIZE, SIZE64, VAL_OK, 3ULL << 29);
+    CHECK_UNIT(L"0.5K", VALTYPE_SIZE, SIZE64, VAL_OK, 512);
+    CHECK_UNIT(L".5K", VALTYPE_SIZE, SIZE64, VAL_OK, 512);
+    CHECK_UNIT(L"1.000000000000000000000K", VALTYPE_SIZE, SIZE64, VAL_OK, 1024);
+    CHECK_UNIT(L"2E", VALTYPE_SIZE, SIZE64, VAL_OK, 2ULL << 60);
+    CHECK_UNIT(L"4KiBs", VALTYPE_SIZE, SIZE64, VAL_SIZE_INVALID, 0);
+    CHECK_UNIT(L"4 K", VALTYPE_SIZE, SIZE64, VAL_SIZE_INVALID, 0);
+    CHECK_UNIT(L"K", VALTYPE_SIZE, SIZE64, VAL_SIZE_INVALID, 0);
+    CHECK_UNIT(L".K", VALTYPE_SIZE, SIZE64, VAL_SIZE_INVALID, 0);
+    CHECK_UNIT(L"", VALTYPE_SIZE, SIZE64, VAL_SIZE_INVALID, 0);
+    CHECK_UNIT(L"4ms", VALTYPE_SIZE, SIZE64, VAL_SIZE_INVALID, 0);
+
+    // a whole number of bytes is required
+    CHECK_UNIT(L"1.5", VALTYPE_SIZE, SIZE64, VAL_UNIT_INEXACT, 0);
+    CHECK_UNIT(L"0.001K", VALTYPE_SIZE, SIZE64, VAL_UNIT_INEXACT, 0);
+    CHECK_UNIT(L"1.0000000000000000001K", VALTYPE_SIZE, SIZE64, VAL_UNIT_INEXACT, 0);
+
+    // range of each size
+    CHECK_UNIT(L"15E", VALTYPE_SIZE, SIZE64, VAL_OK, 15ULL << 60);
+    CHECK_UNIT(L"16E", VALTYPE_SIZE, SIZE64, VAL_UINT64_TOO_BIG, 0);
+    CHECK_UNIT(L"15.9375E", VALTYPE_SIZE, SIZE64, VAL_OK, 0xFF00000000000000ULL);
+    CHECK_UNIT(L"15.999999999999999999E", VALTYPE_SIZE, SIZE64, VAL_UNIT_INEXACT, 0);
+    CHECK_UNIT(L"18446744073709551615", VALTYPE_SIZE, SIZE64, VAL_OK, MAX_UINT64);
+    CHECK_UNIT(L"18446744073709551616", VALTYPE_SIZE, SIZE64, VAL_UINT64_TOO_BIG, 0);
+    CHECK_UNIT(L"3G", VALTYPE_SIZE, SIZE32, VAL_OK, 3ULL << 30);
+    CHECK_UNIT(L"4G", VALTYPE_SIZE, SIZE32, VAL_UINT32_TOO_BIG, 0);
+    CHECK_UNIT(L"3.999999999G", VALTYPE_SIZE, SIZE32, VAL_UNIT_INEXACT, 0);
+}
+
+STATIC VOID TestHexSize(VOID)
+{
+    // hex is detected before suffixes, and takes none
+    CHECK_UNIT(L"0x1B", VALTYPE_SIZE, SIZE64, VAL_OK, 0x1B);
+    CHECK_UNIT(L"0X1b", VALTYPE_SIZE, SIZE64, VAL_OK, 0x1B);
+    CHECK_UNIT(L"0xE", VALTYPE_SIZE, SIZE64, VAL_OK, 0xE);
+    CHECK_UNIT(L"0x1K", VALTYPE_SIZE, SIZE64, VAL_SIZE_INVALID, 0);
+    CHECK_UNIT(L"0x1.5", VALTYPE_SIZE, SIZE64, VAL_SIZE_INVALID, 0);
+    CHECK_UNIT(L"0x", VALTYPE_SIZE, SIZE64, VAL_SIZE_INVALID, 0);
+    CHECK_UNIT(L"0xFFFFFFFFFFFFFFFF", VALTYPE_SIZE, SIZE64, VAL_OK, MAX_UINT64);
+    CHECK_UNIT(L"0x10000000000000000", VALTYPE_SIZE, SIZE64, VAL_UINT64_TOO_BIG, 0);
+    CHECK_UNIT(L"0x100000000", VALTYPE_SIZE, SIZE32, VAL_UINT32_TOO_BIG, 0);
+    CHECK_UNIT(L"0x10", VALTYPE_TIME, SIZE64, VAL_OK, 16);
+    CHECK_UNIT(L"0x10us", VALTYPE_TIME, SIZE64, VAL_TIME_INVALID, 0);
+}
+
+STATIC VOID TestTimeFreq(VOID)
+{
+    CHECK_UNIT(L"250us", VALTYPE_TIME, SIZE64, VAL_OK, 250000);
+    CHECK_UNIT(L"1.5ms", VALTYPE_TIME, SIZE64, VAL_OK, 1500000);
+    CHECK_UNIT(L"2S", VALTYPE_TIME, SIZE64, VAL_OK, 2000000000);
+    CHECK_UNIT(L"10ns", VALTYPE_TIME, SIZE64, VAL_OK, 10);
+    CHECK_UNIT(L"0.1ns", VALTYPE_TIME, SIZE64, VAL_UNIT_INEXACT, 0);
+    CHECK_UNIT(L"4.294967295s", VALTYPE_TIME, SIZE32, VAL_OK, MAX_UINT32);
+    CHECK_UNIT(L"4.294967296s", VALTYPE_TIME, SIZE32, VAL_UINT32_TOO_BIG, 0);
+    CHECK_UNIT(L"1m", VALTYPE_TIME, SIZE64, VAL_TIME_INVALID, 0);
+
+    CHECK_UNIT(L"2.4GHz", VALTYPE_FREQ, SIZE64, VAL_OK, 2400000000ULL);
+    CHECK_UNIT(L"2.4g", VALTYPE_FREQ, SIZE64, VAL_OK, 2400000000ULL);
+    CHECK_UNIT(L"100kHz", VALTYPE_FREQ, SIZE64, VAL_OK, 100000);
+    CHECK_UNIT(L"33.333333MHz", VALTYPE_FREQ, SIZE64, VAL_OK, 33333333);
+    CHECK_UNIT(L"33.3333333MHz", VALTYPE_FREQ, SIZE64, VAL_UNIT_INEXACT, 0);
+    CHECK_UNIT(L"33.333333333333333333333333333", VALTYPE_FREQ, SIZE64, VAL_UNIT_INEXACT, 0);
+    CHECK_UNIT(L"1KB", VALTYPE_FREQ, SIZE64, VAL_FREQ_INVALID, 0);
+}
+
+int main(void)
+{
+    TestSize();
+    TestHexSize();
+    TestTimeFreq();
+    CHECK_UNIT(L"1", VALTYPE_DECIMAL, SIZE64, VAL_UNSUPPORTED_TYPE, 0);
+    return TestSummary("UnitTest");
+}
@@ -0,0 +1,232 @@
+/***********************************************************************
+
+ Utf8Test.c
+
+ Host tests of UTF-8 decoding and of parsing CHAR8 argument vectors
+
+***********************************************************************/
+
+#include "../CmdLine.c"
+#include "TestCommon.h"
+#include <stdlib.h>
+
+ENUMSTR_START(mModes)
+ENUMSTR_ENTRY(1, L"fast")
+ENUMSTR_ENTRY(2, L"slow")
+ENUMSTR_ENTRY(3, L"caf\x00E9")
+ENUMSTR_END
+
+STATIC UINTN                mCount;
+STATIC INTN                 mOffset;
+STATIC UINT64               mSize;
+STATIC UINTN                mMode;
+STATIC CMDLINE_RANGE_LIST   mRanges;
+STATIC CHAR16               mName[8];
+STATIC CHAR8                mLabel[8];
+STATIC CMDLINE_STRREF       mRef;
+STATIC CMDLINE_LIST         mFiles;
+STATIC BOOLEAN              mVerbose;
+STATIC UINTN                mParam;
+
+PARAMTABLE_START(mParamTable)
+PARAMTABLE_INT(&mParam, L"value")
+PARAMTABLE_END
+
+SWTABLE_START(mSwTable)
+SWTABLE_OPT_FLAG(L"-v", L"-verbose", &mVerbose, L"verbose")
+SWTABLE_OPT_DEC(L"-c", L"-count", &mCount, L"[n]count")
+SWTABLE_OPT_SINT(L"-o", L"-offset", &mOffset, L"[n]offset")
+SWTABLE_OPT_SIZE64(L"-s", L"-size", &mSize, L"[n]size")
+SWTABLE_OPT_ENUM(L"-m", L"-mode", &mMode, mModes, L"[mode]mode")
+SWTABLE_OPT_RANGES(L"-r", L"-ranges", &mRanges, L"[list]ranges")
+SWTABLE_OPT_STR(L"-n", L"-name", mName, sizeof(mName) / sizeof(CHAR16), L"[str]name")
+SWTABLE_OPT_STR8(L"-l", L"-label", mLabel, sizeof(mLabel), L"[str]label")
+SWTABLE_OPT_STRREF(L"-ref", NULL, &mRef, L"[str]reference")
+SWTABLE_OPT_STR_LIST(L"-f", L"-file", &mFiles, L"[file]files")
+SWTABLE_OPT_FLAG(NULL, L"-\x00FC" L"ber", &mVerbose, L"non-ASCII switch")
+SWTABLE_END
+
+// splits a space separated line into a CHAR8 argument vector of exactly sized heap copies,
+// so reads past a terminator are caught
+STATIC UINTN SplitArgs(CONST CHAR8 *Line, CHAR8 **Argv)
+{
+    CHAR8 Tmp[512];
+    UINTN Argc = 0;
+
+    snprintf(Tmp, sizeof(Tmp), "%s", Line);
+    for (CHAR8 *Tok = strtok(Tmp, " "); Tok != NULL; Tok = strtok(NULL, " ")) {
+        Argv[Argc++] = strdup(Tok);
+    }
+    StubClearOutput();
+    return Argc;
+}
+
+STATIC VOID FreeArgs(UINTN Argc, CHAR8 **Argv)
+{
+    for (UINTN i = 0; i < Argc; i++) {
+        free(Argv[i]);
+    }
+}
+
+STATIC BOOLEAN WideEqual(CONST CHAR16 *Str, CONST CHAR16 *Expected)
+{
+    return (Str != NULL) && (StrCmp(Str, Expected) == 0);
+}
+
+STATIC VOID TestDecode(CONST CHAR8 *Str, CHAR16 Expected, UINTN Bytes)
+{
+    CONST CHAR8 *Ptr = Str;
+    CHECK(DecodeUtf8Char(&Ptr) == Expected);
+    CHECK((UINTN)(Ptr - Str) == Bytes);
+}
+
+STATIC VOID TestDecodeUtf8Char(VOID)
+{
+    TestDecode("a", L'a', 1);
+    TestDecode("\x7F", 0x7F, 1);
+    TestDecode("\xC3\xA9", 0x00E9, 2);
+    TestDecode("\xDF\xBF", 0x07FF, 2);
+    TestDecode("\xE2\x98\x83", 0x2603, 3);
+    TestDecode("\xEF\xBF\xBD", 0xFFFD, 3);
+
+    // overlong forms and surrogates are invalid
+    TestDecode("\xC0\xAF", 0xFFFD, 2);
+    TestDecode("\xE0\x80\xAF", 0xFFFD, 3);
+    TestDecode("\xED\xA0\x80", 0xFFFD, 3);
+
+    // chars outside UCS-2 are replaced, but consumed whole
+    TestDecode("\xF0\x9F\x98\x80", 0xFFFD, 4);
+
+    // a stray continuation byte or a truncated sequence stops at the next lead byte or terminator
+    TestDecode("\x80" "a", 0xFFFD, 1);
+    TestDecode("\xC3" "a", 0xFFFD, 1);
+    TestDecode("\xE2\x98", 0xFFFD, 2);
+    TestDecode("\xFF", 0xFFFD, 1);
+}
+
+STATIC VOID TestNarrowScan(VOID)
+{
+    UINTN Len1, Len2;
+    UINT64 Wide, Narrow;
+
+    // a narrow string hashes as its decoded CHAR16 form
+    CHECK(HashFoldStr("-Verbose", TRUE, L'\0', &Len1) == HashFoldStr(L"-VERBOSE", FALSE, L'\0', &Len2));
+    CHECK(Len1 == Len2);
+    CHECK(HashFoldStr("ABC,def", TRUE, L',', &Len1) == HashFoldStr(L"abc", FALSE, L'\0', &Len2));
+    CHECK(Len1 == 3);
+    CHECK(HashFoldStr("-\xC3\xBC" "ber", TRUE, L'\0', &Len1) == HashFoldStr(L"-\x00FC" L"ber", FALSE, L'\0', &Len2));
+    CHECK(Len1 == Len2);
+
+    // integers and units convert the same from either width
+    CHECK(ParseInteger("0x1F", TRUE, VALTYPE_INTEGER, SIZE64, &Narrow) == VAL_OK);
+    CHECK(ParseInteger(L"0x1F", FALSE, VALTYPE_INTEGER, SIZE64, &Wide) == VAL_OK);
+    CHECK(Narrow == Wide);
+    CHECK(ParseInteger("-42", TRUE, VALTYPE_SIGNED, SIZE32, &Narrow) == VAL_OK);
+    CHECK((INT64)Narrow == -42);
+    CHECK(ParseInteger("12\xC3\xA9", TRUE, VALTYPE_DECIMAL, SIZE64, &Narrow) == VAL_DEC_INVALID);
+    CHECK(ParseUnitValue("1.5KiB", TRUE, VALTYPE_SIZE, SIZE64, &Narrow) == VAL_OK);
+    CHECK(ParseUnitValue(L"1.5KiB", FALSE, VALTYPE_SIZE, SIZE64, &Wide) == VAL_OK);
+    CHECK(Narrow == Wide);
+    CHECK(IsNegativeNumber("-5", TRUE) && !IsNegativeNumber("-x", TRUE));
+}
+
+STATIC SHELL_STATUS Parse(CMDLINE_PARSER *Parser, CONST CHAR8 *Line)
+{
+    CHAR8 *Argv[32];
+    UINTN Argc = SplitArgs(Line, Argv);
+
+    mVerbose = FALSE;
+    mCount = 0;
+    mOffset = 0;
+    mSize = 0;
+    mMode = 0;
+    ZeroMem(mName, sizeof(mName));
+    ZeroMem(mLabel, sizeof(mLabel));
+    ZeroMem(&mRef, sizeof(mRef));
+    SHELL_STATUS ShellStatus = CmdLineParseArgvAscii(Parser, Argc, Argv, NULL);
+    // nothing returned may point into the vector once it is gone
+    FreeArgs(Argc, Argv);
+    return ShellStatus;
+}
+
+STATIC VOID TestParse(VOID)
+{
+    CMDLINE_PARSER *Parser;
+
+    CHECK(CmdLineCompile(mParamTable, 0, mSwTable, NULL, PASS_THROUGH, &Parser) == SHELL_SUCCESS);
+
+    CHECK(Parse(Parser, "\\bin\\prog.efi -VERBOSE -c 12 -o -3 -s 2M -mode SLOW -r 1-3,7 9") == SHELL_SUCCESS);
+    CHECK(mVerbose && (mCount == 12) && (mOffset == -3) && (mSize == 2 * 1024 * 1024) && (mMode == 2) && (mParam == 9));
+    CHECK((mRanges.Count == 2) && (mRanges.Ranges[1].First == 7));
+
+    // non-ASCII switches and enum names are matched on the decoded chars
+    CHECK(Parse(Parser, "prog -\xC3\xBC" "BER -m CAF\xC3\xA9") == SHELL_SUCCESS);
+    CHECK(mVerbose && (mMode == 3));
+
+    // strings are decoded into their buffers, STR8 only takes ASCII
+    CHECK(Parse(Parser, "prog -n caf\xC3\xA9 -l abc") == SHELL_SUCCESS);
+    CHECK(WideEqual(mName, L"caf\x00E9") && (strcmp(mLabel, "abc") == 0));
+    CHECK(Parse(Parser, "prog -n \xE2\x98\x83\xE2\x98\x83\xE2\x98\x83\xE2\x98\x83\xE2\x98\x83\xE2\x98\x83\xE2\x98\x83\xE2\x98\x83") == SHELL_INVALID_PARAMETER);
+    CHECK(Parse(Parser, "prog -l caf\xC3\xA9") == SHELL_INVALID_PARAMETER);
+    CHECK(Output("'-l'"));
+
+    // borrowed values are widened, so outlive the argument vector
+    CHECK(Parse(Parser, "prog -ref na\xC3\xAFve -f a.txt -f b\xC3\xA9.txt") == SHELL_SUCCESS);
+    CHECK(WideEqual(mRef.Str, L"na\x00EFve") && (mRef.Len == 5));
+    CHECK(mFiles.Count == 2);
+    CHECK(WideEqual(mFiles.Items.Str[0], L"a.txt") && WideEqual(mFiles.Items.Str[1], L"b\x00E9.txt"));
+
+    // arguments after '--' are widened
+    CHAR16 **PassArgv;
+    UINTN PassArgc;
+    CHECK(Parse(Parser, "prog -v -- -x caf\xC3\xA9") == SHELL_SUCCESS);
+    CHECK(CmdLineGetPassThrough(Parser, &PassArgc, &PassArgv));
+    CHECK((PassArgc == 2) && WideEqual(PassArgv[0], L"-x") && WideEqual(PassArgv[1], L"caf\x00E9"));
+
+    // errors name the program and the argument
+    CHECK(Parse(Parser, "\\efi\\tool.efi -\xC3\xA9") == SHELL_INVALID_PARAMETER);
+    CHECK(Output("tool.efi: Unrecognised switch - '-"));
+    CHECK(Parse(Parser, "prog -c 1x") == SHELL_INVALID_PARAMETER);
+    CHECK(Output("prog: Switch '-c'") && Output("'1x'"));
+    CHECK(Parse(Parser, "prog 1 2") == SHELL_INVALID_PARAMETER);
+    CHECK(Output("Too many parameters"));
+    CHECK(Parse(Parser, "prog -c") == SHELL_INVALID_PARAMETER);
+    CHECK(Output("'-c' requires a value"));
+
+    CmdLineFree(Parser);
+    CmdLineFreeParser(Parser);
+}
+
+STATIC VOID TestLazy(VOID)
+{
+    CMDLINE_PARSER *Parser;
+    UINTN Value;
+    CONST CHAR16 *Str;
+
+    CHECK(CmdLineCompile(mParamTable, 0, mSwTable, NULL, LAZY_VALUES, &Parser) == SHELL_SUCCESS);
+
+    // lazy values are widened, so are read after the argument vector has gone
+    CHECK(Parse(Parser, "prog -c 7 -n caf\xC3\xA9 -m fast") == SHELL_SUCCESS);
+    CHECK((CmdLineGetUintn(Parser, L"-count", &Value) == SHELL_SUCCESS) && (Value == 7));
+    CHECK((CmdLineGetEnum(Parser, L"-m", &Value) == SHELL_SUCCESS) && (Value == 1));
+    CHECK((CmdLineGetStr(Parser, L"-n", &Str) == SHELL_SUCCESS) && WideEqual(Str, L"caf\x00E9"));
+
+    // and errors found then still name the program
+    CHECK(Parse(Parser, "\\efi\\lazy.efi -c nope") == SHELL_SUCCESS);
+    StubClearOutput();
+    CHECK(CmdLineGetUintn(Parser, L"-c", &Value) == SHELL_INVALID_PARAMETER);
+    CHECK(Output("lazy.efi: Switch '-c'") && Output("'nope'"));
+
+    CmdLineFree(Parser);
+    CmdLineFreeParser(Parser);
+}
+
+int main(void)
+{
+    TestDecodeUtf8Char();
+    TestNarrowScan();
+    TestParse();
+    TestLazy();
+
+    return TestSummary("Utf8Test");
+}
@@ -0,0 +1,89 @@
+/***********************************************************************
+
+ ValidateTest.c
+
+ Host tests of table validation
+
+***********************************************************************/
+
+#include "../CmdLine.c"
+#include "TestCommon.h"
+
+STATIC UINTN    mFirst;
+STATIC UINTN    mCount;
+STATIC BOOLEAN  mVerbose;
+STATIC CHAR16   mName[8];
+
+PARAMTABLE_START(mParams)
+PARAMTABLE_DEC(&mFirst, L"first")
+PARAMTABLE_END
+
+SWTABLE_START(mDuplicate)
+SWTABLE_OPT_FLAG(L"-v", L"-verbose", &mVerbose, L"verbose")
+SWTABLE_OPT_DEC(L"-V", NULL, &mCount, L"count")
+SWTABLE_END
+
+SWTABLE_START(mBuiltIn)
+SWTABLE_OPT_FLAG(L"-h", NULL, &mVerbose, L"clashes with help")
+SWTABLE_END
+
+SWTABLE_START(mBadEntries)
+SWTABLE_OPT_FLAG(L"v", NULL, &mVerbose, L"no leading dash")
+SWTABLE_OPT_DEC(L"-c", NULL, NULL, L"no return ptr")
+SWTABLE_END
+
+int main(void)
+{
+    CMDLINE_PARSER *Parser;
+    UINTN          NameSize = sizeof(mName) / sizeof(CHAR16);
+
+    CHECK(CmdLineValidateTables(mParams, 1, NULL, NO_OPT) == SHELL_SUCCESS);
+    CHECK(CmdLineValidateTables(NULL, 0, mDuplicate, NO_OPT) == SHELL_INVALID_PARAMETER);
+    CHECK(Output("Duplicate name"));
+    StubClearOutput();
+    CHECK(CmdLineValidateTables(NULL, 0, mBuiltIn, NO_OPT) == SHELL_INVALID_PARAMETER);
+    CHECK(CmdLineValidateTables(NULL, 0, mBuiltIn, NO_HELP) == SHELL_SUCCESS);
+    CHECK(CmdLineValidateTables(NULL, 0, mBadEntries, NO_OPT) == SHELL_INVALID_PARAMETER);
+    CHECK(Output("Invalid name") && Output("Null 'RetValPtr'"));
+
+    // tables that pass are marked and not checked again, those that fail are not marked
+    CHECK(mParams[1].Data.FlagValue == TABLE_VALIDATED);
+    CHECK(mDuplicate[2].Data.FlagValue == 0);
+    CHECK(mBuiltIn[1].Data.FlagValue == TABLE_VALIDATED_NO_HELP);
+    StubClearOutput();
+    CHECK(CmdLineValidateTables(NULL, 0, mBuiltIn, NO_HELP) == SHELL_SUCCESS);
+    CHECK(CmdLineValidateTables(mParams, 1, NULL, NO_OPT) == SHELL_SUCCESS);
+    CHECK(gStubOutputLen == 0);
+    // checked with NO_HELP, so checked again against the help switches
+    CHECK(CmdLineValidateTables(NULL, 0, mBuiltIn, NO_OPT) == SHELL_INVALID_PARAMETER);
+    CHECK(Output("Duplicate name"));
+
+    // a failed compile returns no parser, and the same tables fail every time
+    CHECK(CmdLineCompile(NULL, 0, mDuplicate, NULL, NO_OPT, &Parser) == SHELL_INVALID_PARAMETER);
+    CHECK(Parser == NULL);
+    CHECK(CmdLineCompile(NULL, 0, mDuplicate, NULL, NO_OPT, &Parser) == SHELL_INVALID_PARAMETER);
+
+    // too many mandatory parameters is reported and taken as all of them
+    SetArgs("p 7");
+    CHECK(ParseCmdLine(mParams, 5, NULL, NULL, NO_OPT, NULL) == SHELL_SUCCESS);
+    CHECK(Output("'ManParamCount' too large"));
+    CHECK(mFirst == 7);
+    SetArgs("p");
+    CHECK(ParseCmdLine(mParams, 5, NULL, NULL, NO_OPT, NULL) == SHELL_INVALID_PARAMETER);
+    CHECK(Output("at least 1 required"));
+
+    // tables built at run time, the size checks only apply to constants
+    SWTABLE_START(Local)
+    SWTABLE_OPT_STR(L"-n", NULL, mName, NameSize, L"name")
+    SWTABLE_END
+    SetArgs("p -n abc");
+    CHECK(ParseCmdLine(NULL, 0, Local, NULL, NO_OPT, NULL) == SHELL_SUCCESS);
+    CHECK(StrCmp(mName, L"abc") == 0);
+    NameSize = 0;
+    SWTABLE_START(Empty)
+    SWTABLE_OPT_STR(L"-n", NULL, mName, NameSize, L"name")
+    SWTABLE_END
+    CHECK(CmdLineValidateTables(NULL, 0, Empty, NO_OPT) == SHELL_INVALID_PARAMETER);
+
+    return TestSummary("ValidateTest");
+}